@@ -45,6 +45,7 @@
 #define PROS_VERSION_STRING "3.8.3"
 
 #include "pros/adi.h"
+#include "pros/assets.h"
 #include "pros/colors.h"
 #include "pros/distance.h"
 #include "pros/error.h"
@@ -56,6 +57,7 @@
 #include "pros/misc.h"
 #include "pros/motors.h"
 #include "pros/optical.h"
+#include "pros/pose.h"
 #include "pros/rotation.h"
 #include "pros/rtos.h"
 #include "pros/screen.h"
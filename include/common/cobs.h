@@ -15,8 +15,15 @@
 
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 
+#ifdef __cplusplus
+// C++ has no restrict keyword, but GCC accepts the same qualifier as __restrict
+#define restrict __restrict
+extern "C" {
+#endif
+
 #define COBS_ENCODE_MEASURE_MAX(src_len) ((src_len) + (((src_len) + 253) / 254))
 
 /**
@@ -52,3 +59,27 @@ int cobs_encode(uint8_t* restrict dest, const uint8_t* restrict src, const size_
  * \return The size of src when encoded
  */
 size_t cobs_encode_measure(const uint8_t* restrict src, const size_t src_len, const uint32_t prefix);
+
+/**
+ * Decodes one Consistent Overhead Byte Stuffing frame, not including its zero
+ * delimiter. Unlike cobs_encode(), no stream identifier is expected.
+ *
+ * The decoded data is never longer than src_len - 1 bytes and is written no
+ * further ahead than it is read, so dest may be the same as src to decode in
+ * place.
+ *
+ * \param[out] dest
+ *             The location to write the decoded data to
+ * \param[in] src
+ *            The stuffed frame
+ * \param src_len
+ *        The length of the stuffed frame
+ *
+ * \return The number of bytes written, or -1 if src is not a valid frame
+ */
+int cobs_decode(uint8_t* dest, const uint8_t* src, const size_t src_len);
+
+#ifdef __cplusplus
+}
+#undef restrict
+#endif
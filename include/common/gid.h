@@ -15,12 +15,13 @@
 
 #pragma once
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
-#include "api.h"
 
 struct gid_metadata {
 	uint32_t* const bitmap;    // a constant pointer to a bitmap
-	const size_t max;          // Maximum gid value
+	const size_t max;          // Number of gids, so gids are less than max
 	const size_t reserved;     // first n GIDs may be reserved, at most 32, but at least 1
 	const size_t bitmap_size;  // Cached number of uint32_t's used to map gid_max.
 	                           // Use gid_size_to_words to compute
@@ -28,7 +29,6 @@ struct gid_metadata {
 	// internal usage to ensure that GIDs get delegated linearly before wrapping
 	// around back to 0
 	size_t _cur_val;
-	mutex_t _lock;
 };
 
 #ifndef UINT32_WIDTH
@@ -50,7 +50,8 @@ struct gid_metadata {
 void gid_init(struct gid_metadata* const metadata);
 
 /**
- * Allocates a gid from the gid structure and returns it.
+ * Allocates a gid from the gid structure and returns it. Safe to call from
+ * several tasks at once without a lock.
  *
  * \param[in] metadata
  *            The gid_metadata to record to the gid structure
@@ -0,0 +1,65 @@
+/**
+ * \file common/matrix.h
+ *
+ * Fixed-size 3x3 matrix operations
+ *
+ * See common/matrix.c for discussion
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+/**
+ * A 3x3 matrix stored row-major, m[row][col]
+ */
+typedef struct mat3 {
+	double m[3][3];
+} mat3_s_t;
+
+/**
+ * Sets a matrix to the identity matrix
+ *
+ * \param out
+ *        The matrix to set
+ */
+void mat3_identity(mat3_s_t* out);
+
+/**
+ * Computes out = a + b. out may alias a or b.
+ */
+void mat3_add(mat3_s_t* out, const mat3_s_t* a, const mat3_s_t* b);
+
+/**
+ * Computes out = a - b. out may alias a or b.
+ */
+void mat3_sub(mat3_s_t* out, const mat3_s_t* a, const mat3_s_t* b);
+
+/**
+ * Computes out = a * b. out may alias a or b.
+ */
+void mat3_mul(mat3_s_t* out, const mat3_s_t* a, const mat3_s_t* b);
+
+/**
+ * Computes out = a * transpose(b). out may alias a or b.
+ */
+void mat3_mul_transpose(mat3_s_t* out, const mat3_s_t* a, const mat3_s_t* b);
+
+/**
+ * Computes out = a * v for a column vector v. out may alias v.
+ */
+void mat3_mul_vec(double out[3], const mat3_s_t* a, const double v[3]);
+
+/**
+ * Computes out = inverse(a). out may alias a.
+ *
+ * \return False if a is singular, in which case out is unchanged
+ */
+bool mat3_inverse(mat3_s_t* out, const mat3_s_t* a);
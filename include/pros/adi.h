@@ -122,6 +122,20 @@ typedef enum adi_potentiometer_type_e {
 #define INTERNAL_ADI_PORT 22
 #define NUM_ADI_PORTS 8
 
+/**
+ * The configuration and value of every port on one ADI, read at once by
+ * adi_read_all(), ext_adi_read_all() or adi_read_all_brain().
+ */
+typedef struct adi_snapshot_s {
+	/// The smart port the ADI is in, INTERNAL_ADI_PORT for the brain's own ports
+	uint8_t smart_port;
+	/// The configuration of each ADI port
+	adi_port_config_e_t configs[NUM_ADI_PORTS];
+	/// The value of each ADI port as ext_adi_port_get_value() would return it,
+	/// except that encoders configured as reversed are negated
+	int32_t values[NUM_ADI_PORTS];
+} adi_snapshot_s_t;
+
 #ifdef __cplusplus
 namespace c {
 #endif
@@ -200,6 +214,46 @@ int32_t adi_port_set_config(uint8_t port, adi_port_config_e_t type);
  */
 int32_t adi_port_set_value(uint8_t port, int32_t value);
 
+/**
+ * Reads the configuration and value of all 8 of the brain's ADI ports at once.
+ *
+ * This takes the ADI's mutex once instead of once per port, so it is much
+ * cheaper than reading each port separately.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - snapshot is NULL.
+ * EACCES - Another resource is currently trying to access the ADI.
+ *
+ * \param[out] snapshot
+ *        Where to store the configurations and values
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t adi_read_all(adi_snapshot_s_t* snapshot);
+
+/**
+ * Reads the configuration and value of every port on the brain's ADI and on
+ * every connected 3-Wire Expander.
+ *
+ * Each ADI's mutex is taken once. ADIs are read in smart port order with the
+ * brain's own ADI last, and ADIs that are busy are skipped.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - snapshots is NULL.
+ *
+ * \param[out] snapshots
+ *        Where to store one snapshot per ADI
+ * \param max
+ *        The number of snapshots that fit in snapshots
+ *
+ * \return The number of snapshots stored or PROS_ERR if the operation failed,
+ * setting errno.
+ */
+int32_t adi_read_all_brain(adi_snapshot_s_t* snapshots, uint32_t max);
+
 /******************************************************************************/
 /**                      PROS 2 Compatibility Functions                      **/
 /**                                                                          **/
@@ -24,6 +24,7 @@
 #include <vector>
 
 #include "pros/adi.h"
+#include "pros/ext_adi.h"
 
 namespace pros {
 
@@ -885,6 +886,61 @@ class ADILed : protected ADIPort {
 	*/
 	std::int32_t length();
 
+	/**
+	* @brief Drive the led strip from the LED engine
+	*
+	* Once started, commit() and set_effect() update the strip from the
+	* engine's own task instead of sending the whole buffer right away. See
+	* pros::c::ext_adi_led_engine_start() for details.
+	*
+	* This function uses the following values of errno when an error state is
+	* reached:
+	* EINVAL - The strip is empty
+	* EADDRINUSE - The port is not configured for ADI output
+	* ENOMEM - The engine is already driving its maximum number of strips
+	*
+	* @return PROS_SUCCESS if successful, PROS_ERR if not
+	*/
+	std::int32_t start_engine();
+
+	/**
+	* @brief Stop driving the led strip from the LED engine
+	*
+	* This function uses the following values of errno when an error state is
+	* reached:
+	* ENOENT - The engine is not driving this strip
+	*
+	* @return PROS_SUCCESS if successful, PROS_ERR if not
+	*/
+	std::int32_t stop_engine();
+
+	/**
+	* @brief Show the buffer on the led strip on the LED engine's next frame
+	*
+	* Only the LEDs that changed since the last frame are sent. This stops any
+	* effect on the strip.
+	*
+	* This function uses the following values of errno when an error state is
+	* reached:
+	* ENOENT - The engine is not driving this strip
+	*
+	* @return PROS_SUCCESS if successful, PROS_ERR if not
+	*/
+	std::int32_t commit();
+
+	/**
+	* @brief Set the effect the LED engine draws on the led strip
+	*
+	* This function uses the following values of errno when an error state is
+	* reached:
+	* ENOENT - The engine is not driving this strip
+	* EINVAL - The effect type is not valid
+	*
+	* @param effect the effect to draw
+	* @return PROS_SUCCESS if successful, PROS_ERR if not
+	*/
+	std::int32_t set_effect(const pros::c::ext_adi_led_effect_s_t& effect);
+
 	protected:
 	std::vector<uint32_t> _buffer;
 };
@@ -449,6 +449,220 @@ v5_device_e_t registry_get_bound_type(uint8_t port);
  */
 v5_device_e_t registry_get_plugged_type(uint8_t port);
 
+/******************************************************************************/
+/**                              Display Capture                             **/
+/**                                                                          **/
+/**   These functions render LVGL into memory instead of onto the screen so  **/
+/**            that UI rendering can be checked and benchmarked              **/
+/******************************************************************************/
+
+/**
+ * Redirects LVGL rendering into a framebuffer instead of the screen.
+ *
+ * While capturing, every area LVGL redraws is copied into framebuffer, which
+ * holds 480x240 pixels in row-major order, and nothing is drawn on the screen.
+ * Drawing done with the screen_* functions is not captured.
+ *
+ * \param framebuffer
+ *        A 480x240 pixel buffer to render into, or NULL to render onto the
+ *        screen again
+ */
+void display_capture_set(uint32_t* framebuffer);
+
+/**
+ * Overrides the touch screen state seen by LVGL with a virtual touch.
+ *
+ * Touch callbacks registered with screen_touch_callback() are not affected.
+ *
+ * \param x, y
+ *        The position of the virtual touch
+ * \param pressed
+ *        Whether the virtual touch is pressed
+ */
+void display_touch_inject(int16_t x, int16_t y, bool pressed);
+
+/**
+ * Stops overriding the touch screen state seen by LVGL.
+ */
+void display_touch_inject_stop(void);
+
+/**
+ * Invalidates the whole screen and immediately redraws it with LVGL.
+ *
+ * Injected touches are read by LVGL on its next input poll, so delay for a few
+ * milliseconds after display_touch_inject() before rendering. This blocks the
+ * display daemon for the duration of the redraw.
+ *
+ * \return The time taken to redraw, in microseconds
+ */
+uint32_t display_render_now(void);
+
+/**
+ * Stops the display daemon from running LVGL until display_unlock() is called.
+ *
+ * LVGL is not thread-safe, so hold this lock while creating, changing, or
+ * deleting LVGL objects from another task. Do not call display_render_now()
+ * while holding it.
+ */
+void display_lock(void);
+
+/**
+ * Lets the display daemon run LVGL again after display_lock().
+ */
+void display_unlock(void);
+
+/******************************************************************************/
+/**                              Flight Recorder                             **/
+/**                                                                          **/
+/**  The kernel keeps the most recent events in a RAM ring. When a task has  **/
+/**  a data abort or overflows its stack, the ring is written to the         **/
+/**  microSD card as flight_recorder.txt and to the serial port              **/
+/******************************************************************************/
+
+/**
+ * Number of events the flight recorder keeps
+ */
+#define FLIGHT_RECORDER_EVENTS 512
+
+/**
+ * Kinds of flight recorder events
+ */
+typedef enum flight_event_type_e {
+	E_FLIGHT_EVENT_NONE = 0,     ///< Empty slot
+	E_FLIGHT_EVENT_TASK_SWITCH,  ///< value is the task switched in, code is its creation number
+	E_FLIGHT_EVENT_COMPETITION,  ///< value is the new competition status
+	E_FLIGHT_EVENT_PORT_ERROR,   ///< code is the port (1-21) that got a port error
+	E_FLIGHT_EVENT_MARKER        ///< code and value were passed to flight_recorder_mark()
+} flight_event_type_e_t;
+
+/**
+ * A flight recorder event
+ */
+typedef struct flight_event_s {
+	uint32_t time;   ///< Time of the event (microseconds, wraps every 71 minutes)
+	uint16_t type;   ///< A flight_event_type_e_t
+	uint16_t code;   ///< Meaning depends on the type
+	uint32_t value;  ///< Meaning depends on the type
+} flight_event_s_t;
+
+/**
+ * Records a marker in the flight recorder, such as the start of an autonomous
+ * routine or a state machine transition. Costs a few tens of cycles and never
+ * blocks, so it may be called from any task.
+ *
+ * \param code
+ *        A number identifying the marker
+ * \param value
+ *        Any value to record with it
+ */
+void flight_recorder_mark(uint16_t code, uint32_t value);
+
+/**
+ * Chooses which kinds of events are recorded. By default all are.
+ *
+ * Task switches happen the most often, so leaving them out keeps events from
+ * further back in the ring.
+ *
+ * \param mask
+ *        A bit mask with bit (1 << type) set for each flight_event_type_e_t to
+ *        record
+ */
+void flight_recorder_set_mask(uint32_t mask);
+
+/**
+ * Copies the most recent events, oldest first. An event being recorded during
+ * the copy may be partly written.
+ *
+ * \param events
+ *        Storage for the events
+ * \param count
+ *        The number of events that fit in events
+ *
+ * \return The number of events copied
+ */
+uint32_t flight_recorder_get(flight_event_s_t* events, uint32_t count);
+
+/******************************************************************************/
+/**                               Serial Shell                               **/
+/**                                                                          **/
+/**  Lines sent over the serial port as pR$<command> <args...> followed by   **/
+/**  a newline run a registered command, e.g. "pR$set kp 0.42". The kernel   **/
+/**  provides help, tasks, heap, ports, get, and set                         **/
+/******************************************************************************/
+
+/**
+ * Most commands and most tunables that can be registered
+ */
+#define SHELL_MAX_COMMANDS 32
+
+/**
+ * Longest command line, including the name and arguments. Longer lines are
+ * dropped.
+ */
+#define SHELL_LINE_MAX 128
+
+/**
+ * Most arguments a command line can have, including the command name
+ */
+#define SHELL_MAX_ARGS 8
+
+/**
+ * A shell command. argv[0] is the command name. Arguments are separated by
+ * spaces, and double quotes group words with spaces into one argument.
+ *
+ * Commands run one at a time on a low priority task, and can print their
+ * output with printf. The return value is 0 on success, and anything else is
+ * reported as an error.
+ */
+typedef int (*shell_command_fn_t)(int argc, char** argv);
+
+/**
+ * Adds a command to the serial shell.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - name or function is NULL, or name is empty, longer than 15
+ * characters, or contains a space.
+ * EEXIST - A command with that name already exists.
+ * ENOSPC - SHELL_MAX_COMMANDS commands are already registered.
+ *
+ * \param name
+ *        The name the command is run by
+ * \param help
+ *        A line describing the command, printed by help, or NULL. It must stay
+ *        valid while the program runs.
+ * \param function
+ *        The function to run
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t shell_register(const char* name, const char* help, shell_command_fn_t function);
+
+/**
+ * Exposes a variable, such as a PID gain, to the shell's get and set commands
+ * so it can be tuned over the cable without uploading a new program.
+ *
+ * set changes the value with the scheduler suspended, so other tasks never
+ * read a partly written value.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - name or value is NULL, or name is empty, longer than 15
+ * characters, or contains a space.
+ * EEXIST - A tunable with that name already exists.
+ * ENOSPC - SHELL_MAX_COMMANDS tunables are already registered.
+ *
+ * \param name
+ *        The name used with get and set
+ * \param value
+ *        The variable. It must stay valid while the program runs.
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t shell_tunable(const char* name, double* value);
+
 /******************************************************************************/
 /**                               Filesystem                                 **/
 /******************************************************************************/
@@ -475,6 +689,17 @@ int32_t serctl(const uint32_t action, void* const extra_arg);
 // Not yet implemented
 // int32_t usdctl(const uint32_t action, void* const extra_arg);
 
+/**
+ * Control settings of the RAM file driver.
+ *
+ * \param action
+ * 			An action to perform on the RAM file driver. See the RAMCTL_* macros
+ *      for details on the different actions.
+ * \param extra_arg
+ * 		   	An argument to pass in based on the action
+ */
+int32_t ramctl(const uint32_t action, void* const extra_arg);
+
 /**
  * Control settings of the way the file's driver treats the file
  *
@@ -490,6 +715,56 @@ int32_t serctl(const uint32_t action, void* const extra_arg);
  */
 int32_t fdctl(int file, const uint32_t action, void* const extra_arg);
 
+/**
+ * Events for poll(). These match the usual POSIX values.
+ */
+#ifndef POLLIN
+#define POLLIN 0x0001    ///< There are bytes to read
+#define POLLPRI 0x0002   ///< Unused
+#define POLLOUT 0x0004   ///< Writing will not block
+#define POLLERR 0x0008   ///< The file has an error, e.g. its port is not a generic serial port
+#define POLLHUP 0x0010   ///< Unused
+#define POLLNVAL 0x0020  ///< The file descriptor is not open
+
+/**
+ * A file descriptor to wait on with poll()
+ */
+struct pollfd {
+	int fd;         ///< The file descriptor, or a negative number to skip this entry
+	short events;   ///< The events to wait for
+	short revents;  ///< Set to the events that happened
+};
+
+typedef unsigned int nfds_t;
+#endif
+
+/**
+ * Waits until one of several files can be read or written without blocking,
+ * like the POSIX poll().
+ *
+ * Serial input (stdin), serial output, and Generic Serial Device (/dev) files
+ * wake the caller as soon as they become ready. microSD card and RAM files are
+ * always ready. Up to 8 tasks waiting in poll() or serial_wait() are woken this
+ * way at once, and any more check every millisecond instead.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - fds is NULL and nfds is not 0.
+ *
+ * \param fds
+ *        The files to wait on. Each entry's revents is set to the events that
+ *        are ready, plus POLLERR or POLLNVAL which are always reported.
+ * \param nfds
+ *        The number of entries in fds
+ * \param timeout
+ *        The longest time to wait in milliseconds, or a negative number to
+ *        wait forever
+ *
+ * \return The number of entries with events, 0 if the timeout elapsed, or -1
+ * if the operation failed, setting errno.
+ */
+int poll(struct pollfd* fds, nfds_t nfds, int timeout);
+
 /**
  * Action macro to pass into serctl or fdctl that activates the stream
  * identifier.
@@ -585,6 +860,360 @@ int32_t fdctl(int file, const uint32_t action, void* const extra_arg);
  */
 #define DEVCTL_SET_BAUDRATE 17
 
+/**
+ * Action macro to pass into fdctl on any Generic Serial Device file that waits
+ * until one of several Generic Serial Devices can be read or written without
+ * blocking, like select(). See serial_wait() for details.
+ *
+ * The extra argument is a pointer to a dev_select_s_t. On success, its port
+ * masks are replaced with the ports that are ready, and fdctl returns how many
+ * there are, or 0 if the timeout elapsed.
+ */
+#define DEVCTL_SELECT 26
+
+/**
+ * Ports to wait on with DEVCTL_SELECT. Bit n-1 of a mask stands for port n.
+ */
+typedef struct dev_select_s {
+	uint32_t read_ports;   ///< Ports to wait for bytes to read on
+	uint32_t write_ports;  ///< Ports to wait for space to write on
+	uint32_t timeout;      ///< Longest time to wait in milliseconds, or TIMEOUT_MAX
+} dev_select_s_t;
+
+/**
+ * Action macro to pass into fdctl that switches a microSD card file into
+ * write-behind logging mode.
+ *
+ * Writes to the file then only copy into a RAM ring of the given size, and a
+ * low priority task writes the ring to the card in sector aligned chunks. Data
+ * that does not fill a sector is written after at most a second, and the ring
+ * is written out completely when the competition state changes. A write that
+ * does not fit in the ring is dropped whole and counted in usd_log_stats_s_t
+ * rather than blocking the caller.
+ *
+ * The extra argument is the size of the ring in bytes, or 0 for 16 KB. It must
+ * be at least 512 bytes.
+ */
+#define USDCTL_WRITE_BEHIND 19
+
+/**
+ * Action macro to pass into fdctl that writes everything buffered for a
+ * microSD card file to the card, including a write-behind log's ring. fsync()
+ * does the same.
+ *
+ * The extra argument is not used with this action, provide any value (e.g.
+ * NULL) instead
+ */
+#define USDCTL_SYNC 20
+
+/**
+ * Action macro to pass into fdctl that gets the statistics of a microSD card
+ * file in write-behind logging mode.
+ *
+ * The extra argument is a pointer to a usd_log_stats_s_t to fill.
+ */
+#define USDCTL_GET_LOG_STATS 21
+
+/**
+ * Action macro to pass into ramctl that sets the most memory all RAM files may
+ * use together, in bytes. The default is 1 MB. Fails with EBUSY if the files
+ * already use more than the new limit.
+ *
+ * The extra argument is the limit in bytes.
+ */
+#define RAMCTL_SET_CAPACITY 22
+
+/**
+ * Action macro to pass into ramctl that gets the memory currently used by RAM
+ * files, in bytes.
+ *
+ * The extra argument is not used with this action, provide any value (e.g.
+ * NULL) instead
+ */
+#define RAMCTL_GET_USAGE 23
+
+/**
+ * Action macro to pass into fdctl that marks whether a RAM file is saved to the
+ * microSD card. Marked files are copied to the file of the same name under
+ * /usd when ramctl(RAMCTL_SAVE, NULL) is called and when the program exits.
+ * Saving on exit is skipped if a RAM file is being read or written at that
+ * moment, so call ramctl(RAMCTL_SAVE, NULL) where the data must be kept.
+ *
+ * The extra argument is non-NULL to mark the file and NULL to unmark it.
+ */
+#define RAMCTL_PERSIST 24
+
+/**
+ * Action macro to pass into fdctl that copies a RAM file to the file of the
+ * same name under /usd now, or into ramctl that does so for every file marked
+ * with RAMCTL_PERSIST.
+ *
+ * The extra argument is not used with this action, provide any value (e.g.
+ * NULL) instead
+ */
+#define RAMCTL_SAVE 25
+
+/**
+ * Statistics of a microSD card file in write-behind logging mode
+ */
+typedef struct usd_log_stats_s {
+	uint32_t bytes_written;   ///< Bytes written to the card
+	uint32_t buffered;        ///< Bytes waiting in the ring
+	uint32_t high_water;      ///< Most bytes the ring has held at once
+	uint32_t writes_dropped;  ///< Writes dropped because the ring was full
+	uint32_t bytes_dropped;   ///< Bytes in those writes
+	uint32_t flushes;         ///< Writes made to the card
+	uint32_t write_errors;    ///< Writes to the card that failed
+	uint32_t max_flush_us;    ///< Longest time spent writing to the card at once (microseconds)
+} usd_log_stats_s_t;
+
+/**
+ * Throughput and latency of one usd_benchmark() test
+ */
+typedef struct usd_bench_stats_s {
+	uint32_t bytes_per_sec;  ///< Throughput over the whole test
+	uint32_t p50_us;         ///< Median time of one operation (microseconds)
+	uint32_t p90_us;         ///< 90th percentile time of one operation (microseconds)
+	uint32_t p99_us;         ///< 99th percentile time of one operation (microseconds)
+	uint32_t max_us;         ///< Longest time of one operation (microseconds)
+} usd_bench_stats_s_t;
+
+/**
+ * Results of usd_benchmark() for one block size
+ */
+typedef struct usd_bench_result_s {
+	uint32_t block_size;              ///< Bytes per operation, set by the caller
+	usd_bench_stats_s_t write;        ///< Writing the file from start to end, including closing it
+	usd_bench_stats_s_t read;         ///< Reading the file from start to end
+	usd_bench_stats_s_t random_read;  ///< Reading blocks at random offsets, each with a seek
+} usd_bench_result_s_t;
+
+/**
+ * Measures how fast files can be written and read, and prints a report to
+ * serial output (stdout).
+ *
+ * For each block size, a test file is written sequentially, read
+ * sequentially, and read at random block offsets, timing every operation. The
+ * card only supports seeking in files opened for reading, so there is no
+ * random write test.
+ *
+ * Running the benchmark on /ram measures the overhead of the file system
+ * without a card, which is a useful baseline. Results depend on the card and
+ * on how full it is, so compare runs made on the same card.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - dir is NULL, file_size is 0, count is 0 with results given, or a
+ * block size is 0 or larger than file_size.
+ * ENOMEM - There is not enough memory for the buffers.
+ * EIO - A read or write was short.
+ * Any errno set by open(), read(), write(), or lseek() on the test file.
+ *
+ * \param dir
+ *        The directory to write the test file, bench.tmp, in. e.g. "/usd"
+ * \param file_size
+ *        The size of the test file in bytes
+ * \param[in,out] results
+ *        The block sizes to test, one per entry. The rest of each entry is
+ *        filled in. If NULL, block sizes of 512, 4096, and 32768 bytes are
+ *        tested and only the report is printed.
+ * \param count
+ *        The number of entries in results
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t usd_benchmark(const char* dir, uint32_t file_size, usd_bench_result_s_t* results, size_t count);
+
+/**
+ * Operations that can be performed by the I/O worker
+ */
+typedef enum aio_op_e { E_AIO_OPEN = 0, E_AIO_READ, E_AIO_WRITE, E_AIO_CLOSE } aio_op_e_t;
+
+/**
+ * States of an asynchronous I/O request
+ */
+typedef enum aio_state_e {
+	E_AIO_IDLE = 0,  ///< Never submitted
+	E_AIO_QUEUED,    ///< Waiting for the I/O worker, or for its file to be ready
+	E_AIO_RUNNING,   ///< Being performed by the I/O worker
+	E_AIO_DONE,      ///< Finished, result and error are valid
+	E_AIO_CANCELED   ///< Removed from the queue by aio_cancel() before it started
+} aio_state_e_t;
+
+/**
+ * An asynchronous I/O request.
+ *
+ * Zero initialize the request and optionally set task and notify_bits, then
+ * pass it to one of the aio_submit functions. The request and any buffer it
+ * refers to must stay valid until it is done or canceled. A finished request
+ * can be submitted again.
+ */
+typedef struct aio_request_s {
+	task_t task;           ///< Task to notify when the request is done, or NULL
+	uint32_t notify_bits;  ///< Bits to set in the task's notification value, or 0 to increment it
+	volatile aio_state_e_t state;
+	int32_t result;        ///< What the synchronous call returned, such as a byte count or file descriptor
+	int error;             ///< errno from the synchronous call if result is -1
+	// filled in by the aio_submit functions
+	aio_op_e_t op;
+	int file;
+	const char* path;
+	int flags;
+	void* buffer;
+	size_t length;
+	int32_t offset;
+	struct aio_request_s* next;
+} aio_request_s_t;
+
+/**
+ * Queues an open() to be performed by the I/O worker.
+ *
+ * When done, result is the new file descriptor or -1.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - request or path is NULL.
+ * EBUSY - The request is already queued or running.
+ *
+ * \param request
+ *        The request to fill in and queue
+ * \param path
+ *        The file to open, which must stay valid until the request is done
+ * \param flags
+ *        Flags as for open(), such as O_RDONLY
+ *
+ * \return 1 if the request was queued or PROS_ERR if the operation failed,
+ * setting errno.
+ */
+int32_t aio_submit_open(aio_request_s_t* request, const char* path, int flags);
+
+/**
+ * Queues a read() to be performed by the I/O worker.
+ *
+ * When done, result is the number of bytes read or -1.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - request or buffer is NULL.
+ * EBUSY - The request is already queued or running.
+ *
+ * \param request
+ *        The request to fill in and queue
+ * \param file
+ *        The file descriptor to read from
+ * \param buffer
+ *        Where to place the data read
+ * \param length
+ *        The maximum number of bytes to read
+ * \param offset
+ *        The position in the file to seek to first, or -1 to read from the
+ *        current position
+ *
+ * \return 1 if the request was queued or PROS_ERR if the operation failed,
+ * setting errno.
+ */
+int32_t aio_submit_read(aio_request_s_t* request, int file, void* buffer, size_t length, int32_t offset);
+
+/**
+ * Queues a write() to be performed by the I/O worker.
+ *
+ * When done, result is the number of bytes written or -1.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - request or buffer is NULL.
+ * EBUSY - The request is already queued or running.
+ *
+ * \param request
+ *        The request to fill in and queue
+ * \param file
+ *        The file descriptor to write to
+ * \param buffer
+ *        The data to write
+ * \param length
+ *        The number of bytes to write
+ * \param offset
+ *        The position in the file to seek to first, or -1 to write at the
+ *        current position
+ *
+ * \return 1 if the request was queued or PROS_ERR if the operation failed,
+ * setting errno.
+ */
+int32_t aio_submit_write(aio_request_s_t* request, int file, const void* buffer, size_t length, int32_t offset);
+
+/**
+ * Queues a close() to be performed by the I/O worker, such as after an
+ * asynchronous write so that the caller does not wait for the file to be
+ * flushed.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - request is NULL.
+ * EBUSY - The request is already queued or running.
+ *
+ * \param request
+ *        The request to fill in and queue
+ * \param file
+ *        The file descriptor to close
+ *
+ * \return 1 if the request was queued or PROS_ERR if the operation failed,
+ * setting errno.
+ */
+int32_t aio_submit_close(aio_request_s_t* request, int file);
+
+/**
+ * Checks whether a request is done without blocking.
+ *
+ * \param request
+ *        The request to check
+ *
+ * \return True if the request is done or was canceled
+ */
+bool aio_done(const aio_request_s_t* request);
+
+/**
+ * Waits for a request to be done.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - request is NULL or was never submitted.
+ * ETIMEDOUT - The request was not done before the timeout elapsed.
+ * ECANCELED - The request was canceled.
+ * Any errno set by the operation itself.
+ *
+ * \param request
+ *        The request to wait for
+ * \param timeout
+ *        The longest time to wait in milliseconds, or TIMEOUT_MAX to wait
+ *        forever
+ *
+ * \return The result of the request, or PROS_ERR if the operation failed,
+ * setting errno.
+ */
+int32_t aio_wait(aio_request_s_t* request, uint32_t timeout);
+
+/**
+ * Removes a request from the queue if the I/O worker has not started it.
+ *
+ * A read or write on a file that is not ready, such as a serial port with no
+ * bytes waiting, stays queued until the file is ready, so it can be canceled
+ * for as long as it waits. A started request can not be stopped, but a started
+ * read never waits for input.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - request is NULL.
+ * EBUSY - The request is already running or done.
+ *
+ * \param request
+ *        The request to cancel
+ *
+ * \return 1 if the request was canceled or PROS_ERR if the operation failed,
+ * setting errno.
+ */
+int32_t aio_cancel(aio_request_s_t* request);
+
 #ifdef __cplusplus
 }
 }
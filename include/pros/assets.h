@@ -0,0 +1,128 @@
+/**
+ * \file pros/assets.h
+ *
+ * Contains prototypes for read-only asset packs.
+ *
+ * An asset pack is a single file, usually on the microSD card, holding named
+ * binary assets such as motion profile paths and lookup tables. It is built
+ * ahead of time with tools/pack_assets.py, so nothing has to be parsed on the
+ * robot. Opening a pack reads only its index, and each asset is read into a
+ * caller-provided arena the first time it is requested. Names are found with a
+ * hash table stored in the pack, so looking up an asset does not depend on how
+ * many the pack holds.
+ *
+ * This file should not be modified by users, since it gets replaced whenever
+ * a kernel upgrade occurs.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef _PROS_ASSETS_H_
+#define _PROS_ASSETS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+namespace pros {
+namespace c {
+#endif
+
+/**
+ * An open asset pack. The members are managed by the asset_pack_* functions
+ * and should not be modified.
+ */
+typedef struct asset_pack_s {
+	int file;                 ///< File descriptor of the pack
+	uint32_t count;           ///< Number of assets in the pack
+	uint32_t buckets;         ///< Size of the name hash table
+	const void* entries;      ///< Index entries, in the arena
+	const uint32_t* table;    ///< Name hash table, in the arena
+	const char* names;        ///< Asset names, in the arena
+	const void** loaded;      ///< Where each loaded asset is, in the arena
+	uint8_t* arena;           ///< Storage for the index and loaded assets
+	size_t arena_size;        ///< Size of the arena in bytes
+	size_t arena_used;        ///< Bytes of the arena in use
+} asset_pack_s_t;
+
+/**
+ * Opens an asset pack and reads its index into the arena.
+ *
+ * The pack keeps its file open until asset_pack_close() is called, which
+ * counts against the 8 files the microSD card can have open at once.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - pack or arena is NULL, or the file is not a valid asset pack.
+ * ENOMEM - The arena is too small to hold the index.
+ * Any errno set by open() or read() on the file.
+ *
+ * \param pack
+ *        The pack to open
+ * \param path
+ *        Path of the pack file, e.g. "/usd/assets.pak"
+ * \param arena
+ *        Storage for the index and every asset that gets loaded. Assets stay
+ *        in the arena until the pack is closed. Must be 8 byte aligned.
+ * \param arena_size
+ *        The size of the arena in bytes
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t asset_pack_open(asset_pack_s_t* pack, const char* path, void* arena, size_t arena_size);
+
+/**
+ * Gets an asset by name, reading it into the arena if this is the first time
+ * it was requested. Assets are 8 byte aligned, so arrays of doubles or structs
+ * can be read from them directly.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - pack or name is NULL, or the pack was never opened.
+ * ENOENT - The pack has no asset with that name.
+ * ENOMEM - The arena is too small to hold the asset.
+ * EIO - The asset could not be read from the pack, or was not loaded before
+ * the pack was closed.
+ *
+ * \param pack
+ *        The pack to read from
+ * \param name
+ *        The name of the asset
+ * \param[out] size
+ *        If not NULL, receives the size of the asset in bytes
+ *
+ * \return A pointer to the asset, or NULL if the operation failed, setting
+ * errno.
+ */
+const void* asset_get(asset_pack_s_t* pack, const char* name, size_t* size);
+
+/**
+ * Closes an asset pack's file. Assets that were already loaded can still be
+ * looked up, and pointers returned by asset_get() stay valid until the arena is
+ * reused.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - pack is NULL or not open.
+ *
+ * \param pack
+ *        The pack to close
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t asset_pack_close(asset_pack_s_t* pack);
+
+#ifdef __cplusplus
+}
+}
+}
+#endif
+
+#endif  // _PROS_ASSETS_H_
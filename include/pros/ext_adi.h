@@ -122,6 +122,29 @@ int32_t ext_adi_port_set_config(uint8_t smart_port, uint8_t adi_port, adi_port_c
  */
 int32_t ext_adi_port_set_value(uint8_t smart_port, uint8_t adi_port, int32_t value);
 
+/**
+ * Reads the configuration and value of all 8 ports of an ADI Expander at once.
+ *
+ * This takes the port's mutex once instead of once per ADI port, so it is much
+ * cheaper than reading each ADI port separately.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The smart port value is not within its valid range (1-21).
+ * ENODEV - The port cannot be configured as an ADI Expander
+ * EACCES - Another resource is currently trying to access the port.
+ * EINVAL - snapshot is NULL.
+ *
+ * \param smart_port
+ *        The smart port number that the ADI Expander is in
+ * \param[out] snapshot
+ *        Where to store the configurations and values
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t ext_adi_read_all(uint8_t smart_port, adi_snapshot_s_t* snapshot);
+
 /**
  * Calibrates the analog sensor on the specified port and returns the new
  * calibration value.
@@ -784,6 +807,170 @@ int32_t ext_adi_led_set_pixel(ext_adi_led_t led, uint32_t* buffer, uint32_t buff
  */
 int32_t ext_adi_led_clear_pixel(ext_adi_led_t led, uint32_t* buffer, uint32_t buffer_length, uint32_t pixel_position);
 
+/******************************************************************************/
+/**                           Addressable LED Engine                         **/
+/**                                                                          **/
+/**  The LED engine updates addressable LED strips from its own task. Each   **/
+/**  strip is double buffered: frames are drawn into a back buffer and       **/
+/**  committed, and the engine sends only the span of LEDs that changed     **/
+/**  since the last frame. Effects are drawn by the engine itself, so        **/
+/**  animations don't cost the control loop any time.                        **/
+/******************************************************************************/
+
+/**
+ * The most strips the LED engine can drive at once.
+ */
+#define ADI_LED_ENGINE_MAX_STRIPS 8
+
+/**
+ * Effects the LED engine can draw on a strip.
+ */
+typedef enum ext_adi_led_effect_e {
+	/// No effect, the strip shows frames written with ext_adi_led_engine_write()
+	E_ADI_LED_EFFECT_NONE = 0,
+	/// Every LED is color
+	E_ADI_LED_EFFECT_FILL,
+	/// Blends from color at the start of the strip to color2 at the end,
+	/// scrolling by one LED every period milliseconds if period is not 0
+	E_ADI_LED_EFFECT_GRADIENT,
+	/// A block of width LEDs of color moves along a background of color2,
+	/// advancing one LED every period milliseconds
+	E_ADI_LED_EFFECT_CHASE
+} ext_adi_led_effect_e_t;
+
+/**
+ * An effect for the LED engine to draw.
+ */
+typedef struct ext_adi_led_effect_s {
+	ext_adi_led_effect_e_t type;
+	uint32_t color;
+	uint32_t color2;
+	uint32_t period;
+	uint32_t width;
+} ext_adi_led_effect_s_t;
+
+/**
+ * Frame timing of the LED engine.
+ */
+typedef struct ext_adi_led_engine_stats_s {
+	/// Number of frames the engine has run
+	uint32_t frames;
+	/// Time taken by the last frame, in microseconds
+	uint32_t last_frame_us;
+	/// Longest time taken by a frame, in microseconds
+	uint32_t max_frame_us;
+	/// Total number of LED colors sent to strips
+	uint32_t leds_sent;
+} ext_adi_led_engine_stats_s_t;
+
+/**
+ * @brief Start driving a led strip from the LED engine
+ *
+ * The strip starts dark. Calling this again for the same led changes its
+ * length.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of ADI Ports
+ * EINVAL - length is 0 or more than 64
+ * EADDRINUSE - The port is not configured for ADI output
+ * ENOMEM - The engine is already driving ADI_LED_ENGINE_MAX_STRIPS strips
+ *
+ * @param led port of type adi_led_t
+ * @param length number of LEDs on the strip
+ * @return PROS_SUCCESS if successful, PROS_ERR if not
+ */
+int32_t ext_adi_led_engine_start(ext_adi_led_t led, uint32_t length);
+
+/**
+ * @brief Stop driving a led strip from the LED engine
+ *
+ * The strip keeps showing its last frame.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENOENT - The engine is not driving this led
+ *
+ * @param led port of type adi_led_t
+ * @return PROS_SUCCESS if successful, PROS_ERR if not
+ */
+int32_t ext_adi_led_engine_stop(ext_adi_led_t led);
+
+/**
+ * @brief Write colors into a strip's back buffer
+ *
+ * The colors are shown once ext_adi_led_engine_commit() is called. Writing
+ * stops any effect on the strip.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENOENT - The engine is not driving this led
+ * EINVAL - colors is NULL or the span does not fit on the strip
+ *
+ * @param led port of type adi_led_t
+ * @param colors colors in format 0xRRGGBB
+ * @param offset index of the first LED to write (0 indexed)
+ * @param count number of LEDs to write
+ * @return PROS_SUCCESS if successful, PROS_ERR if not
+ */
+int32_t ext_adi_led_engine_write(ext_adi_led_t led, const uint32_t* colors, uint32_t offset, uint32_t count);
+
+/**
+ * @brief Show the contents of a strip's back buffer on the next frame
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENOENT - The engine is not driving this led
+ *
+ * @param led port of type adi_led_t
+ * @return PROS_SUCCESS if successful, PROS_ERR if not
+ */
+int32_t ext_adi_led_engine_commit(ext_adi_led_t led);
+
+/**
+ * @brief Set the effect the LED engine draws on a strip
+ *
+ * The effect is drawn on every frame until another effect is set or colors
+ * are written with ext_adi_led_engine_write(). Passing NULL stops the current
+ * effect and leaves its last frame showing.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENOENT - The engine is not driving this led
+ * EINVAL - The effect type is not valid
+ *
+ * @param led port of type adi_led_t
+ * @param effect the effect to draw, which is copied
+ * @return PROS_SUCCESS if successful, PROS_ERR if not
+ */
+int32_t ext_adi_led_engine_set_effect(ext_adi_led_t led, const ext_adi_led_effect_s_t* effect);
+
+/**
+ * @brief Set how often the LED engine runs a frame
+ *
+ * The default is 20 ms.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - period is 0
+ *
+ * @param period time between frames in milliseconds
+ * @return PROS_SUCCESS if successful, PROS_ERR if not
+ */
+int32_t ext_adi_led_engine_set_frame_period(uint32_t period);
+
+/**
+ * @brief Get frame timing statistics from the LED engine
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - stats is NULL
+ *
+ * @param stats where to store the statistics
+ * @return PROS_SUCCESS if successful, PROS_ERR if not
+ */
+int32_t ext_adi_led_engine_get_stats(ext_adi_led_engine_stats_s_t* stats);
+
 #ifdef __cplusplus
 }  // namespace c
 }  // namespace pros
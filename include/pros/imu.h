@@ -67,6 +67,16 @@ typedef struct __attribute__((__packed__)) euler_s {
 	double yaw;
 } euler_s_t;
 
+/**
+ * A single packet of IMU data, as recorded by the IMU sample ring.
+ */
+typedef struct imu_sample_s {
+	uint32_t timestamp;         ///< Time the sensor produced this data, in milliseconds
+	imu_gyro_s_t gyro;          ///< Raw gyroscope rates
+	imu_accel_s_t accel;        ///< Raw accelerations
+	quaternion_s_t quaternion;  ///< Orientation, including tare offsets
+} imu_sample_s_t;
+
 #ifdef PROS_USE_SIMPLE_NAMES
 #ifdef __cplusplus
 #define IMU_STATUS_CALIBRATING pros::E_IMU_STATUS_CALIBRATING
@@ -561,6 +571,87 @@ int32_t imu_set_yaw(uint8_t port, double target);
  */
 imu_orientation_e_t imu_get_physical_orientation(uint8_t port);
 
+/**
+ * Starts recording every data packet from the IMU into a sample ring.
+ *
+ * Once started, the system daemon copies each new packet from the sensor into
+ * buffer along with the sensor's timestamp, so consecutive samples are never
+ * missed or duplicated as long as imu_sample_ring_read() keeps up. The ring
+ * holds capacity - 1 samples. When it is full, new samples are dropped and
+ * counted by imu_sample_ring_get_dropped(). Nothing is recorded while the IMU
+ * is calibrating.
+ *
+ * The buffer must stay valid until imu_sample_ring_stop() is called.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as an Inertial Sensor
+ * EINVAL - buffer is NULL or capacity is less than 2
+ *
+ * \param  port
+ * 				 The V5 Inertial Sensor port number from 1-21
+ * \param  buffer
+ * 				 Storage for the samples
+ * \param  capacity
+ * 				 The number of samples buffer can hold
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t imu_sample_ring_start(uint8_t port, imu_sample_s_t* buffer, uint32_t capacity);
+
+/**
+ * Stops recording IMU samples. Samples that have not been read are discarded.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as an Inertial Sensor
+ *
+ * \param  port
+ * 				 The V5 Inertial Sensor port number from 1-21
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t imu_sample_ring_stop(uint8_t port);
+
+/**
+ * Reads the samples recorded since the last call, oldest first.
+ *
+ * Only one task should read from a given IMU's sample ring.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as an Inertial Sensor
+ * ENOENT - The sample ring has not been started.
+ *
+ * \param  port
+ * 				 The V5 Inertial Sensor port number from 1-21
+ * \param  samples
+ * 				 Where to copy the samples
+ * \param  max
+ * 				 The maximum number of samples to copy
+ * \return The number of samples copied, or PROS_ERR if the operation failed,
+ * setting errno.
+ */
+int32_t imu_sample_ring_read(uint8_t port, imu_sample_s_t* samples, uint32_t max);
+
+/**
+ * Gets the number of samples dropped because the sample ring was full.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as an Inertial Sensor
+ *
+ * \param  port
+ * 				 The V5 Inertial Sensor port number from 1-21
+ * \return The number of dropped samples since the ring was started, or
+ * PROS_ERR if the operation failed, setting errno.
+ */
+int32_t imu_sample_ring_get_dropped(uint8_t port);
+
 #ifdef __cplusplus
 }
 }
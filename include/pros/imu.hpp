@@ -465,6 +465,57 @@ class Imu {
 	 *
 	 */
 	virtual pros::c::imu_orientation_e_t get_physical_orientation() const;
+
+	/**
+	 * Starts recording every data packet from the IMU into a sample ring.
+	 *
+	 * See pros::c::imu_sample_ring_start() for details.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENXIO - The given value is not within the range of V5 ports (1-21).
+	 * ENODEV - The port cannot be configured as an Inertial Sensor
+	 * EINVAL - buffer is NULL or capacity is less than 2
+	 *
+	 * \param buffer
+	 *        Storage for the samples, which must outlive the sample ring
+	 * \param capacity
+	 *        The number of samples buffer can hold
+	 * \return 1 if the operation was successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	virtual std::int32_t start_sample_ring(pros::c::imu_sample_s_t* buffer, std::uint32_t capacity) const;
+
+	/**
+	 * Stops recording IMU samples.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENXIO - The given value is not within the range of V5 ports (1-21).
+	 * ENODEV - The port cannot be configured as an Inertial Sensor
+	 *
+	 * \return 1 if the operation was successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	virtual std::int32_t stop_sample_ring() const;
+
+	/**
+	 * Reads the samples recorded since the last call, oldest first, without
+	 * blocking.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENXIO - The given value is not within the range of V5 ports (1-21).
+	 * ENOENT - The sample ring has not been started.
+	 *
+	 * \param samples
+	 *        Where to copy the samples
+	 * \param max
+	 *        The maximum number of samples to copy
+	 * \return The number of samples copied, or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	virtual std::int32_t read_samples(pros::c::imu_sample_s_t* samples, std::uint32_t max) const;
 };
 
 using IMU = Imu;
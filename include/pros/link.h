@@ -266,6 +266,263 @@ uint32_t link_receive(uint8_t port, void* dest, uint16_t data_size);
  */
 uint32_t link_clear_receive_buf(uint8_t port);
 
+/******************************************************************************/
+/**                          Reliable Link Transport                         **/
+/**                                                                          **/
+/**  The link transport delivers whole messages over a link in order,        **/
+/**  retransmitting anything that is lost or corrupted on the way.           **/
+/******************************************************************************/
+
+/**
+ * Most payload bytes carried by one link transport frame.
+ */
+#define LINK_TRANSPORT_FRAME_PAYLOAD 64
+
+/**
+ * Largest message the link transport can send or receive.
+ */
+#define LINK_TRANSPORT_MAX_MESSAGE 1024
+
+/**
+ * Number of frames the link transport keeps in flight before waiting for an
+ * acknowledgement.
+ */
+#define LINK_TRANSPORT_WINDOW 8
+
+/**
+ * Number of frames the link transport can queue for sending.
+ */
+#define LINK_TRANSPORT_TX_FRAMES 32
+
+/**
+ * Bytes of received messages the link transport can hold until they are read.
+ */
+#define LINK_TRANSPORT_RX_BUFFER 2048
+
+/**
+ * Bytes of framing added to each frame: two sync bytes, flags, sequence
+ * number, acknowledgement, length, the session numbers of both ends and a
+ * CRC-16.
+ */
+#define LINK_TRANSPORT_FRAME_OVERHEAD 12
+
+/**
+ * The byte stream a link transport runs over. The transport binds this to a
+ * VEXlink radio, but any stream can be used, such as an in-memory stand-in for
+ * testing.
+ */
+typedef struct link_radio_s {
+    /// Sends up to size bytes, returning how many were accepted
+    uint32_t (*transmit)(void* context, const uint8_t* data, uint32_t size);
+    /// Receives up to size bytes, returning how many were read
+    uint32_t (*receive)(void* context, uint8_t* data, uint32_t size);
+    /// Returns how many bytes can be sent without blocking
+    uint32_t (*transmittable)(void* context);
+    /// Passed to each of the functions above
+    void* context;
+} link_radio_s_t;
+
+/**
+ * Counters kept by a link transport.
+ */
+typedef struct link_transport_stats_s {
+    uint32_t frames_sent;       ///< Data frames sent, including retransmissions
+    uint32_t retransmissions;   ///< Data frames sent again after a timeout
+    uint32_t frames_received;   ///< Valid frames received
+    uint32_t crc_errors;        ///< Frames dropped because their CRC did not match
+    uint32_t resyncs;           ///< Bytes skipped while looking for the start of a frame
+    uint32_t messages_sent;     ///< Messages fully acknowledged by the other end
+    uint32_t messages_received; ///< Messages delivered to link_transport_receive()
+    uint32_t peer_restarts;     ///< Times the other end was seen to start over with a new session
+} link_transport_stats_s_t;
+
+/**
+ * State of a link transport. Treat the fields as private.
+ */
+typedef struct link_transport_s {
+    link_radio_s_t radio;
+    uint8_t port;
+    void* mutex;
+    uint32_t timeout;
+    link_transport_stats_s_t stats;
+    // session numbers, picked at random when each end is set up
+    uint16_t session;
+    uint16_t peer_session;       // 0 until the other end is heard from
+    uint16_t peer_session_prev;  // frames still in flight from before a restart are ignored
+    // frames queued for sending, oldest unacknowledged first
+    struct {
+        uint8_t flags;
+        uint8_t length;
+        uint8_t payload[LINK_TRANSPORT_FRAME_PAYLOAD];
+    } tx_frames[LINK_TRANSPORT_TX_FRAMES];
+    uint32_t tx_base;    // index of the oldest unacknowledged frame
+    uint32_t tx_count;   // frames queued, including those in flight
+    uint32_t tx_sent;    // frames after tx_base that have been sent at least once
+    uint32_t tx_resend;  // offset from tx_base of the next frame to send
+    uint8_t tx_seq;      // sequence number of the frame at tx_base
+    bool tx_mid_message; // the frame before tx_base had more fragments after it
+    uint32_t tx_last_progress;
+    // receive side
+    uint8_t rx_expected;
+    bool ack_pending;
+    uint8_t parse[LINK_TRANSPORT_FRAME_PAYLOAD + LINK_TRANSPORT_FRAME_OVERHEAD];
+    uint32_t parse_length;
+    uint8_t assembly[LINK_TRANSPORT_MAX_MESSAGE];
+    uint32_t assembly_length;
+    uint8_t rx_buffer[LINK_TRANSPORT_RX_BUFFER];
+    uint32_t rx_head;
+    uint32_t rx_tail;
+    uint32_t rx_used;
+} link_transport_s_t;
+
+/**
+ * Sets up a link transport over the VEXlink on a radio port.
+ *
+ * Both ends of the link must use the link transport. The link itself must
+ * already be set up with link_init().
+ *
+ * Each time a transport is set up it starts a new session. When the other end
+ * sees a new session, such as after this robot's program restarts, it drops
+ * any partly received message and numbers its unacknowledged frames from the
+ * start again, so the two ends pick up where the restarted one left off.
+ * Messages the restarted end had queued but not sent are lost.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * EINVAL - transport is NULL.
+ * ENOMEM - The transport's mutex could not be created.
+ *
+ * \param transport
+ *      The transport to set up
+ * \param port
+ *      The port of the radio for the intended link.
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t link_transport_init(link_transport_s_t* transport, uint8_t port);
+
+/**
+ * Sets up a link transport over any byte stream.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - transport or radio is NULL, or a radio function is missing.
+ * ENOMEM - The transport's mutex could not be created.
+ *
+ * \param transport
+ *      The transport to set up
+ * \param radio
+ *      The byte stream to use, which is copied
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t link_transport_init_radio(link_transport_s_t* transport, const link_radio_s_t* radio);
+
+/**
+ * Sets how long the link transport waits for an acknowledgement before sending
+ * unacknowledged frames again. The default is 100 ms.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - transport is NULL or timeout is 0.
+ *
+ * \param transport
+ *      The transport to change
+ * \param timeout
+ *      The retransmission timeout in milliseconds
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t link_transport_set_timeout(link_transport_s_t* transport, uint32_t timeout);
+
+/**
+ * Queues a message to be sent over a link transport.
+ *
+ * Messages longer than one frame are split into fragments and put back
+ * together by the other end. The message is sent by link_transport_poll(),
+ * which this calls once.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - transport or data is NULL, or size is 0.
+ * EMSGSIZE - size is larger than LINK_TRANSPORT_MAX_MESSAGE.
+ * EBUSY - There is not enough room in the send queue for the message yet.
+ *
+ * \param transport
+ *      The transport to send on
+ * \param data
+ *      The message to send
+ * \param size
+ *      Length of the message in bytes
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t link_transport_send(link_transport_s_t* transport, const void* data, uint32_t size);
+
+/**
+ * Reads the next message received by a link transport.
+ *
+ * This calls link_transport_poll() once before looking for a message.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - transport or dest is NULL.
+ * EMSGSIZE - The next message is larger than size. It is left in the queue.
+ *
+ * \param transport
+ *      The transport to receive from
+ * \param dest
+ *      Where to copy the message
+ * \param size
+ *      Size of dest in bytes
+ *
+ * \return The length of the message, 0 if no message has been received, or
+ * PROS_ERR if the operation failed, setting errno.
+ */
+int32_t link_transport_receive(link_transport_s_t* transport, void* dest, uint32_t size);
+
+/**
+ * Sends and receives pending frames on a link transport.
+ *
+ * This reads everything available from the radio, acknowledges data, and sends
+ * queued and timed out frames as far as the window and the radio's buffer
+ * allow. Call it regularly, e.g. every 10-20 ms, even when nothing is being
+ * sent, so that the other end's messages are acknowledged.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - transport is NULL.
+ *
+ * \param transport
+ *      The transport to service
+ *
+ * \return The number of frames queued for sending that are not yet
+ * acknowledged, or PROS_ERR if the operation failed, setting errno.
+ */
+int32_t link_transport_poll(link_transport_s_t* transport);
+
+/**
+ * Gets the counters kept by a link transport.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - transport or stats is NULL.
+ *
+ * \param transport
+ *      The transport to read
+ * \param stats
+ *      Where to store the counters
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t link_transport_get_stats(link_transport_s_t* transport, link_transport_stats_s_t* stats);
+
 #ifdef __cplusplus
 }
 }
@@ -423,6 +423,131 @@ int32_t controller_clear(controller_id_e_t id);
  */
 int32_t controller_rumble(controller_id_e_t id, const char* rumble_pattern);
 
+/**
+ * Sets text in the controller's screen buffer.
+ *
+ * The controller screen buffer holds 3 lines of text. Writing to it only
+ * changes memory and never blocks on the controller. The system daemon sends
+ * the changed part of one line to the controller each time the controller can
+ * accept an update (about every 50ms), so the screen always ends up showing the
+ * latest buffer contents. Mixing the buffered functions with controller_print()
+ * or controller_set_text() on the same controller is not recommended, since
+ * the buffer will redraw over unbuffered text that differs from it.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - A value other than E_CONTROLLER_MASTER or E_CONTROLLER_PARTNER is
+ * given, or the line or column is out of range.
+ * EACCES - Another resource is currently trying to access the controller port.
+ *
+ * \param id
+ *        The ID of the controller (e.g. the master or partner controller).
+ *        Must be one of CONTROLLER_MASTER or CONTROLLER_PARTNER
+ * \param line
+ *        The line number at which the text will be displayed [0-2]
+ * \param col
+ *        The column number at which the text will be displayed [0-18]
+ * \param str
+ *        The pre-formatted string to write. Text past the end of the line is
+ *        dropped.
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t controller_fb_set_text(controller_id_e_t id, uint8_t line, uint8_t col, const char* str);
+
+/**
+ * Prints formatted text into the controller's screen buffer. See
+ * controller_fb_set_text().
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - A value other than E_CONTROLLER_MASTER or E_CONTROLLER_PARTNER is
+ * given, or the line or column is out of range.
+ * EACCES - Another resource is currently trying to access the controller port.
+ *
+ * \param id
+ *        The ID of the controller (e.g. the master or partner controller).
+ *        Must be one of CONTROLLER_MASTER or CONTROLLER_PARTNER
+ * \param line
+ *        The line number at which the text will be displayed [0-2]
+ * \param col
+ *        The column number at which the text will be displayed [0-18]
+ * \param fmt
+ *        The format string to print to the controller
+ * \param ...
+ *        The argument list for the format string
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t controller_fb_print(controller_id_e_t id, uint8_t line, uint8_t col, const char* fmt, ...);
+
+/**
+ * Clears a line of the controller's screen buffer. See
+ * controller_fb_set_text().
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - A value other than E_CONTROLLER_MASTER or E_CONTROLLER_PARTNER is
+ * given, or the line is out of range.
+ * EACCES - Another resource is currently trying to access the controller port.
+ *
+ * \param id
+ *        The ID of the controller (e.g. the master or partner controller).
+ *        Must be one of CONTROLLER_MASTER or CONTROLLER_PARTNER
+ * \param line
+ *        The line number to clear [0-2]
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t controller_fb_clear_line(controller_id_e_t id, uint8_t line);
+
+/**
+ * Clears the controller's screen buffer. See controller_fb_set_text().
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - A value other than E_CONTROLLER_MASTER or E_CONTROLLER_PARTNER is
+ * given.
+ * EACCES - Another resource is currently trying to access the controller port.
+ *
+ * \param id
+ *        The ID of the controller (e.g. the master or partner controller).
+ *        Must be one of CONTROLLER_MASTER or CONTROLLER_PARTNER
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t controller_fb_clear(controller_id_e_t id);
+
+/**
+ * Queues a rumble pattern to be sent to the controller.
+ *
+ * Up to 4 patterns can be queued. Queued rumbles are sent in order by the
+ * system daemon and take priority over controller screen buffer updates.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - A value other than E_CONTROLLER_MASTER or E_CONTROLLER_PARTNER is
+ * given.
+ * EACCES - Another resource is currently trying to access the controller port.
+ * EAGAIN - The rumble queue is full.
+ *
+ * \param id
+ *				The ID of the controller (e.g. the master or partner controller).
+ *				Must be one of CONTROLLER_MASTER or CONTROLLER_PARTNER
+ * \param rumble_pattern
+ *				A string consisting of the characters '.', '-', and ' ', where dots
+ *				are short rumbles, dashes are long rumbles, and spaces are pauses.
+ *				Maximum supported length is 8 characters.
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t controller_fb_rumble(controller_id_e_t id, const char* rumble_pattern);
+
 /**
  * Gets the current voltage of the battery, as reported by VEXos.
  *
@@ -255,6 +255,105 @@ class Controller {
 	 */
 	std::int32_t clear(void);
 
+	/**
+	 * Prints formatted text into the controller's screen buffer.
+	 *
+	 * Writing to the buffer never blocks on the controller. The system daemon
+	 * sends changed text to the controller as fast as it can accept updates.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EINVAL - The line or column is out of range.
+	 * EACCES - Another resource is currently trying to access the controller
+	 * port.
+	 *
+	 * \param line
+	 *        The line number at which the text will be displayed [0-2]
+	 * \param col
+	 *        The column number at which the text will be displayed [0-18]
+	 * \param fmt
+	 *        The format string to print to the controller
+	 * \param ...
+	 *        The argument list for the format string
+	 *
+	 * \return 1 if the operation was successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	template <typename... Params>
+	std::int32_t fb_print(std::uint8_t line, std::uint8_t col, const char* fmt, Params... args) {
+		return pros::c::controller_fb_print(_id, line, col, fmt, convert_args(args)...);
+	}
+
+	/**
+	 * Sets text in the controller's screen buffer.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EINVAL - The line or column is out of range.
+	 * EACCES - Another resource is currently trying to access the controller
+	 * port.
+	 *
+	 * \param line
+	 *        The line number at which the text will be displayed [0-2]
+	 * \param col
+	 *        The column number at which the text will be displayed [0-18]
+	 * \param str
+	 *        The pre-formatted string to write
+	 *
+	 * \return 1 if the operation was successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	std::int32_t fb_set_text(std::uint8_t line, std::uint8_t col, const std::string& str);
+
+	/**
+	 * Clears a line of the controller's screen buffer.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EINVAL - The line is out of range.
+	 * EACCES - Another resource is currently trying to access the controller
+	 * port.
+	 *
+	 * \param line
+	 *        The line number to clear [0-2]
+	 *
+	 * \return 1 if the operation was successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	std::int32_t fb_clear_line(std::uint8_t line);
+
+	/**
+	 * Clears the controller's screen buffer.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EACCES - Another resource is currently trying to access the controller
+	 * port.
+	 *
+	 * \return 1 if the operation was successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	std::int32_t fb_clear(void);
+
+	/**
+	 * Queues a rumble pattern to be sent to the controller.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EACCES - Another resource is currently trying to access the controller
+	 * port.
+	 * EAGAIN - The rumble queue is full.
+	 *
+	 * \param rumble_pattern
+	 *				A string consisting of the characters '.', '-', and ' ', where dots
+	 *				are short rumbles, dashes are long rumbles, and spaces are pauses.
+	 *				Maximum supported length is 8 characters.
+	 *
+	 * \return 1 if the operation was successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	std::int32_t fb_rumble(const char* rumble_pattern);
+
 	private:
 	controller_id_e_t _id;
 };
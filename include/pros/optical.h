@@ -68,6 +68,43 @@ typedef struct optical_gesture_s {
 	uint32_t time;
 } optical_gesture_s_t;
 
+/**
+ * Band index reported by the optical classifier when no band matches.
+ */
+#define OPTICAL_BAND_NONE 0xFF
+
+/**
+ * A color band for the optical classifier. A reading is in the band when its
+ * hue, saturation and proximity are all within the limits.
+ */
+typedef struct optical_band_s {
+	// Hue range in degrees. If hue_min is greater than hue_max, the band wraps
+	// through 0, which is useful for red.
+	double hue_min;
+	double hue_max;
+	// Minimum saturation from 0 to 1.0, used to reject gray and white surfaces
+	double saturation_min;
+	// Proximity range from 0 to 255, used to require that an object is present
+	int32_t proximity_min;
+	int32_t proximity_max;
+} optical_band_s_t;
+
+/**
+ * A change in classification reported by the optical classifier.
+ */
+typedef struct optical_event_s {
+	// Time of the sensor reading that caused the change (milliseconds)
+	uint32_t timestamp;
+	// Index of the band that now matches, or OPTICAL_BAND_NONE
+	uint8_t band;
+	// Index of the band that matched before, or OPTICAL_BAND_NONE
+	uint8_t previous;
+	// The reading that caused the change
+	double hue;
+	double saturation;
+	int32_t proximity;
+} optical_event_s_t;
+
 /**
  * Get the detected color hue
  *
@@ -298,6 +335,117 @@ double optical_get_integration_time(uint8_t port);
  */
 int32_t optical_set_integration_time(uint8_t port, double time);
 
+/**
+ * Finds the first band that a reading falls in.
+ *
+ * This is the test used by the optical classifier, and can be used to check
+ * bands against recorded readings.
+ *
+ * \param bands
+ *        The bands to test, in priority order
+ * \param band_count
+ *        The number of bands
+ * \param hue
+ *        Hue from 0 to 359.999
+ * \param saturation
+ *        Saturation from 0 to 1.0
+ * \param proximity
+ *        Proximity from 0 to 255
+ * \return The index of the first matching band, or OPTICAL_BAND_NONE
+ */
+uint8_t optical_classify(const optical_band_s_t* bands, uint32_t band_count, double hue, double saturation,
+                         int32_t proximity);
+
+/**
+ * Starts classifying every reading from the Optical Sensor.
+ *
+ * Once started, the system daemon checks each new reading from the sensor
+ * against bands with optical_classify(). Whenever the matching band changes, it
+ * pushes an event into the events buffer, so an object passing the sensor
+ * produces one event when it arrives and one when it leaves. This reacts
+ * within one integration period plus 2 ms without the user program polling the
+ * sensor. Lower the integration time with optical_set_integration_time() for
+ * faster objects.
+ *
+ * The event queue holds capacity - 1 events. When it is full, new events are
+ * dropped and counted by optical_classifier_get_dropped(). Both bands and
+ * events must stay valid until optical_classifier_stop() is called.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as an Optical Sensor
+ * EINVAL - bands or events is NULL, band_count is 0 or more than 254, or
+ * capacity is less than 2
+ *
+ * \param port
+ *        The V5 Optical Sensor port number from 1-21
+ * \param bands
+ *        The bands to classify readings into, in priority order
+ * \param band_count
+ *        The number of bands
+ * \param events
+ *        Storage for the event queue
+ * \param capacity
+ *        The number of events the buffer can hold
+ * \return 1 if the operation is successful or PROS_ERR if the operation failed,
+ * setting errno.
+ */
+int32_t optical_classifier_start(uint8_t port, const optical_band_s_t* bands, uint32_t band_count,
+                                 optical_event_s_t* events, uint32_t capacity);
+
+/**
+ * Stops the optical classifier. Events that have not been read are discarded.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as an Optical Sensor
+ *
+ * \param port
+ *        The V5 Optical Sensor port number from 1-21
+ * \return 1 if the operation is successful or PROS_ERR if the operation failed,
+ * setting errno.
+ */
+int32_t optical_classifier_stop(uint8_t port);
+
+/**
+ * Reads the classification events since the last call, oldest first.
+ *
+ * Only one task should read from a given sensor's event queue.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as an Optical Sensor
+ * ENOENT - The classifier has not been started.
+ *
+ * \param port
+ *        The V5 Optical Sensor port number from 1-21
+ * \param events
+ *        Where to copy the events
+ * \param max
+ *        The maximum number of events to copy
+ * \return The number of events copied, or PROS_ERR if the operation failed,
+ * setting errno.
+ */
+int32_t optical_classifier_read(uint8_t port, optical_event_s_t* events, uint32_t max);
+
+/**
+ * Gets the number of events dropped because the event queue was full.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as an Optical Sensor
+ *
+ * \param port
+ *        The V5 Optical Sensor port number from 1-21
+ * \return The number of dropped events since the classifier was started, or
+ * PROS_ERR if the operation failed, setting errno.
+ */
+int32_t optical_classifier_get_dropped(uint8_t port);
+
 #ifdef __cplusplus
 }
 }
@@ -251,6 +251,63 @@ class Optical {
 	 */
 	std::int32_t set_integration_time(double time);
 
+	/**
+	 * Starts classifying every reading from the Optical Sensor.
+	 *
+	 * See pros::c::optical_classifier_start() for details.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENXIO - The given value is not within the range of V5 ports (1-21).
+	 * ENODEV - The port cannot be configured as an Optical Sensor
+	 * EINVAL - bands or events is NULL, band_count is 0 or more than 254, or
+	 * capacity is less than 2
+	 *
+	 * \param bands
+	 *        The bands to classify readings into, in priority order
+	 * \param band_count
+	 *        The number of bands
+	 * \param events
+	 *        Storage for the event queue
+	 * \param capacity
+	 *        The number of events the buffer can hold
+	 * \return 1 if the operation is successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	std::int32_t start_classifier(const pros::c::optical_band_s_t* bands, std::uint32_t band_count,
+	                              pros::c::optical_event_s_t* events, std::uint32_t capacity);
+
+	/**
+	 * Stops the optical classifier. Events that have not been read are
+	 * discarded.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENXIO - The given value is not within the range of V5 ports (1-21).
+	 * ENODEV - The port cannot be configured as an Optical Sensor
+	 *
+	 * \return 1 if the operation is successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	std::int32_t stop_classifier();
+
+	/**
+	 * Reads the classification events since the last call, oldest first.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENXIO - The given value is not within the range of V5 ports (1-21).
+	 * ENOENT - The classifier has not been started.
+	 *
+	 * \param events
+	 *        Where to copy the events
+	 * \param max
+	 *        The maximum number of events to copy
+	 * \return The number of events copied, or PROS_ERR if the operation failed,
+	 * setting errno.
+	 */
+	std::int32_t read_events(pros::c::optical_event_s_t* events, std::uint32_t max);
+
 	/**
 	 * Gets the port number of the Optical Sensor.
 	 *
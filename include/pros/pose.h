@@ -0,0 +1,167 @@
+/**
+ * \file pros/pose.h
+ *
+ * Contains prototypes for the kernel pose estimator.
+ *
+ * The pose estimator fuses tracking wheels on V5 Rotation Sensors, a V5
+ * Inertial Sensor, and a V5 GPS Sensor into a single field position using an
+ * extended Kalman filter. It runs in the system daemon and updates whenever one
+ * of its sensors produces new data.
+ *
+ * Positions are in meters in the GPS field frame. Headings are in degrees,
+ * clockwise positive, with 0 facing the +Y direction like the GPS heading.
+ *
+ * This file should not be modified by users, since it gets replaced whenever
+ * a kernel upgrade occurs.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef _PROS_POSE_H_
+#define _PROS_POSE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+namespace pros {
+namespace c {
+#endif
+
+/**
+ * Sensors and tuning for the pose estimator.
+ *
+ * A port of 0 means that sensor is not used. With no ports at all, the
+ * estimator only runs on inputs passed to pose_estimator_feed().
+ */
+typedef struct pose_config_s {
+	uint8_t imu_port;         ///< Inertial Sensor used for heading changes
+	uint8_t gps_port;         ///< GPS Sensor used for absolute corrections
+	uint8_t forward_port;     ///< Rotation Sensor on a wheel that rolls forward
+	uint8_t lateral_port;     ///< Rotation Sensor on a wheel that rolls to the right
+	double wheel_diameter;    ///< Tracking wheel diameter (meters)
+	double forward_offset;    ///< Distance of the forward wheel right of the tracking center (meters)
+	double lateral_offset;    ///< Distance of the lateral wheel ahead of the tracking center (meters)
+	double odom_noise;        ///< Position variance added per meter travelled (m^2/m)
+	double heading_noise;     ///< Heading variance added per degree turned (deg^2/deg)
+	double gps_heading_noise; ///< Standard deviation of the GPS heading (degrees)
+	double gps_max_error;     ///< GPS readings with a larger reported error are ignored (meters)
+} pose_config_s_t;
+
+/**
+ * A pose estimate with its uncertainty.
+ */
+typedef struct pose_s {
+	uint32_t timestamp;       ///< Time of the last update (milliseconds)
+	double x;                 ///< X position (meters)
+	double y;                 ///< Y position (meters)
+	double heading;           ///< Heading (degrees, [0, 360))
+	double covariance[3][3];  ///< Covariance of (x, y, heading in degrees)
+} pose_s_t;
+
+/**
+ * One step of pose estimator input. These can be recorded from the sensors with
+ * pose_estimator_record() and replayed with pose_estimator_feed().
+ */
+typedef struct pose_input_s {
+	uint32_t timestamp;  ///< Time of the input (milliseconds)
+	double rotation;     ///< Unbounded IMU rotation (degrees)
+	double forward;      ///< Distance rolled by the forward wheel (meters)
+	double lateral;      ///< Distance rolled by the lateral wheel (meters)
+	bool gps_valid;      ///< Whether the GPS fields hold a new reading
+	double gps_x;        ///< GPS X position (meters)
+	double gps_y;        ///< GPS Y position (meters)
+	double gps_heading;  ///< GPS heading (degrees)
+	double gps_error;    ///< GPS reported error (meters)
+} pose_input_s_t;
+
+/**
+ * Starts the pose estimator at the given pose.
+ *
+ * The estimator keeps running until pose_estimator_stop() is called. Calling
+ * this again restarts it with the new configuration.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - config is NULL, wheel_diameter is not positive with a tracking
+ * wheel configured, or a port is not within the range of V5 ports (1-21).
+ *
+ * \param config
+ *        Sensors and tuning to use. The configuration is copied.
+ * \param x, y
+ *        The starting position (meters)
+ * \param heading
+ *        The starting heading (degrees)
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t pose_estimator_start(const pose_config_s_t* config, double x, double y, double heading);
+
+/**
+ * Stops the pose estimator. The last estimate can still be read.
+ *
+ * \return 1
+ */
+int32_t pose_estimator_stop(void);
+
+/**
+ * Gets the latest pose estimate.
+ *
+ * This never blocks and never takes a port mutex.
+ *
+ * \return The latest pose estimate
+ */
+pose_s_t pose_get(void);
+
+/**
+ * Steps the pose estimator with a recorded input.
+ *
+ * Only allowed when the estimator was started with no sensor ports, so that a
+ * recorded run can be replayed deterministically.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - input is NULL.
+ * EPERM - The estimator is not running or is reading from sensors.
+ *
+ * \param input
+ *        The input to apply
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t pose_estimator_feed(const pose_input_s_t* input);
+
+/**
+ * Records every input the pose estimator reads from its sensors into buffer
+ * until it is full. Passing NULL stops recording.
+ *
+ * \param buffer
+ *        Storage for the recorded inputs
+ * \param capacity
+ *        The number of inputs buffer can hold
+ *
+ * \return 1
+ */
+int32_t pose_estimator_record(pose_input_s_t* buffer, uint32_t capacity);
+
+/**
+ * Gets the number of inputs recorded since pose_estimator_record() was called.
+ *
+ * \return The number of inputs recorded
+ */
+uint32_t pose_estimator_record_count(void);
+
+#ifdef __cplusplus
+}
+}
+}
+#endif
+
+#endif  // _PROS_POSE_H_
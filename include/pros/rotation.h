@@ -30,6 +30,67 @@ namespace c {
 
 #define ROTATION_MINIMUM_DATA_RATE 5
 
+/**
+ * The most samples a rotation velocity estimator can keep.
+ */
+#define ROTATION_ESTIMATOR_MAX_WINDOW 16
+
+/**
+ * Methods of estimating velocity from Rotation Sensor positions.
+ */
+typedef enum rotation_estimator_e {
+	/// Change in position over the window divided by the time it spans
+	E_ROTATION_ESTIMATOR_WINDOW = 0,
+	/// Alpha-beta filter on position and velocity
+	E_ROTATION_ESTIMATOR_ALPHA_BETA,
+	/// Slope at the newest sample of a least squares quadratic fit over the window
+	/// (Savitzky-Golay), which follows acceleration better than the plain window
+	E_ROTATION_ESTIMATOR_SAVITZKY_GOLAY
+} rotation_estimator_e_t;
+
+/**
+ * Configuration of a rotation velocity estimator.
+ */
+typedef struct rotation_estimator_config_s {
+	rotation_estimator_e_t type;
+	/// Number of samples used by the window and Savitzky-Golay estimators, from 2
+	/// (3 for Savitzky-Golay) to ROTATION_ESTIMATOR_MAX_WINDOW
+	uint32_t window;
+	/// Position gain of the alpha-beta estimator, greater than 0 and at most 1
+	double alpha;
+	/// Velocity gain of the alpha-beta estimator, greater than 0 and less than 2
+	double beta;
+} rotation_estimator_config_s_t;
+
+/**
+ * State of a rotation velocity estimator.
+ *
+ * The kernel keeps one of these for each port with a running estimator. They
+ * can also be stepped directly with rotation_estimator_step() to test a
+ * configuration against recorded positions.
+ */
+typedef struct rotation_estimator_s {
+	rotation_estimator_config_s_t config;
+	uint32_t timestamps[ROTATION_ESTIMATOR_MAX_WINDOW];
+	int32_t positions[ROTATION_ESTIMATOR_MAX_WINDOW];
+	uint32_t head;
+	uint32_t count;
+	double filter_position;
+	double velocity;
+} rotation_estimator_s_t;
+
+/**
+ * A timestamped Rotation Sensor reading with its estimated velocity.
+ */
+typedef struct rotation_estimate_s {
+	/// Time the sensor reported the position (milliseconds)
+	uint32_t timestamp;
+	/// Position in centidegrees
+	int32_t position;
+	/// Estimated velocity in centidegrees per second
+	double velocity;
+} rotation_estimate_s_t;
+
 /**
  * Reset Rotation Sensor 
  *
@@ -214,6 +275,99 @@ int32_t rotation_init_reverse(uint8_t port, bool reverse_flag);
  */
 int32_t rotation_get_reversed(uint8_t port);
 
+/**
+ * Sets up a rotation velocity estimator and clears its history.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - estimator or config is NULL, or the configuration is out of range
+ *
+ * \param estimator
+ *        The estimator to set up
+ * \param config
+ *        The configuration to use. The configuration is copied.
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t rotation_estimator_init(rotation_estimator_s_t* estimator, const rotation_estimator_config_s_t* config);
+
+/**
+ * Adds a position sample to a rotation velocity estimator.
+ *
+ * Samples with a timestamp that is not newer than the previous sample are
+ * ignored.
+ *
+ * \param estimator
+ *        An estimator set up by rotation_estimator_init()
+ * \param timestamp
+ *        Time of the sample (milliseconds)
+ * \param position
+ *        Position of the sample (centidegrees)
+ *
+ * \return The estimated velocity in centidegrees per second
+ */
+double rotation_estimator_step(rotation_estimator_s_t* estimator, uint32_t timestamp, int32_t position);
+
+/**
+ * Starts estimating the Rotation Sensor's velocity in the background.
+ *
+ * Once started, the system daemon adds every new position from the sensor to
+ * an estimator, and the result can be read with rotation_get_estimate()
+ * without waiting on the port. The history is cleared whenever the position
+ * is reset or set. Calling this again restarts the estimator with the new
+ * configuration.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as an Rotation Sensor
+ * EINVAL - config is NULL or out of range
+ *
+ * \param  port
+ * 				 The V5 Rotation Sensor port number from 1-21
+ * \param  config
+ * 				 The configuration to use. The configuration is copied.
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t rotation_estimator_start(uint8_t port, const rotation_estimator_config_s_t* config);
+
+/**
+ * Stops estimating the Rotation Sensor's velocity in the background.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as an Rotation Sensor
+ *
+ * \param  port
+ * 				 The V5 Rotation Sensor port number from 1-21
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t rotation_estimator_stop(uint8_t port);
+
+/**
+ * Gets the latest position, its timestamp and the estimated velocity.
+ *
+ * This never blocks and never takes the port mutex.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENOENT - The estimator has not been started.
+ *
+ * \param  port
+ * 				 The V5 Rotation Sensor port number from 1-21
+ *
+ * \return The latest estimate, or an estimate with all fields set to PROS_ERR
+ * if the operation failed, setting errno.
+ */
+rotation_estimate_s_t rotation_get_estimate(uint8_t port);
+
 #ifdef __cplusplus
 } //namespace C
 } //namespace pros
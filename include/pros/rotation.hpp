@@ -184,6 +184,53 @@ class Rotation {
 	 * errno.
 	 */
 	virtual std::int32_t get_reversed();
+
+	/**
+	 * Starts estimating the Rotation Sensor's velocity in the background.
+	 *
+	 * See pros::c::rotation_estimator_start() for details.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENXIO - The given value is not within the range of V5 ports (1-21).
+	 * ENODEV - The port cannot be configured as an Rotation Sensor
+	 * EINVAL - config is out of range
+	 *
+	 * \param config
+	 *        The configuration to use
+	 *
+	 * \return 1 if the operation was successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	virtual std::int32_t start_estimator(const pros::c::rotation_estimator_config_s_t& config);
+
+	/**
+	 * Stops estimating the Rotation Sensor's velocity in the background.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENXIO - The given value is not within the range of V5 ports (1-21).
+	 * ENODEV - The port cannot be configured as an Rotation Sensor
+	 *
+	 * \return 1 if the operation was successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	virtual std::int32_t stop_estimator();
+
+	/**
+	 * Gets the latest position, its timestamp and the estimated velocity.
+	 *
+	 * This never blocks and never takes the port mutex.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENXIO - The given value is not within the range of V5 ports (1-21).
+	 * ENOENT - The estimator has not been started.
+	 *
+	 * \return The latest estimate, or an estimate with all fields set to
+	 * PROS_ERR if the operation failed, setting errno.
+	 */
+	virtual pros::c::rotation_estimate_s_t get_estimate();
 };
 }  // namespace pros
 
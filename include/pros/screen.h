@@ -85,6 +85,65 @@ typedef struct screen_touch_status_s {
 
 typedef void (*touch_event_cb_fn_t)();
 
+/**
+ * ! Primitives that can be recorded into a screen display list.
+ */
+typedef enum {
+    E_SCREEN_CMD_SET_PEN = 0, ///< Set the pen color
+    E_SCREEN_CMD_SET_ERASER, ///< Set the eraser color
+    E_SCREEN_CMD_DRAW_PIXEL, ///< Draw a single pixel
+    E_SCREEN_CMD_ERASE_PIXEL, ///< Erase a single pixel
+    E_SCREEN_CMD_DRAW_LINE, ///< Draw a line
+    E_SCREEN_CMD_ERASE_LINE, ///< Erase a line
+    E_SCREEN_CMD_DRAW_RECT, ///< Draw a rectangle outline
+    E_SCREEN_CMD_ERASE_RECT, ///< Erase a rectangular area
+    E_SCREEN_CMD_FILL_RECT, ///< Fill a rectangular area
+    E_SCREEN_CMD_DRAW_CIRCLE, ///< Draw a circle outline
+    E_SCREEN_CMD_ERASE_CIRCLE, ///< Erase a circular area
+    E_SCREEN_CMD_FILL_CIRCLE, ///< Fill a circular area
+    E_SCREEN_CMD_PRINT_AT ///< Print text at a pixel location
+} screen_cmd_e_t;
+
+/**
+ * ! A single recorded display list command.
+ *
+ * Shapes use (x0, y0, x1, y1) as their corners, circles use (x0, y0) as the
+ * center and x1 as the radius, and pixels and text use (x0, y0). The bounding
+ * box (bx0, by0, bx1, by1) is computed when the command is recorded and is
+ * used to cull the command against a list's dirty region.
+ */
+typedef struct screen_cmd_s {
+    screen_cmd_e_t type; ///< The primitive to execute
+    int16_t x0, y0, x1, y1; ///< Primitive coordinates
+    int16_t bx0, by0, bx1, by1; ///< Bounding box of the primitive
+    uint32_t color; ///< Color for E_SCREEN_CMD_SET_PEN and E_SCREEN_CMD_SET_ERASER
+    text_format_e_t txt_fmt; ///< Text format for E_SCREEN_CMD_PRINT_AT
+    const char* text; ///< Null-terminated text in the list's text buffer
+} screen_cmd_s_t;
+
+/**
+ * ! A display list backed by caller-provided storage.
+ *
+ * Initialize with screen_cmd_list_init(). The members should be treated as
+ * read-only by users.
+ */
+typedef struct screen_cmd_list_s {
+    screen_cmd_s_t* cmds; ///< Command storage
+    uint32_t capacity; ///< Number of commands that fit in cmds
+    uint32_t count; ///< Number of commands recorded
+    char* text; ///< Storage for formatted text
+    uint32_t text_capacity; ///< Number of bytes that fit in text
+    uint32_t text_used; ///< Number of bytes of text used
+    bool cull; ///< Whether commands outside the dirty region are skipped
+    int16_t dirty_x0, dirty_y0, dirty_x1, dirty_y1; ///< The dirty region
+} screen_cmd_list_s_t;
+
+/**
+ * Function called for every command that survives culling when a display list
+ * is executed with screen_cmd_list_execute().
+ */
+typedef void (*screen_cmd_exec_fn_t)(const screen_cmd_s_t* cmd, void* arg);
+
 #ifdef __cplusplus
 namespace c {
 #endif
@@ -382,6 +441,11 @@ uint32_t screen_fill_circle(int16_t x, int16_t y, int16_t radius);
  * 
  * Will default to a medium sized font by default if invalid txt_fmt is given.
  * 
+ * Text is formatted into a fixed buffer without allocating and is truncated to
+ * 127 characters. If the same text in the same colors was the last thing
+ * printed at this position and nothing else has been drawn since, the print is
+ * skipped.
+ *
  * \param txt_fmt Text format enum that determines if the text is medium, large, medium_center, or large_center. (DOES NOT SUPPORT SMALL)
  * \param line The line number on which to print
  * \param text  Format string
@@ -399,6 +463,11 @@ uint32_t screen_print(text_format_e_t txt_fmt, const int16_t line, const char* t
  * 
  * Text formats medium_center and large_center will default to medium and large respectively.
  * 
+ * Text is formatted into a fixed buffer without allocating and is truncated to
+ * 127 characters. If the same text in the same colors was the last thing
+ * printed at this position and nothing else has been drawn since, the print is
+ * skipped.
+ *
  * \param txt_fmt Text format enum that determines if the text is small, medium, or large.
  * \param x The y coordinate of the top left corner of the string
  * \param y The x coordinate of the top left corner of the string
@@ -465,8 +534,37 @@ uint32_t screen_vprintf_at(text_format_e_t txt_fmt, const int16_t x, const int16
 /**                    information about screen touches                      **/
 /******************************************************************************/
 
+/**
+ * Sets how often the touch screen is sampled. The same samples are used for
+ * touch callbacks, screen_touch_status(), and LVGL. The default is 10ms.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - period is 0.
+ *
+ * \param period The time between samples, in milliseconds
+ *
+ * \return 1 if there were no errors, or PROS_ERR if an error occured.
+ */
+uint32_t screen_touch_set_sample_period(uint32_t period);
+
+/**
+ * Sets the minimum time between E_TOUCH_HELD callbacks while a held touch is
+ * moving. Samples in between are coalesced, and the most recent position is
+ * delivered once the interval has passed. Press and release callbacks are
+ * never coalesced. The default of 0 dispatches every sample that changed.
+ *
+ * \param interval The minimum time between held callbacks, in milliseconds
+ *
+ * \return 1
+ */
+uint32_t screen_touch_set_hold_interval(uint32_t interval);
+
 /**
  * Gets the touch status of the last touch of the screen.
+ *
+ * This returns the most recent sample taken by the touch task rather than
+ * reading the touch screen directly. See screen_touch_set_sample_period().
  * 
  * \return The last_touch_e_t enum specifier that indicates the last touch status of the screen (E_TOUCH_EVENT_RELEASE, E_TOUCH_EVENT_PRESS, or E_TOUCH_EVENT_PRESS_AND_HOLD).
  * This will be released by default if no action was taken. 
@@ -490,6 +588,345 @@ screen_touch_status_s_t screen_touch_status(void);
  */
 uint32_t screen_touch_callback(touch_event_cb_fn_t cb, last_touch_e_t event_type);
 
+/******************************************************************************/
+/**                       Screen Display List Functions                      **/
+/**                                                                          **/
+/**   These functions record drawing commands into a preallocated buffer so  **/
+/**       that a whole frame can be drawn while holding the screen once      **/
+/******************************************************************************/
+
+/**
+ * Initializes a display list over caller-provided storage.
+ *
+ * No memory is allocated by the display list functions. Text recorded with
+ * screen_cmd_print_at() is formatted into text_buf, so text_buf may be NULL if
+ * the list will never hold text.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - list or cmd_buf is NULL, or capacity is 0.
+ *
+ * \param list The display list to initialize
+ * \param cmd_buf Storage for capacity commands
+ * \param capacity The number of commands cmd_buf can hold
+ * \param text_buf Storage for formatted text, or NULL
+ * \param text_capacity The size of text_buf in bytes
+ *
+ * \return 1 if there were no errors, or PROS_ERR if an error occured.
+ */
+uint32_t screen_cmd_list_init(screen_cmd_list_s_t* list, screen_cmd_s_t* cmd_buf, uint32_t capacity, char* text_buf,
+                              uint32_t text_capacity);
+
+/**
+ * Removes all commands and text from a display list. The dirty region is left
+ * untouched.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - list is NULL.
+ *
+ * \param list The display list to clear
+ *
+ * \return 1 if there were no errors, or PROS_ERR if an error occured.
+ */
+uint32_t screen_cmd_list_clear(screen_cmd_list_s_t* list);
+
+/**
+ * Restricts execution of a display list to commands whose bounding box
+ * intersects the given region. Pen and eraser changes are never culled.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - list is NULL.
+ *
+ * \param list The display list
+ * \param x0, y0 The (x,y) coordinates of the first corner of the region
+ * \param x1, y1 The (x,y) coordinates of the second corner of the region
+ *
+ * \return 1 if there were no errors, or PROS_ERR if an error occured.
+ */
+uint32_t screen_cmd_list_set_dirty(screen_cmd_list_s_t* list, int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+
+/**
+ * Disables culling so that every command in the display list is executed.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - list is NULL.
+ *
+ * \param list The display list
+ *
+ * \return 1 if there were no errors, or PROS_ERR if an error occured.
+ */
+uint32_t screen_cmd_list_clear_dirty(screen_cmd_list_s_t* list);
+
+/**
+ * Records a pen color change. See screen_set_pen().
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - list is NULL.
+ * ENOBUFS - The display list is full.
+ *
+ * \param list The display list to record into
+ * \param color The pen color to set
+ *
+ * \return 1 if there were no errors, or PROS_ERR if an error occured.
+ */
+uint32_t screen_cmd_set_pen(screen_cmd_list_s_t* list, uint32_t color);
+
+/**
+ * Records an eraser color change. See screen_set_eraser().
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - list is NULL.
+ * ENOBUFS - The display list is full.
+ *
+ * \param list The display list to record into
+ * \param color The eraser color to set
+ *
+ * \return 1 if there were no errors, or PROS_ERR if an error occured.
+ */
+uint32_t screen_cmd_set_eraser(screen_cmd_list_s_t* list, uint32_t color);
+
+/**
+ * Records a pixel draw. See screen_draw_pixel().
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - list is NULL.
+ * ENOBUFS - The display list is full.
+ *
+ * \param list The display list to record into
+ * \param x, y The (x,y) coordinates of the pixel
+ *
+ * \return 1 if there were no errors, or PROS_ERR if an error occured.
+ */
+uint32_t screen_cmd_draw_pixel(screen_cmd_list_s_t* list, int16_t x, int16_t y);
+
+/**
+ * Records a pixel erase. See screen_erase_pixel().
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - list is NULL.
+ * ENOBUFS - The display list is full.
+ *
+ * \param list The display list to record into
+ * \param x, y The (x,y) coordinates of the pixel
+ *
+ * \return 1 if there were no errors, or PROS_ERR if an error occured.
+ */
+uint32_t screen_cmd_erase_pixel(screen_cmd_list_s_t* list, int16_t x, int16_t y);
+
+/**
+ * Records a line draw. See screen_draw_line().
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - list is NULL.
+ * ENOBUFS - The display list is full.
+ *
+ * \param list The display list to record into
+ * \param x0, y0 The (x,y) coordinates of the first point of the line
+ * \param x1, y1 The (x,y) coordinates of the second point of the line
+ *
+ * \return 1 if there were no errors, or PROS_ERR if an error occured.
+ */
+uint32_t screen_cmd_draw_line(screen_cmd_list_s_t* list, int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+
+/**
+ * Records a line erase. See screen_erase_line().
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - list is NULL.
+ * ENOBUFS - The display list is full.
+ *
+ * \param list The display list to record into
+ * \param x0, y0 The (x,y) coordinates of the first point of the line
+ * \param x1, y1 The (x,y) coordinates of the second point of the line
+ *
+ * \return 1 if there were no errors, or PROS_ERR if an error occured.
+ */
+uint32_t screen_cmd_erase_line(screen_cmd_list_s_t* list, int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+
+/**
+ * Records a rectangle outline draw. See screen_draw_rect().
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - list is NULL.
+ * ENOBUFS - The display list is full.
+ *
+ * \param list The display list to record into
+ * \param x0, y0 The (x,y) coordinates of the first corner of the rectangle
+ * \param x1, y1 The (x,y) coordinates of the second corner of the rectangle
+ *
+ * \return 1 if there were no errors, or PROS_ERR if an error occured.
+ */
+uint32_t screen_cmd_draw_rect(screen_cmd_list_s_t* list, int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+
+/**
+ * Records a rectangle erase. See screen_erase_rect().
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - list is NULL.
+ * ENOBUFS - The display list is full.
+ *
+ * \param list The display list to record into
+ * \param x0, y0 The (x,y) coordinates of the first corner of the rectangle
+ * \param x1, y1 The (x,y) coordinates of the second corner of the rectangle
+ *
+ * \return 1 if there were no errors, or PROS_ERR if an error occured.
+ */
+uint32_t screen_cmd_erase_rect(screen_cmd_list_s_t* list, int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+
+/**
+ * Records a rectangle fill. See screen_fill_rect().
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - list is NULL.
+ * ENOBUFS - The display list is full.
+ *
+ * \param list The display list to record into
+ * \param x0, y0 The (x,y) coordinates of the first corner of the rectangle
+ * \param x1, y1 The (x,y) coordinates of the second corner of the rectangle
+ *
+ * \return 1 if there were no errors, or PROS_ERR if an error occured.
+ */
+uint32_t screen_cmd_fill_rect(screen_cmd_list_s_t* list, int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+
+/**
+ * Records a circle outline draw. See screen_draw_circle().
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - list is NULL.
+ * ENOBUFS - The display list is full.
+ *
+ * \param list The display list to record into
+ * \param x, y The (x,y) coordinates of the center of the circle
+ * \param radius The radius of the circle
+ *
+ * \return 1 if there were no errors, or PROS_ERR if an error occured.
+ */
+uint32_t screen_cmd_draw_circle(screen_cmd_list_s_t* list, int16_t x, int16_t y, int16_t radius);
+
+/**
+ * Records a circle erase. See screen_erase_circle().
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - list is NULL.
+ * ENOBUFS - The display list is full.
+ *
+ * \param list The display list to record into
+ * \param x, y The (x,y) coordinates of the center of the circle
+ * \param radius The radius of the circle
+ *
+ * \return 1 if there were no errors, or PROS_ERR if an error occured.
+ */
+uint32_t screen_cmd_erase_circle(screen_cmd_list_s_t* list, int16_t x, int16_t y, int16_t radius);
+
+/**
+ * Records a circle fill. See screen_fill_circle().
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - list is NULL.
+ * ENOBUFS - The display list is full.
+ *
+ * \param list The display list to record into
+ * \param x, y The (x,y) coordinates of the center of the circle
+ * \param radius The radius of the circle
+ *
+ * \return 1 if there were no errors, or PROS_ERR if an error occured.
+ */
+uint32_t screen_cmd_fill_circle(screen_cmd_list_s_t* list, int16_t x, int16_t y, int16_t radius);
+
+/**
+ * Records formatted text at a pixel location. See screen_print_at().
+ *
+ * The text is formatted when it is recorded, not when the list is submitted,
+ * and is stored in the list's text buffer.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - list is NULL.
+ * ENOBUFS - The display list or its text buffer is full.
+ *
+ * \param list The display list to record into
+ * \param txt_fmt Text format enum that determines if the text is small, medium, or large.
+ * \param x, y The (x,y) coordinates of the top left corner of the string
+ * \param text Format string
+ * \param ... Optional list of arguments for the format string
+ *
+ * \return 1 if there were no errors, or PROS_ERR if an error occured.
+ */
+uint32_t screen_cmd_print_at(screen_cmd_list_s_t* list, text_format_e_t txt_fmt, int16_t x, int16_t y,
+                             const char* text, ...);
+
+/**
+ * Records formatted text at a pixel location, taking a va_list. See
+ * screen_cmd_print_at().
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - list is NULL.
+ * ENOBUFS - The display list or its text buffer is full.
+ *
+ * \param list The display list to record into
+ * \param txt_fmt Text format enum that determines if the text is small, medium, or large.
+ * \param x, y The (x,y) coordinates of the top left corner of the string
+ * \param text Format string
+ * \param args List of arguments for the format string
+ *
+ * \return 1 if there were no errors, or PROS_ERR if an error occured.
+ */
+uint32_t screen_cmd_vprintf_at(screen_cmd_list_s_t* list, text_format_e_t txt_fmt, int16_t x, int16_t y,
+                               const char* text, va_list args);
+
+/**
+ * Calls fn for each command in the display list that survives culling, in
+ * recording order.
+ *
+ * This does not touch the screen, so it can be used to inspect or test a
+ * display list, or to draw it with a custom backend.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - list or fn is NULL.
+ *
+ * \param list The display list to execute
+ * \param fn The function to call for each command
+ * \param arg An argument passed through to fn
+ *
+ * \return The number of commands passed to fn, or PROS_ERR if an error occured.
+ */
+uint32_t screen_cmd_list_execute(const screen_cmd_list_s_t* list, screen_cmd_exec_fn_t fn, void* arg);
+
+/**
+ * Draws every command in the display list that survives culling while taking
+ * the screen mutex only once.
+ *
+ * The list is not cleared, so a static scene can be submitted repeatedly.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - list is NULL.
+ * EACCESS - Another resource is currently trying to access the screen mutex.
+ *
+ * \param list The display list to draw
+ *
+ * \return The number of commands drawn, or PROS_ERR if an error occured
+ *          while taking or returning the screen mutex.
+ */
+uint32_t screen_cmd_list_submit(const screen_cmd_list_s_t* list);
+
 #ifdef __cplusplus
 } //namespace c
 } //namespace pros
@@ -191,6 +191,234 @@ int32_t serial_read_byte(uint8_t port);
  */
 int32_t serial_read(uint8_t port, uint8_t* buffer, int32_t length);
 
+/**
+ * Waits until at least one of several ports has bytes to read or space to
+ * write, or the timeout elapses.
+ *
+ * The waiting task is woken by the system daemon as soon as it sees a port is
+ * ready, rather than polling. Up to 8 tasks can be woken this way at once, and
+ * any more check every millisecond instead. A port that is not configured as a
+ * generic serial port counts as ready, so that the read or write that follows
+ * reports the error.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - A mask is NULL, both masks are empty, or a mask has a bit set for a
+ * port that does not exist.
+ *
+ * \param[in,out] rx_ports
+ *        Ports to wait for bytes on, with bit n-1 standing for port n.
+ *        Replaced with the ports that have bytes.
+ * \param[in,out] tx_ports
+ *        Ports to wait for transmit space on, in the same format. Replaced with
+ *        the ports that have space.
+ * \param timeout
+ *        The longest time to wait in milliseconds, or TIMEOUT_MAX to wait
+ *        forever
+ *
+ * \return The number of ready ports, 0 if the timeout elapsed, or PROS_ERR if
+ * the operation failed, setting errno.
+ */
+int32_t serial_wait(uint32_t* rx_ports, uint32_t* tx_ports, uint32_t timeout);
+
+/**
+ * Reads up to length bytes from the port's receive ring, waiting up to timeout
+ * milliseconds for all of them to arrive.
+ *
+ * \note The receive ring must have been started with serial_rx_buffer_start().
+ * Only one task should read from a port at a time.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as a generic serial port.
+ * ENOENT - The receive ring has not been started.
+ *
+ * \param port
+ *        The V5 port number from 1-21
+ * \param buffer
+ *        The location to place the data read
+ * \param length
+ *        The number of bytes to read
+ * \param timeout
+ *        The longest time to wait in milliseconds, or TIMEOUT_MAX to wait
+ *        until length bytes have arrived
+ *
+ * \return The number of bytes read, which is less than length if the timeout
+ * elapsed, or PROS_ERR if the operation failed, setting errno.
+ */
+int32_t serial_read_timeout(uint8_t port, uint8_t* buffer, int32_t length, uint32_t timeout);
+
+/**
+ * Reads from the port's receive ring up to and including the next delimiter
+ * byte, waiting up to timeout milliseconds for it to arrive.
+ *
+ * If length bytes arrive without a delimiter, those length bytes are returned
+ * so that an oversized message can not stall the port. If the timeout elapses
+ * first, nothing is removed from the ring.
+ *
+ * \note The receive ring must have been started with serial_rx_buffer_start().
+ * Only one task should read from a port at a time.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - The given value is not within the range of V5 ports (1-21), or
+ * length is not positive.
+ * ENODEV - The port cannot be configured as a generic serial port.
+ * ENOENT - The receive ring has not been started.
+ * ETIMEDOUT - No delimiter arrived before the timeout elapsed.
+ *
+ * \param port
+ *        The V5 port number from 1-21
+ * \param buffer
+ *        The location to place the data read
+ * \param length
+ *        The maximum number of bytes to read
+ * \param delimiter
+ *        The byte that ends a message, such as '\n'
+ * \param timeout
+ *        The longest time to wait in milliseconds, or TIMEOUT_MAX to wait
+ *        forever
+ *
+ * \return The number of bytes read including the delimiter, or PROS_ERR if the
+ * operation failed, setting errno.
+ */
+int32_t serial_read_until(uint8_t port, uint8_t* buffer, int32_t length, uint8_t delimiter, uint32_t timeout);
+
+/**
+ * Starts buffering received bytes in a receive ring.
+ *
+ * Once started, the system daemon drains the port's VEXos input buffer into
+ * buffer every 2 ms, so data streamed at high baud rates is not lost while
+ * user tasks are busy. serial_read(), serial_read_byte(), serial_peek_byte()
+ * and serial_get_read_avail() then work on the ring instead of the VEXos
+ * buffer. The ring holds capacity - 1 bytes. When it is full, new bytes are
+ * left in the VEXos buffer until there is room.
+ *
+ * The buffer must stay valid until serial_rx_buffer_stop() is called.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - The given value is not within the range of V5 ports (1-21), buffer
+ * is NULL, or capacity is less than 2.
+ * EACCES - Another resource is currently trying to access the port.
+ *
+ * \param port
+ *        The V5 port number from 1-21
+ * \param buffer
+ *        Storage for the received bytes
+ * \param capacity
+ *        The size of buffer in bytes
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t serial_rx_buffer_start(uint8_t port, uint8_t* buffer, uint32_t capacity);
+
+/**
+ * Stops buffering received bytes. Bytes that have not been read are discarded.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - The given value is not within the range of V5 ports (1-21).
+ * EACCES - Another resource is currently trying to access the port.
+ *
+ * \param port
+ *        The V5 port number from 1-21
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t serial_rx_buffer_stop(uint8_t port);
+
+/**
+ * Gets a pointer to bytes in the receive ring without copying or removing
+ * them.
+ *
+ * Returns the contiguous bytes starting offset bytes past the next unread
+ * byte. Because the ring wraps, the unread bytes may come in two pieces, so
+ * call this again with offset increased by the returned count to get the
+ * rest. The bytes stay valid, and may be modified in place, until they are
+ * removed with serial_rx_buffer_consume() or the ring is stopped.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - The given value is not within the range of V5 ports (1-21), or
+ * data is NULL.
+ * ENODEV - The port cannot be configured as a generic serial port.
+ * ENOENT - The receive ring has not been started.
+ *
+ * \param port
+ *        The V5 port number from 1-21
+ * \param offset
+ *        The number of unread bytes to skip
+ * \param[out] data
+ *        Set to the first byte, or NULL if there are none
+ *
+ * \return The number of contiguous bytes at data or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t serial_rx_buffer_peek(uint8_t port, uint32_t offset, uint8_t** data);
+
+/**
+ * Removes bytes from the receive ring after they have been handled with
+ * serial_rx_buffer_peek().
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - The given value is not within the range of V5 ports (1-21), or
+ * count is more than the number of unread bytes.
+ * ENODEV - The port cannot be configured as a generic serial port.
+ * ENOENT - The receive ring has not been started.
+ *
+ * \param port
+ *        The V5 port number from 1-21
+ * \param count
+ *        The number of bytes to remove
+ *
+ * \return 1 if the operation was successful or PROS_ERR if the operation
+ * failed, setting errno.
+ */
+int32_t serial_rx_buffer_consume(uint8_t port, uint32_t count);
+
+/**
+ * Gets the most bytes the receive ring has held at once since it was started.
+ *
+ * A high water mark close to the ring capacity means the ring should be larger
+ * or read more often.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as a generic serial port.
+ * ENOENT - The receive ring has not been started.
+ *
+ * \param port
+ *        The V5 port number from 1-21
+ *
+ * \return The high water mark in bytes or PROS_ERR if the operation failed,
+ * setting errno.
+ */
+int32_t serial_rx_buffer_get_high_water(uint8_t port);
+
+/**
+ * Gets the most unread bytes the receive ring can hold, one less than the
+ * capacity it was started with.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * EINVAL - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as a generic serial port.
+ * ENOENT - The receive ring has not been started.
+ *
+ * \param port
+ *        The V5 port number from 1-21
+ *
+ * \return The number of bytes or PROS_ERR if the operation failed, setting
+ * errno.
+ */
+int32_t serial_rx_buffer_get_capacity(uint8_t port);
+
 /**
  * Write the given byte to the port's output buffer.
  *
@@ -19,7 +19,9 @@
 #ifndef _PROS_SERIAL_HPP_
 #define _PROS_SERIAL_HPP_
 
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include "pros/serial.h"
 
 namespace pros {
@@ -174,6 +176,93 @@ class Serial {
 	 */
 	virtual std::int32_t read(std::uint8_t* buffer, std::int32_t length) const;
 
+	/**
+	 * Reads up to length bytes from the port's receive ring, waiting up to
+	 * timeout milliseconds for all of them to arrive.
+	 *
+	 * \note The receive ring must have been started with start_rx_buffer().
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EINVAL - The given value is not within the range of V5 ports (1-21).
+	 * ENOENT - The receive ring has not been started.
+	 *
+	 * \param buffer
+	 *        The location to place the data read
+	 * \param length
+	 *        The number of bytes to read
+	 * \param timeout
+	 *        The longest time to wait in milliseconds
+	 *
+	 * \return The number of bytes read, which is less than length if the timeout
+	 * elapsed, or PROS_ERR if the operation failed, setting errno.
+	 */
+	virtual std::int32_t read_timeout(std::uint8_t* buffer, std::int32_t length, std::uint32_t timeout) const;
+
+	/**
+	 * Reads from the port's receive ring up to and including the next delimiter
+	 * byte, waiting up to timeout milliseconds for it to arrive.
+	 *
+	 * If length bytes arrive without a delimiter, those length bytes are
+	 * returned. If the timeout elapses first, nothing is removed from the ring.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EINVAL - The given value is not within the range of V5 ports (1-21), or
+	 * length is not positive.
+	 * ENOENT - The receive ring has not been started.
+	 * ETIMEDOUT - No delimiter arrived before the timeout elapsed.
+	 *
+	 * \param buffer
+	 *        The location to place the data read
+	 * \param length
+	 *        The maximum number of bytes to read
+	 * \param delimiter
+	 *        The byte that ends a message
+	 * \param timeout
+	 *        The longest time to wait in milliseconds
+	 *
+	 * \return The number of bytes read including the delimiter, or PROS_ERR if
+	 * the operation failed, setting errno.
+	 */
+	virtual std::int32_t read_until(std::uint8_t* buffer, std::int32_t length, std::uint8_t delimiter,
+	                                std::uint32_t timeout) const;
+
+	/**
+	 * Starts buffering received bytes in a receive ring that the system daemon
+	 * fills every 2 ms. See serial_rx_buffer_start() for details.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EINVAL - The given value is not within the range of V5 ports (1-21), buffer
+	 * is NULL, or capacity is less than 2.
+	 * EACCES - Another resource is currently trying to access the port.
+	 *
+	 * \param buffer
+	 *        Storage for the received bytes, which must stay valid until
+	 *        stop_rx_buffer() is called
+	 * \param capacity
+	 *        The size of buffer in bytes
+	 *
+	 * \return 1 if the operation was successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	virtual std::int32_t start_rx_buffer(std::uint8_t* buffer, std::uint32_t capacity) const;
+
+	/**
+	 * Stops buffering received bytes. Bytes that have not been read are
+	 * discarded.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EINVAL - The given value is not within the range of V5 ports (1-21).
+	 * EACCES - Another resource is currently trying to access the port.
+	 *
+	 * \return 1 if the operation was successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	virtual std::int32_t stop_rx_buffer() const;
+
 	/**
 	 * Write the given byte to the port's output buffer.
 	 *
@@ -221,6 +310,269 @@ class Serial {
 	const std::uint8_t _port;
 };
 
+/**
+ * Bytes that can be read in place, in at most two contiguous pieces.
+ *
+ * SerialParser reads through this interface so that it can be driven by
+ * something other than a port, such as a stand-in for benchmarking.
+ */
+class SerialSource {
+	public:
+	virtual ~SerialSource() = default;
+
+	/**
+	 * Gets the contiguous unread bytes starting offset bytes past the next
+	 * unread byte. The bytes must stay valid and writable until consumed.
+	 *
+	 * \param offset
+	 *        The number of unread bytes to skip
+	 * \param[out] data
+	 *        Set to the first byte
+	 *
+	 * \return The number of contiguous bytes at data, 0 if there are none, or
+	 * PROS_ERR if the operation failed, setting errno.
+	 */
+	virtual std::int32_t peek(std::size_t offset, std::uint8_t** data) = 0;
+
+	/**
+	 * Removes the next count unread bytes.
+	 *
+	 * \return 1 if the operation was successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	virtual std::int32_t consume(std::size_t count) = 0;
+
+	/**
+	 * Gets the most unread bytes the source can hold. Once that many are
+	 * waiting no more will arrive until some are consumed.
+	 *
+	 * \return The number of bytes, or 0 if there is no limit
+	 */
+	virtual std::size_t capacity();
+};
+
+/**
+ * The receive ring of a generic serial port, started with
+ * Serial::start_rx_buffer().
+ */
+class SerialRxSource : public SerialSource {
+	public:
+	explicit SerialRxSource(std::uint8_t port);
+	std::int32_t peek(std::size_t offset, std::uint8_t** data) override;
+	std::int32_t consume(std::size_t count) override;
+	std::size_t capacity() override;
+
+	private:
+	const std::uint8_t _port;
+};
+
+/**
+ * A complete frame handed out by a SerialParser.
+ *
+ * data points into the receive ring itself, so it is only valid until the next
+ * call to SerialParser::next() or SerialParser::release().
+ */
+struct SerialFrame {
+	std::uint8_t* data;
+	std::size_t size;
+};
+
+/**
+ * Splits the bytes in a receive ring into frames without copying them.
+ *
+ * Frames are left in the ring until the next frame is requested, so most are
+ * handed out as a pointer straight into the ring. A frame that wraps around the
+ * end of the ring is copied into a buffer of max_frame bytes owned by the
+ * parser. Malformed and oversized frames are skipped and counted by
+ * get_errors(), as is a partial frame that fills the whole ring, since the rest
+ * of it can never arrive.
+ *
+ * Only one parser should read from a source at a time.
+ */
+class SerialParser {
+	public:
+	virtual ~SerialParser() = default;
+	SerialParser(const SerialParser&) = delete;
+	SerialParser& operator=(const SerialParser&) = delete;
+
+	/**
+	 * Gets the next complete frame, releasing the previous one.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EINVAL - The port is not within the range of V5 ports (1-21).
+	 * ENOENT - The port's receive ring has not been started.
+	 *
+	 * \param[out] frame
+	 *        Set to the frame if there is one
+	 *
+	 * \return 1 if there was a frame, 0 if there is not yet a complete frame, or
+	 * PROS_ERR if the operation failed, setting errno.
+	 */
+	std::int32_t next(SerialFrame& frame);
+
+	/**
+	 * Gets the next complete frame, waiting up to timeout milliseconds for one
+	 * to arrive.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EINVAL - The port is not within the range of V5 ports (1-21).
+	 * ENOENT - The port's receive ring has not been started.
+	 *
+	 * \param[out] frame
+	 *        Set to the frame if there is one
+	 * \param timeout
+	 *        The longest time to wait in milliseconds
+	 *
+	 * \return 1 if there was a frame, 0 if the timeout elapsed, or PROS_ERR if
+	 * the operation failed, setting errno.
+	 */
+	std::int32_t next(SerialFrame& frame, std::uint32_t timeout);
+
+	/**
+	 * Removes the last frame from the ring, making room for more data. next()
+	 * does this automatically.
+	 *
+	 * \return 1 if the operation was successful or PROS_ERR if the operation
+	 * failed, setting errno.
+	 */
+	std::int32_t release();
+
+	/**
+	 * Gets the number of malformed or oversized frames that were skipped.
+	 *
+	 * \return The number of frames skipped
+	 */
+	std::uint32_t get_errors() const;
+
+	protected:
+	enum class Scan { need_more, skip, frame };
+
+	/**
+	 * Creates a parser reading from the receive ring of the given port.
+	 */
+	SerialParser(std::uint8_t port, std::size_t max_frame);
+
+	/**
+	 * Creates a parser reading from source, which must outlive the parser.
+	 */
+	SerialParser(SerialSource& source, std::size_t max_frame);
+
+	/**
+	 * Looks for a frame in the first available() unread bytes.
+	 *
+	 * Sets consume to the number of bytes to remove once the frame is released
+	 * or, for Scan::skip, immediately. For Scan::frame, start and length give
+	 * the frame's position within those bytes.
+	 */
+	virtual Scan scan(std::size_t& start, std::size_t& length, std::size_t& consume) = 0;
+
+	/**
+	 * Transforms a frame in place before it is handed out.
+	 *
+	 * \return The new length of the frame, or -1 to skip it as malformed
+	 */
+	virtual std::int32_t decode(std::uint8_t* data, std::size_t length);
+
+	std::size_t available() const;
+	std::uint8_t byte_at(std::size_t index) const;
+
+	// set when the source is full, so a frame that is not complete yet never
+	// will be and must be skipped
+	bool _full = false;
+
+	const std::size_t _max_frame;
+	// bytes already scanned since the last consume, so each is only scanned once
+	std::size_t _scanned = 0;
+	std::uint32_t _errors = 0;
+
+	private:
+	std::int32_t _refresh();
+	std::int32_t _consume(std::size_t count);
+
+	SerialRxSource _port_source;
+	SerialSource& _source;
+	std::unique_ptr<std::uint8_t[]> _scratch;
+	std::uint8_t* _piece[2] = {nullptr, nullptr};
+	std::size_t _piece_size[2] = {0, 0};
+	std::size_t _pending = 0;
+};
+
+/**
+ * Splits received bytes into frames ending in a delimiter byte, such as lines
+ * of text or NMEA sentences. The delimiter is not included in the frame.
+ */
+class SerialDelimitedParser : public SerialParser {
+	public:
+	/**
+	 * \param port
+	 *        The V5 port number from 1-21, with its receive ring started
+	 * \param max_frame
+	 *        The longest frame to accept, not including the delimiter
+	 * \param delimiter
+	 *        The byte that ends each frame
+	 */
+	SerialDelimitedParser(std::uint8_t port, std::size_t max_frame, std::uint8_t delimiter = '\n');
+	SerialDelimitedParser(SerialSource& source, std::size_t max_frame, std::uint8_t delimiter = '\n');
+
+	protected:
+	Scan scan(std::size_t& start, std::size_t& length, std::size_t& consume) override;
+
+	private:
+	const std::uint8_t _delimiter;
+	// set while skipping the rest of an oversized frame
+	bool _discarding = false;
+};
+
+/**
+ * Splits received bytes into zero delimited Consistent Overhead Byte Stuffing
+ * frames and decodes them in place.
+ */
+class SerialCobsParser : public SerialDelimitedParser {
+	public:
+	/**
+	 * \param port
+	 *        The V5 port number from 1-21, with its receive ring started
+	 * \param max_frame
+	 *        The longest encoded frame to accept, not including the delimiter
+	 */
+	SerialCobsParser(std::uint8_t port, std::size_t max_frame);
+	SerialCobsParser(SerialSource& source, std::size_t max_frame);
+
+	protected:
+	Scan scan(std::size_t& start, std::size_t& length, std::size_t& consume) override;
+	std::int32_t decode(std::uint8_t* data, std::size_t length) override;
+};
+
+/**
+ * Splits received bytes into frames that start with their length as a 1 or 2
+ * byte little endian header. The header is not included in the frame.
+ *
+ * There is no way to find the start of the next frame after a corrupted
+ * header, so a header longer than max_frame, or longer than the receive ring
+ * can hold, is skipped one byte at a time.
+ */
+class SerialLengthPrefixedParser : public SerialParser {
+	public:
+	/**
+	 * \param port
+	 *        The V5 port number from 1-21, with its receive ring started
+	 * \param max_frame
+	 *        The longest frame to accept, not including the header
+	 * \param header_size
+	 *        The size of the length header, 1 or 2 bytes
+	 */
+	SerialLengthPrefixedParser(std::uint8_t port, std::size_t max_frame, std::uint8_t header_size = 2);
+	SerialLengthPrefixedParser(SerialSource& source, std::size_t max_frame, std::uint8_t header_size = 2);
+
+	protected:
+	Scan scan(std::size_t& start, std::size_t& length, std::size_t& consume) override;
+
+	private:
+	const std::uint8_t _header_size;
+};
+
 namespace literals {
 const pros::Serial operator"" _ser(const unsigned long long int m);
 }  // namespace literals
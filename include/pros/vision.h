@@ -95,6 +95,37 @@ typedef enum vision_zero {
 	E_VISION_ZERO_CENTER = 1    // (0,0) coordinate is the center of the FOV
 } vision_zero_e_t;
 
+/**
+ * The most objects a vision snapshot can hold.
+ */
+#define VISION_SNAPSHOT_MAX_OBJECTS 16
+
+/**
+ * Bit for a signature id (1-7) in a vision_snapshot_filter() signature mask.
+ */
+#define VISION_SIG_MASK(sig_id) (1U << (sig_id))
+
+/**
+ * Bit in a vision_snapshot_filter() signature mask that matches all color codes.
+ */
+#define VISION_SIG_MASK_COLOR_CODES (1U << 8)
+
+/**
+ * A copy of every object the Vision Sensor reported in one frame, taken by
+ * vision_snapshot().
+ */
+typedef struct vision_snapshot_s {
+	// Identifies the sensor frame this snapshot was taken from
+	uint32_t frame;
+	// Number of valid entries in objects
+	uint32_t count;
+	// Objects in the order reported by the sensor, with coordinates already
+	// transformed for the sensor's zero point
+	vision_object_s_t objects[VISION_SNAPSHOT_MAX_OBJECTS];
+	// Indices into objects, ordered from largest to smallest area
+	uint8_t by_size[VISION_SNAPSHOT_MAX_OBJECTS];
+} vision_snapshot_s_t;
+
 #ifdef PROS_USE_SIMPLE_NAMES
 #ifdef __cplusplus
 #define VISION_OBJECT_NORMAL pros::E_VISION_OBJECT_NORMAL
@@ -404,6 +435,54 @@ int32_t vision_read_by_sig(uint8_t port, const uint32_t size_id, const uint32_t
 int32_t vision_read_by_code(uint8_t port, const uint32_t size_id, const vision_color_code_t color_code,
                             const uint32_t object_count, vision_object_s_t* const object_arr);
 
+/**
+ * Copies every object the Vision Sensor currently reports into a snapshot.
+ *
+ * The whole object list is read while holding the port once. If the sensor has
+ * not produced a new frame since snapshot was last filled, the snapshot is left
+ * as it is and 0 is returned, so tracking loops can skip frames they have
+ * already processed. Zero-initialize a snapshot before its first use.
+ *
+ * This function uses the following values of errno when an error state is
+ * reached:
+ * ENXIO - The given value is not within the range of V5 ports (1-21).
+ * ENODEV - The port cannot be configured as a vision sensor
+ * EACCES - Another resource is currently trying to access the port.
+ * EAGAIN - Reading the vision sensor failed for an unknown reason.
+ * EINVAL - snapshot is NULL.
+ *
+ * \param port
+ *        The V5 port number from 1-21
+ * \param[in,out] snapshot
+ *        The snapshot to fill
+ *
+ * \return 1 if the snapshot was filled from a new frame, 0 if the frame has
+ * not changed, or PROS_ERR if the operation failed, setting errno.
+ */
+int32_t vision_snapshot(uint8_t port, vision_snapshot_s_t* snapshot);
+
+/**
+ * Copies the objects in a snapshot whose signature is in sig_mask, largest
+ * first.
+ *
+ * This only reads the snapshot, so several signatures can be pulled out of one
+ * frame without touching the sensor again.
+ *
+ * \param snapshot
+ *        A snapshot filled by vision_snapshot()
+ * \param sig_mask
+ *        The signatures to keep, made by combining VISION_SIG_MASK(sig_id) and
+ *        VISION_SIG_MASK_COLOR_CODES with |
+ * \param[out] object_arr
+ *        Where to copy the matching objects
+ * \param object_count
+ *        The most objects to copy
+ *
+ * \return The number of objects copied
+ */
+uint32_t vision_snapshot_filter(const vision_snapshot_s_t* snapshot, uint32_t sig_mask,
+                                vision_object_s_t* const object_arr, uint32_t object_count);
+
 /**
  * Gets the object detection signature with the given id number.
  *
@@ -438,6 +438,30 @@ class Vision {
 	 */
 	std::int32_t set_wifi_mode(const std::uint8_t enable) const;
 
+	/**
+	 * Copies every object the Vision Sensor currently reports into a snapshot.
+	 *
+	 * The whole object list is read while holding the port once. If the sensor
+	 * has not produced a new frame since snapshot was last filled, the snapshot
+	 * is left as it is and 0 is returned. Zero-initialize a snapshot before its
+	 * first use. Use pros::c::vision_snapshot_filter() to pull objects for a set
+	 * of signatures out of a snapshot.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * ENODEV - The port cannot be configured as a vision sensor
+	 * EACCES - Another resource is currently trying to access the port.
+	 * EAGAIN - Reading the vision sensor failed for an unknown reason.
+	 * EINVAL - snapshot is NULL.
+	 *
+	 * \param[in,out] snapshot
+	 *        The snapshot to fill
+	 *
+	 * \return 1 if the snapshot was filled from a new frame, 0 if the frame has
+	 * not changed, or PROS_ERR if the operation failed, setting errno.
+	 */
+	std::int32_t snapshot(vision_snapshot_s_t* snapshot) const;
+
 	private:
 	std::uint8_t _port;
 };
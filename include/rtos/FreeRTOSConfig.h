@@ -208,6 +208,11 @@ some problems when it tries to unwind the stack, as the exit error function has
 nothing to return to.  To avoid this define configTASK_RETURN_ADDRESS to 0.  */
 #define configTASK_RETURN_ADDRESS   NULL
 
+/* Task switches are recorded by the crash flight recorder. See
+system/flight_recorder.c */
+void flight_recorder_task_switched( void );
+#define traceTASK_SWITCHED_IN() flight_recorder_task_switched()
+
 
 /****** Hardware specific settings. *******************************************/
 
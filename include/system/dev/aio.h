@@ -0,0 +1,18 @@
+/**
+ * \file system/dev/aio.h
+ *
+ * Asynchronous file I/O header
+ *
+ * See system/dev/aio.c for discussion
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+void aio_initialize(void);
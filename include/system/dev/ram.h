@@ -0,0 +1,29 @@
+/**
+ * \file system/dev/ram.h
+ *
+ * RAM file driver header
+ *
+ * See system/dev/ram_driver.c for discussion
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+#include "vfs.h"
+
+extern const struct fs_driver* const ram_driver;
+int ram_open_r(struct _reent* r, const char* path, int flags, int mode);
+int ram_unlink_r(struct _reent* r, const char* path);
+void ram_initialize(void);
+// Saves every file marked with RAMCTL_PERSIST when the program exits. Nothing
+// is saved if a RAM file operation holds the RAM mutex, since a task stopped
+// in the middle of one would never give it back. Returns false in that case.
+bool ram_save_persisted(void);
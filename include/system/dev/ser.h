@@ -20,3 +20,7 @@
 extern const struct fs_driver* const ser_driver;
 int ser_open_r(struct _reent* r, const char* path, int flags, int mode);
 void ser_initialize(void);
+
+// stdin bytes queued by the serial daemon, see system/dev/ser_daemon.c
+int32_t inp_buffer_read(uint32_t timeout);
+int32_t inp_buffer_available(void);
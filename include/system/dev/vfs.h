@@ -28,6 +28,18 @@ struct fs_driver {
 	int (*isatty_r)(struct _reent*, void* const);
 	off_t (*lseek_r)(struct _reent*, void* const, off_t, int);
 	int (*ctl)(void* const, const uint32_t, void* const);
+	// Returns which of the POLL* events are ready and adds the wait sources
+	// (see system/dev/wait.h) that signal a change to the last argument. May be
+	// NULL for files that are always ready, like regular files.
+	int (*poll_r)(struct _reent*, void* const, int, uint64_t*);
+};
+
+// A file system mounted at /<name>. open_r and unlink_r get the rest of the
+// path after the name, which is empty or starts with a '/'
+struct fs_mount {
+	const char* name;  // a single path component, without any '/'
+	int (*open_r)(struct _reent*, const char*, int, int);
+	int (*unlink_r)(struct _reent*, const char*);  // NULL if files can't be removed
 };
 
 struct file_entry {
@@ -42,3 +54,18 @@ int vfs_add_entry_r(struct _reent* r, struct fs_driver const* const driver, void
 // If driver is NULL, then the driver isn't updated. If arg is (void*)-1, then
 // the arg isn't updated.
 int vfs_update_entry(int file, struct fs_driver const* const driver, void* arg);
+
+// checks which of the POLL* events are ready on a file without blocking, and
+// adds the wait sources that signal a change to sources. Files without a
+// poll_r are always ready. Returns POLLNVAL if file is not open.
+int vfs_poll_r(struct _reent* r, int file, int events, uint64_t* sources);
+
+// mounts a file system so paths under /<name> are sent to it. The mount must
+// stay valid until it is unmounted. Returns -1 and sets errno to EINVAL for a
+// bad name, EEXIST if the name is already mounted, or ENOSPC if the mount table
+// is full.
+int vfs_mount(struct fs_mount const* const mount);
+
+// removes the file system mounted at /<name>. Files that are already open keep
+// working. Returns -1 and sets errno to ENOENT if nothing is mounted there.
+int vfs_unmount(const char* name);
@@ -0,0 +1,58 @@
+/**
+ * \file system/dev/wait.h
+ *
+ * I/O wait queue header
+ *
+ * See system/dev/wait.c for discussion
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "pros/misc.h"
+
+// Wake sources. Each is a bit in a 64 bit mask.
+#define WAIT_SERIAL_RX(port) (1ull << ((port)-1))                 // a generic serial port has bytes
+#define WAIT_SERIAL_TX(port) (1ull << (NUM_V5_PORTS + (port)-1))  // a generic serial port has space
+#define WAIT_SER_IN (1ull << (2 * NUM_V5_PORTS))                   // stdin has bytes
+#define WAIT_SER_OUT (1ull << (2 * NUM_V5_PORTS + 1))              // the serial output buffer has space
+#define WAIT_AIO_QUEUED (1ull << (2 * NUM_V5_PORTS + 2))           // a request was queued for the I/O worker
+#define WAIT_AIO_DONE (1ull << (2 * NUM_V5_PORTS + 3))             // an I/O request finished or was canceled
+
+typedef struct io_waiter io_waiter_t;
+
+// Claims a waiter slot watching the given sources. Returns NULL and sets errno
+// to EBUSY if every slot is taken. The caller must check whatever it is waiting
+// for after claiming, since wakeups before the claim are not remembered.
+io_waiter_t* io_waiter_claim(uint64_t sources);
+
+// Sleeps until one of the waiter's sources is woken or timeout milliseconds
+// pass. May return early, so callers must check again.
+void io_waiter_sleep(io_waiter_t* waiter, uint32_t timeout);
+
+void io_waiter_release(io_waiter_t* waiter);
+
+// Gets every source some waiter is watching, so a driver only needs to check
+// those
+uint64_t io_wait_sources(void);
+
+// Wakes every waiter watching one of the sources
+void io_wake(uint64_t sources);
+
+// Checks whatever a task is waiting for. May add the sources it depends on to
+// *sources. Returns nonzero once the wait is over.
+typedef int32_t (*io_check_fn_t)(void* arg, uint64_t* sources);
+
+// Calls check until it returns nonzero or timeout milliseconds pass, sleeping
+// on a waiter slot watching sources and whatever check adds between calls. If
+// every slot is taken, checks every millisecond instead. A timeout of
+// TIMEOUT_MAX waits forever. Returns the last result of check.
+int32_t io_wait_for(uint64_t sources, io_check_fn_t check, void* arg, uint32_t timeout);
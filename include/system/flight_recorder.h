@@ -0,0 +1,25 @@
+/**
+ * \file system/flight_recorder.h
+ *
+ * Kernel hooks into the crash flight recorder
+ *
+ * See system/flight_recorder.c for discussion
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// Records an event. type is a flight_event_type_e_t
+void flight_recorder_record(uint16_t type, uint16_t code, uint32_t value);
+
+// Writes the recorded events to the microSD card and the serial port. Only for
+// use once the system has crashed, with interrupts disabled
+void flight_recorder_dump(void);
@@ -0,0 +1,25 @@
+/**
+ * \file system/screen.h
+ *
+ * Kernel hooks into the screen driver
+ *
+ * See devices/screen.c for discussion
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "v5_api.h"
+
+// Forgets what text was printed, so the next print of any text draws it. Called
+// when something outside the screen API, like LVGL, draws on the screen
+void screen_text_cache_invalidate(void);
+
+// Gets the latest touch sample taken by the screen touch task
+void screen_touch_sample_get(V5_TouchStatus* status);
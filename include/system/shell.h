@@ -0,0 +1,30 @@
+/**
+ * \file system/shell.h
+ *
+ * Kernel hooks into the serial command shell
+ *
+ * See system/shell.c for discussion
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+// Creates the shell task and registers the built-in commands
+void shell_initialize(void);
+
+// Queues a NUL terminated command line, at most SHELL_LINE_MAX bytes including
+// the terminator, to be run by the shell task. Returns false if the queue is
+// full. Does not block
+bool shell_post_line(const char* line);
+
+// Built-in commands that need the RTOS internals, in system/shell_stats.c
+int shell_tasks_command(int argc, char** argv);
+int shell_heap_command(int argc, char** argv);
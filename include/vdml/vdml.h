@@ -231,6 +231,17 @@ int internal_port_mutex_take(uint8_t port);
  */
 int internal_port_mutex_give(uint8_t port);
 
+/**
+ * Background processing for each kind of device, run by
+ * vdml_background_processing() every 2 milliseconds.
+ */
+void controller_background_processing(void);
+void imu_background_processing(void);
+void optical_background_processing(void);
+void rotation_background_processing(void);
+void pose_background_processing(void);
+void serial_background_processing(void);
+
 #define V5_PORT_BATTERY 24
 #define V5_PORT_CONTROLLER_1 25
 #define V5_PORT_CONTROLLER_2 26
@@ -97,3 +97,28 @@ int cobs_encode(uint8_t* restrict dest, const uint8_t* restrict src, const size_
 
 	return write_idx;
 }
+
+int cobs_decode(uint8_t* dest, const uint8_t* src, const size_t src_len) {
+	size_t read_idx = 0;
+	size_t write_idx = 0;
+
+	while (read_idx < src_len) {
+		uint8_t code = src[read_idx];
+		if (code == 0 || read_idx + code > src_len) {
+			return -1;
+		}
+		read_idx++;
+		for (uint8_t i = 1; i < code; i++) {
+			if (src[read_idx] == 0) {
+				return -1;
+			}
+			dest[write_idx++] = src[read_idx++];
+		}
+		// every block but a full one ends in a zero, except the last
+		if (code != 0xff && read_idx != src_len) {
+			dest[write_idx++] = 0;
+		}
+	}
+
+	return write_idx;
+}
@@ -6,6 +6,11 @@
  * Contains an implementation to efficiently assign globally unique IDs
  * e.g. to assign entries in a global table
  *
+ * The bitmap is only ever changed with atomic operations, so allocating,
+ * freeing, and checking IDs never takes a lock. A set bit is a free ID.
+ * Allocation claims a bit with a compare-and-swap and tries again if another
+ * task changed the word first.
+ *
  * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
  * All rights reserved.
  *
@@ -18,7 +23,6 @@
 #include <stdint.h>
 
 #include "common/gid.h"
-#include "kapi.h"
 
 // Note: the V5 is a 32-bit architecture, so we'll use 32-bit integers
 
@@ -30,66 +34,59 @@ void gid_init(struct gid_metadata* const metadata) {
 		metadata->bitmap[i] = ~0;
 	}
 
-	metadata->bitmap[0] = (~0 << (metadata->reserved));
+	metadata->bitmap[0] &= metadata->reserved < UINT32_WIDTH ? (~0u << metadata->reserved) : 0;
+	// the end of the last word is past max, so it can never be handed out
+	if (metadata->max % UINT32_WIDTH) {
+		metadata->bitmap[metadata->bitmap_size - 1] &= (1u << (metadata->max % UINT32_WIDTH)) - 1;
+	}
 
-	metadata->_lock = mutex_create();
+	metadata->_cur_val = 0;
 	return;
 }
 
 uint32_t gid_alloc(struct gid_metadata* const metadata) {
-	if (mutex_take(metadata->_lock, TIMEOUT_MAX)) {
-		size_t i;
-		uint32_t gid = 0;
-		uint32_t* gid_word = NULL;
-		uint32_t gid_idx = 0;
-		// check if the _cur_val + 1 is free
-		if (!gid_check(metadata, (metadata->_cur_val + 1) % metadata->max)) {
-			// that gid was free! so allocate it
-			gid = metadata->_cur_val = (metadata->_cur_val + 1) % metadata->max;
-			gid_word = metadata->bitmap + (gid / UINT32_WIDTH);
-			gid_idx = gid % UINT32_WIDTH;
-			goto return_gid;
-		} else {
-			for (i = 0; i < metadata->bitmap_size; i++) {
-				gid_word = metadata->bitmap + i;
-				if (*gid_word == 0) {  // all GIDs in this word are assigned
-					continue;
-				}
-				// __builtin_ctz counts trailing zeros. This effectively returns the
-				// position of the first unassigned gid withing the word
-				gid_idx = __builtin_ctz(*gid_word);
-				gid = gid_idx + (i * UINT32_WIDTH);
-				// mark the id as allocated
-				goto return_gid;
+	// start after the last gid handed out so gids get delegated linearly
+	uint32_t start = (__atomic_load_n(&metadata->_cur_val, __ATOMIC_RELAXED) + 1) % metadata->max;
+	size_t first_word = start / UINT32_WIDTH;
+	size_t i;
+	// the first word is visited twice: once from start, and at the end for the
+	// gids before start
+	for (i = 0; i <= metadata->bitmap_size; i++) {
+		size_t word_idx = (first_word + i) % metadata->bitmap_size;
+		uint32_t* gid_word = metadata->bitmap + word_idx;
+		uint32_t mask = i == 0 ? ~0u << (start % UINT32_WIDTH) : ~0u;
+		uint32_t word = __atomic_load_n(gid_word, __ATOMIC_RELAXED);
+		while (word & mask) {
+			// __builtin_ctz counts trailing zeros. This effectively returns the
+			// position of the first unassigned gid within the word
+			uint32_t gid_idx = __builtin_ctz(word & mask);
+			// on failure, word is reloaded with the current value and we try again
+			if (__atomic_compare_exchange_n(gid_word, &word, word & ~(1u << gid_idx), false, __ATOMIC_ACQUIRE,
+			                                __ATOMIC_RELAXED)) {
+				uint32_t gid = gid_idx + (word_idx * UINT32_WIDTH);
+				__atomic_store_n(&metadata->_cur_val, gid, __ATOMIC_RELAXED);
+				return gid;
 			}
 		}
-	return_gid:
-		if (gid > metadata->max || gid == 0) {
-			mutex_give(metadata->_lock);
-			return 0;
-		}
-		*gid_word &= ~(1 << gid_idx);
-		metadata->_cur_val = gid;
-		mutex_give(metadata->_lock);
-		return gid;
 	}
 	return 0;
 }
 
 void gid_free(struct gid_metadata* const metadata, uint32_t id) {
-	if (id > metadata->max || id == 0) {
+	if (id >= metadata->max || id == 0) {
 		return;
 	}
 
 	size_t word_idx = id / UINT32_WIDTH;
-	metadata->bitmap[word_idx] |= 1 << (id % UINT32_WIDTH);
+	__atomic_fetch_or(metadata->bitmap + word_idx, 1u << (id % UINT32_WIDTH), __ATOMIC_RELEASE);
 }
 
 bool gid_check(struct gid_metadata* metadata, uint32_t id) {
-	if (id > metadata->max) {
+	if (id >= metadata->max) {
 		return false;
 	}
 
 	size_t word_idx = id / UINT32_WIDTH;
-	return (metadata->bitmap[word_idx] & (1 << (id % UINT32_WIDTH))) ? false : true;
+	uint32_t word = __atomic_load_n(metadata->bitmap + word_idx, __ATOMIC_ACQUIRE);
+	return (word & (1u << (id % UINT32_WIDTH))) ? false : true;
 }
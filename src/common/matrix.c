@@ -0,0 +1,98 @@
+/**
+ * \file common/matrix.c
+ *
+ * Fixed-size 3x3 matrix operations
+ *
+ * These are used by the kernel's pose estimator. Everything works on fixed-size
+ * structures passed by pointer so there is no heap use, and each operation
+ * computes into a temporary first so that outputs may alias inputs.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "common/matrix.h"
+
+#include <math.h>
+
+void mat3_identity(mat3_s_t* out) {
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			out->m[i][j] = i == j ? 1.0 : 0.0;
+		}
+	}
+}
+
+void mat3_add(mat3_s_t* out, const mat3_s_t* a, const mat3_s_t* b) {
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			out->m[i][j] = a->m[i][j] + b->m[i][j];
+		}
+	}
+}
+
+void mat3_sub(mat3_s_t* out, const mat3_s_t* a, const mat3_s_t* b) {
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			out->m[i][j] = a->m[i][j] - b->m[i][j];
+		}
+	}
+}
+
+void mat3_mul(mat3_s_t* out, const mat3_s_t* a, const mat3_s_t* b) {
+	mat3_s_t tmp;
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			tmp.m[i][j] = a->m[i][0] * b->m[0][j] + a->m[i][1] * b->m[1][j] + a->m[i][2] * b->m[2][j];
+		}
+	}
+	*out = tmp;
+}
+
+void mat3_mul_transpose(mat3_s_t* out, const mat3_s_t* a, const mat3_s_t* b) {
+	mat3_s_t tmp;
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			tmp.m[i][j] = a->m[i][0] * b->m[j][0] + a->m[i][1] * b->m[j][1] + a->m[i][2] * b->m[j][2];
+		}
+	}
+	*out = tmp;
+}
+
+void mat3_mul_vec(double out[3], const mat3_s_t* a, const double v[3]) {
+	double tmp[3];
+	for (int i = 0; i < 3; i++) {
+		tmp[i] = a->m[i][0] * v[0] + a->m[i][1] * v[1] + a->m[i][2] * v[2];
+	}
+	out[0] = tmp[0];
+	out[1] = tmp[1];
+	out[2] = tmp[2];
+}
+
+bool mat3_inverse(mat3_s_t* out, const mat3_s_t* a) {
+	const double(*m)[3] = a->m;
+	mat3_s_t cof;
+	cof.m[0][0] = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+	cof.m[0][1] = m[0][2] * m[2][1] - m[0][1] * m[2][2];
+	cof.m[0][2] = m[0][1] * m[1][2] - m[0][2] * m[1][1];
+	cof.m[1][0] = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+	cof.m[1][1] = m[0][0] * m[2][2] - m[0][2] * m[2][0];
+	cof.m[1][2] = m[0][2] * m[1][0] - m[0][0] * m[1][2];
+	cof.m[2][0] = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+	cof.m[2][1] = m[0][1] * m[2][0] - m[0][0] * m[2][1];
+	cof.m[2][2] = m[0][0] * m[1][1] - m[0][1] * m[1][0];
+	double det = m[0][0] * cof.m[0][0] + m[0][1] * cof.m[1][0] + m[0][2] * cof.m[2][0];
+	if (fabs(det) < 1e-12) {
+		return false;
+	}
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			out->m[i][j] = cof.m[i][j] / det;
+		}
+	}
+	return true;
+}
@@ -27,6 +27,30 @@ typedef struct controller_data {
 	bool button_pressed[NUM_BUTTONS];
 } controller_data_s_t;
 
+// The controller drops text updates sent faster than this, in milliseconds
+#define CONTROLLER_TEXT_PERIOD 50
+#define CONTROLLER_LINES 3
+#define CONTROLLER_RUMBLE_QUEUE 4
+#define CONTROLLER_MAX_RUMBLE 8
+
+// Text framebuffer for a controller. Writes only change text, and
+// controller_background_processing sends the changed part of one line, or one
+// queued rumble, whenever the controller can accept another update. Protected
+// by the controller's port mutex.
+typedef struct controller_fb {
+	bool active;
+	char text[CONTROLLER_LINES][CONTROLLER_MAX_COLS];
+	char sent[CONTROLLER_LINES][CONTROLLER_MAX_COLS];
+	bool sent_valid[CONTROLLER_LINES];
+	char rumble[CONTROLLER_RUMBLE_QUEUE][CONTROLLER_MAX_RUMBLE + 1];
+	uint8_t rumble_head;
+	uint8_t rumble_count;
+	uint8_t next_line;
+	uint32_t last_send;
+} controller_fb_s_t;
+
+static controller_fb_s_t _controller_fb[2];
+
 bool get_button_pressed(int port, int button) {
 	return ((controller_data_s_t*)registry_get_device_internal(port)->pad)->button_pressed[button];
 }
@@ -107,10 +131,12 @@ int32_t controller_set_text(controller_id_e_t id, uint8_t line, uint8_t col, con
 	else
 		col++;
 
-	char* buf = strndup(str, CONTROLLER_MAX_COLS + 1);
+	char buf[CONTROLLER_MAX_COLS + 1];
+	strncpy(buf, str, CONTROLLER_MAX_COLS);
+	buf[CONTROLLER_MAX_COLS] = '\0';
 
 	uint32_t rtn_val = vexControllerTextSet(id, line, col, buf);
-	free(buf);
+	_controller_fb[id].last_send = millis();
 	internal_port_mutex_give(port);
 
 	if (!rtn_val) {
@@ -131,11 +157,11 @@ int32_t controller_print(controller_id_e_t id, uint8_t line, uint8_t col, const
 
 	va_list args;
 	va_start(args, fmt);
-	char* buf = (char*)malloc(CONTROLLER_MAX_COLS + 1);
+	char buf[CONTROLLER_MAX_COLS + 1];
 	vsnprintf(buf, CONTROLLER_MAX_COLS + 1, fmt, args);
 
 	uint32_t rtn_val = vexControllerTextSet(id, line, col, buf);
-	free(buf);
+	_controller_fb[id].last_send = millis();
 	va_end(args);
 
 	internal_port_mutex_give(port);
@@ -180,6 +206,138 @@ int32_t controller_rumble(controller_id_e_t id, const char* rumble_pattern) {
 	return controller_set_text(id, 3, 0, rumble_pattern);
 }
 
+static void _controller_fb_activate(controller_fb_s_t* fb) {
+	if (!fb->active) {
+		memset(fb->text, ' ', sizeof(fb->text));
+		memset(fb->sent_valid, 0, sizeof(fb->sent_valid));
+		fb->active = true;
+	}
+}
+
+int32_t controller_fb_set_text(controller_id_e_t id, uint8_t line, uint8_t col, const char* str) {
+	uint8_t port;
+	CONTROLLER_PORT_MUTEX_TAKE(id, port)
+	if (line >= CONTROLLER_LINES || col >= CONTROLLER_MAX_COLS) {
+		internal_port_mutex_give(port);
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	controller_fb_s_t* fb = &_controller_fb[id];
+	_controller_fb_activate(fb);
+	for (; col < CONTROLLER_MAX_COLS && *str; col++, str++) {
+		fb->text[line][col] = *str;
+	}
+	internal_port_mutex_give(port);
+	return 1;
+}
+
+int32_t controller_fb_print(controller_id_e_t id, uint8_t line, uint8_t col, const char* fmt, ...) {
+	char buf[CONTROLLER_MAX_COLS + 1];
+	va_list args;
+	va_start(args, fmt);
+	vsnprintf(buf, CONTROLLER_MAX_COLS + 1, fmt, args);
+	va_end(args);
+	return controller_fb_set_text(id, line, col, buf);
+}
+
+int32_t controller_fb_clear_line(controller_id_e_t id, uint8_t line) {
+	uint8_t port;
+	CONTROLLER_PORT_MUTEX_TAKE(id, port)
+	if (line >= CONTROLLER_LINES) {
+		internal_port_mutex_give(port);
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	controller_fb_s_t* fb = &_controller_fb[id];
+	_controller_fb_activate(fb);
+	memset(fb->text[line], ' ', CONTROLLER_MAX_COLS);
+	internal_port_mutex_give(port);
+	return 1;
+}
+
+int32_t controller_fb_clear(controller_id_e_t id) {
+	uint8_t port;
+	CONTROLLER_PORT_MUTEX_TAKE(id, port)
+	controller_fb_s_t* fb = &_controller_fb[id];
+	_controller_fb_activate(fb);
+	memset(fb->text, ' ', sizeof(fb->text));
+	internal_port_mutex_give(port);
+	return 1;
+}
+
+int32_t controller_fb_rumble(controller_id_e_t id, const char* rumble_pattern) {
+	uint8_t port;
+	CONTROLLER_PORT_MUTEX_TAKE(id, port)
+	controller_fb_s_t* fb = &_controller_fb[id];
+	if (fb->rumble_count >= CONTROLLER_RUMBLE_QUEUE) {
+		internal_port_mutex_give(port);
+		errno = EAGAIN;
+		return PROS_ERR;
+	}
+	char* slot = fb->rumble[(fb->rumble_head + fb->rumble_count) % CONTROLLER_RUMBLE_QUEUE];
+	strncpy(slot, rumble_pattern, CONTROLLER_MAX_RUMBLE);
+	slot[CONTROLLER_MAX_RUMBLE] = '\0';
+	fb->rumble_count++;
+	internal_port_mutex_give(port);
+	return 1;
+}
+
+// Sends at most one pending update for the controller. Returns true if the
+// controller accepted an update.
+static bool _controller_fb_send(controller_id_e_t id, controller_fb_s_t* fb) {
+	if (fb->rumble_count) {
+		if (!vexControllerTextSet(id, 4, 1, fb->rumble[fb->rumble_head])) return false;
+		fb->rumble_head = (fb->rumble_head + 1) % CONTROLLER_RUMBLE_QUEUE;
+		fb->rumble_count--;
+		return true;
+	}
+	if (!fb->active) return false;
+	for (uint8_t i = 0; i < CONTROLLER_LINES; i++) {
+		uint8_t line = (fb->next_line + i) % CONTROLLER_LINES;
+		const char* text = fb->text[line];
+		const char* sent = fb->sent[line];
+		int first = 0;
+		if (fb->sent_valid[line]) {
+			while (first < CONTROLLER_MAX_COLS && text[first] == sent[first]) first++;
+			if (first == CONTROLLER_MAX_COLS) continue;
+		}
+		// Send from the first changed column to the end of whichever of the old
+		// and new text is longer, since setting text may clear the rest of the
+		// line on some firmware
+		int end = CONTROLLER_MAX_COLS;
+		while (end > first && text[end - 1] == ' ' && (!fb->sent_valid[line] || sent[end - 1] == ' ')) end--;
+		char buf[CONTROLLER_MAX_COLS + 1];
+		memcpy(buf, text + first, end - first);
+		buf[end - first] = '\0';
+		if (end == first && vexSystemVersion() < 0x1000C38) {
+			// older firmware needs spaces to clear
+			memset(buf, ' ', CONTROLLER_MAX_COLS - first);
+			buf[CONTROLLER_MAX_COLS - first] = '\0';
+		}
+		if (!vexControllerTextSet(id, line + 1, first + 1, buf)) return false;
+		memcpy(fb->sent[line], text, CONTROLLER_MAX_COLS);
+		fb->sent_valid[line] = true;
+		fb->next_line = (line + 1) % CONTROLLER_LINES;
+		return true;
+	}
+	return false;
+}
+
+void controller_background_processing() {
+	uint32_t now = millis();
+	for (int id = E_CONTROLLER_MASTER; id <= E_CONTROLLER_PARTNER; id++) {
+		controller_fb_s_t* fb = &_controller_fb[id];
+		if (!fb->active && !fb->rumble_count) continue;
+		if (!vexControllerConnectionStatusGet(id)) {
+			// resend everything when the controller comes back
+			memset(fb->sent_valid, 0, sizeof(fb->sent_valid));
+			continue;
+		}
+		if (now - fb->last_send < CONTROLLER_TEXT_PERIOD) continue;
+		if (_controller_fb_send(id, fb)) fb->last_send = now;
+	}
+}
+
 uint8_t competition_get_status(void) {
 	return vexCompetitionStatus();
 }
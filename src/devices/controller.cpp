@@ -63,6 +63,22 @@ std::int32_t Controller::rumble(const char* rumble_pattern) {
 	return controller_rumble(_id, rumble_pattern);
 }
 
+std::int32_t Controller::fb_set_text(std::uint8_t line, std::uint8_t col, const std::string& str) {
+	return controller_fb_set_text(_id, line, col, str.c_str());
+}
+
+std::int32_t Controller::fb_clear_line(std::uint8_t line) {
+	return controller_fb_clear_line(_id, line);
+}
+
+std::int32_t Controller::fb_clear(void) {
+	return controller_fb_clear(_id);
+}
+
+std::int32_t Controller::fb_rumble(const char* rumble_pattern) {
+	return controller_fb_rumble(_id, rumble_pattern);
+}
+
 namespace competition {
 std::uint8_t get_status(void) {
 	return competition_get_status();
@@ -0,0 +1,298 @@
+/**
+ * \file devices/pose.c
+ *
+ * Kernel pose estimator
+ *
+ * An extended Kalman filter over (x, y, heading). Tracking wheel distances and
+ * IMU rotation drive the prediction step, and GPS readings are applied as
+ * direct measurements of the full state. pose_background_processing() is run
+ * by VDML background processing with every port mutex held, so sensors are
+ * read directly and only when they report a new packet.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <math.h>
+#include <string.h>
+
+#include "common/matrix.h"
+#include "kapi.h"
+#include "pros/imu.h"
+#include "pros/pose.h"
+#include "v5_api.h"
+#include "vdml/registry.h"
+#include "vdml/vdml.h"
+
+#define DEGTORAD (M_PI / 180)
+
+// Variance added to the heading every step so the filter never becomes
+// overconfident while sitting still
+#define POSE_MIN_HEADING_NOISE 1e-6
+
+typedef struct pose_state {
+	double x[3];  // x, y, heading in degrees
+	mat3_s_t P;
+	uint32_t timestamp;
+	// last raw sensor readings, used to compute deltas
+	bool have_last;
+	double last_rotation;
+	double last_forward;
+	double last_lateral;
+	uint32_t last_imu_timestamp;
+	uint32_t last_forward_timestamp;
+	uint32_t last_lateral_timestamp;
+	uint32_t last_gps_timestamp;
+} pose_state_s_t;
+
+static pose_config_s_t _pose_config;
+static pose_state_s_t _pose_state;
+static volatile bool _pose_running = false;
+static volatile bool _pose_replay = false;
+
+// Published estimate. Writers bump the sequence number to an odd value before
+// writing and back to an even value after, and readers retry if it changed.
+static volatile uint32_t _pose_seq = 0;
+static pose_s_t _pose_published;
+
+static pose_input_s_t* volatile _pose_record_buffer = NULL;
+static uint32_t _pose_record_capacity = 0;
+static volatile uint32_t _pose_record_count = 0;
+
+static double _wrap_degrees(double angle) {
+	angle = fmod(angle, 360.0);
+	if (angle > 180.0) angle -= 360.0;
+	if (angle <= -180.0) angle += 360.0;
+	return angle;
+}
+
+// Copies the state out for pose_get(). Anything but the system daemon must
+// suspend the scheduler around this, since a higher priority reader would
+// otherwise spin on a publish it preempted halfway.
+static void _pose_publish(void) {
+	_pose_seq++;
+	__sync_synchronize();
+	_pose_published.timestamp = _pose_state.timestamp;
+	_pose_published.x = _pose_state.x[0];
+	_pose_published.y = _pose_state.x[1];
+	_pose_published.heading = fmod(_pose_state.x[2] + 360.0, 360.0);
+	memcpy(_pose_published.covariance, _pose_state.P.m, sizeof(_pose_published.covariance));
+	__sync_synchronize();
+	_pose_seq++;
+}
+
+static void _pose_predict(double forward, double lateral, double rotation) {
+	pose_config_s_t* cfg = &_pose_config;
+	pose_state_s_t* s = &_pose_state;
+	double d_heading = rotation;
+	// remove the motion of the wheels caused by turning about the tracking center
+	double d_forward = forward + cfg->forward_offset * d_heading * DEGTORAD;
+	double d_lateral = lateral - cfg->lateral_offset * d_heading * DEGTORAD;
+
+	// integrate along the average heading over the step
+	double mid = (s->x[2] + d_heading / 2) * DEGTORAD;
+	double sin_mid = sin(mid);
+	double cos_mid = cos(mid);
+	s->x[0] += sin_mid * d_forward + cos_mid * d_lateral;
+	s->x[1] += cos_mid * d_forward - sin_mid * d_lateral;
+	s->x[2] = _wrap_degrees(s->x[2] + d_heading);
+
+	mat3_s_t F;
+	mat3_identity(&F);
+	F.m[0][2] = (cos_mid * d_forward - sin_mid * d_lateral) * DEGTORAD;
+	F.m[1][2] = (-sin_mid * d_forward - cos_mid * d_lateral) * DEGTORAD;
+
+	double dist = fabs(d_forward) + fabs(d_lateral);
+	mat3_s_t Q = {{{0}}};
+	Q.m[0][0] = cfg->odom_noise * dist;
+	Q.m[1][1] = cfg->odom_noise * dist;
+	Q.m[2][2] = cfg->heading_noise * fabs(d_heading) + POSE_MIN_HEADING_NOISE;
+
+	// P = F P F^T + Q
+	mat3_mul(&s->P, &F, &s->P);
+	mat3_mul_transpose(&s->P, &s->P, &F);
+	mat3_add(&s->P, &s->P, &Q);
+}
+
+static void _pose_correct(double x, double y, double heading, double error) {
+	pose_state_s_t* s = &_pose_state;
+	mat3_s_t R = {{{0}}};
+	R.m[0][0] = error * error;
+	R.m[1][1] = error * error;
+	R.m[2][2] = _pose_config.gps_heading_noise * _pose_config.gps_heading_noise;
+
+	// K = P (P + R)^-1, since the measurement matrix is the identity
+	mat3_s_t S, K;
+	mat3_add(&S, &s->P, &R);
+	if (!mat3_inverse(&S, &S)) return;
+	mat3_mul(&K, &s->P, &S);
+
+	double residual[3] = {x - s->x[0], y - s->x[1], _wrap_degrees(heading - s->x[2])};
+	double correction[3];
+	mat3_mul_vec(correction, &K, residual);
+	s->x[0] += correction[0];
+	s->x[1] += correction[1];
+	s->x[2] = _wrap_degrees(s->x[2] + correction[2]);
+
+	// P = (I - K) P
+	mat3_s_t I_K;
+	mat3_identity(&I_K);
+	mat3_sub(&I_K, &I_K, &K);
+	mat3_mul(&s->P, &I_K, &s->P);
+}
+
+// Applies one input to the filter. Inputs hold absolute sensor readings, so
+// the first one only establishes a reference.
+static void _pose_step(const pose_input_s_t* input) {
+	pose_state_s_t* s = &_pose_state;
+	if (s->have_last) {
+		_pose_predict(input->forward - s->last_forward, input->lateral - s->last_lateral,
+		              input->rotation - s->last_rotation);
+	}
+	s->have_last = true;
+	s->last_forward = input->forward;
+	s->last_lateral = input->lateral;
+	s->last_rotation = input->rotation;
+	if (input->gps_valid) {
+		_pose_correct(input->gps_x, input->gps_y, input->gps_heading, input->gps_error);
+	}
+	s->timestamp = input->timestamp;
+	_pose_publish();
+}
+
+static bool _validate_pose_port(uint8_t port) {
+	return port == 0 || VALIDATE_PORT_NO(port - 1);
+}
+
+int32_t pose_estimator_start(const pose_config_s_t* config, double x, double y, double heading) {
+	if (config == NULL || !_validate_pose_port(config->imu_port) || !_validate_pose_port(config->gps_port) ||
+	    !_validate_pose_port(config->forward_port) || !_validate_pose_port(config->lateral_port) ||
+	    ((config->forward_port || config->lateral_port) && config->wheel_diameter <= 0)) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	// the system daemon leaves the state alone while stopped
+	_pose_running = false;
+	_pose_config = *config;
+	memset(&_pose_state, 0, sizeof(_pose_state));
+	_pose_state.x[0] = x;
+	_pose_state.x[1] = y;
+	_pose_state.x[2] = _wrap_degrees(heading);
+	_pose_state.timestamp = millis();
+	rtos_suspend_all();
+	_pose_publish();
+	rtos_resume_all();
+	_pose_replay = !config->imu_port && !config->gps_port && !config->forward_port && !config->lateral_port;
+	_pose_running = true;
+	return 1;
+}
+
+int32_t pose_estimator_stop(void) {
+	_pose_running = false;
+	return 1;
+}
+
+pose_s_t pose_get(void) {
+	pose_s_t rtn;
+	uint32_t seq;
+	do {
+		seq = _pose_seq;
+		__sync_synchronize();
+		rtn = _pose_published;
+		__sync_synchronize();
+	} while ((seq & 1) || seq != _pose_seq);
+	return rtn;
+}
+
+int32_t pose_estimator_feed(const pose_input_s_t* input) {
+	if (input == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	if (!_pose_running || !_pose_replay) {
+		errno = EPERM;
+		return PROS_ERR;
+	}
+	// _pose_step publishes, see _pose_publish
+	rtos_suspend_all();
+	_pose_step(input);
+	rtos_resume_all();
+	return 1;
+}
+
+int32_t pose_estimator_record(pose_input_s_t* buffer, uint32_t capacity) {
+	_pose_record_buffer = NULL;
+	_pose_record_capacity = capacity;
+	_pose_record_count = 0;
+	_pose_record_buffer = buffer;
+	return 1;
+}
+
+uint32_t pose_estimator_record_count(void) {
+	return _pose_record_count;
+}
+
+// Returns the device on a configured port if the expected sensor is plugged in
+static V5_DeviceT _pose_device(uint8_t port, v5_device_e_t type) {
+	if (port == 0 || registry_get_plugged_type(port - 1) != type) return NULL;
+	return registry_get_device_internal(port - 1)->device_info;
+}
+
+void pose_background_processing() {
+	if (!_pose_running || _pose_replay) return;
+	pose_config_s_t* cfg = &_pose_config;
+	pose_state_s_t* s = &_pose_state;
+
+	V5_DeviceT imu = _pose_device(cfg->imu_port, E_DEVICE_IMU);
+	V5_DeviceT gps = _pose_device(cfg->gps_port, E_DEVICE_GPS);
+	V5_DeviceT forward = _pose_device(cfg->forward_port, E_DEVICE_ROTATION);
+	V5_DeviceT lateral = _pose_device(cfg->lateral_port, E_DEVICE_ROTATION);
+	// a configured sensor that is missing would look like it stopped moving
+	if ((cfg->imu_port && !imu) || (cfg->forward_port && !forward) || (cfg->lateral_port && !lateral)) return;
+	if (imu && (vexDeviceImuStatusGet(imu) & E_IMU_STATUS_CALIBRATING)) return;
+
+	// only step when a sensor produced a new packet
+	uint32_t imu_timestamp = imu ? vexDeviceGetTimestamp(imu) : 0;
+	uint32_t forward_timestamp = forward ? vexDeviceGetTimestamp(forward) : 0;
+	uint32_t lateral_timestamp = lateral ? vexDeviceGetTimestamp(lateral) : 0;
+	uint32_t gps_timestamp = gps ? vexDeviceGetTimestamp(gps) : 0;
+	bool new_gps = gps && gps_timestamp != s->last_gps_timestamp;
+	if (!new_gps && imu_timestamp == s->last_imu_timestamp && forward_timestamp == s->last_forward_timestamp &&
+	    lateral_timestamp == s->last_lateral_timestamp) {
+		return;
+	}
+	s->last_imu_timestamp = imu_timestamp;
+	s->last_forward_timestamp = forward_timestamp;
+	s->last_lateral_timestamp = lateral_timestamp;
+	s->last_gps_timestamp = gps_timestamp;
+
+	double meters_per_centidegree = M_PI * cfg->wheel_diameter / 36000.0;
+	pose_input_s_t input = {0};
+	input.timestamp = millis();
+	input.rotation = imu ? vexDeviceImuHeadingGet(imu) : 0;
+	input.forward = forward ? vexDeviceAbsEncPositionGet(forward) * meters_per_centidegree : 0;
+	input.lateral = lateral ? vexDeviceAbsEncPositionGet(lateral) * meters_per_centidegree : 0;
+	if (new_gps) {
+		input.gps_error = vexDeviceGpsErrorGet(gps);
+		if (input.gps_error <= cfg->gps_max_error) {
+			V5_DeviceGpsAttitude attitude;
+			vexDeviceGpsAttitudeGet(gps, &attitude, false);
+			input.gps_valid = true;
+			input.gps_x = attitude.position_x;
+			input.gps_y = attitude.position_y;
+			input.gps_heading = vexDeviceGpsDegreesGet(gps);
+		}
+	}
+
+	pose_input_s_t* record = _pose_record_buffer;
+	if (record && _pose_record_count < _pose_record_capacity) {
+		record[_pose_record_count] = input;
+		_pose_record_count++;
+	}
+
+	_pose_step(&input);
+}
@@ -60,7 +60,8 @@ int registry_bind_port(uint8_t port, v5_device_e_t device_type) {
 		return PROS_ERR;
 	}
 	kprintf("[VDML][INFO]Registering device in port %d\n", port + 1);
-	v5_smart_device_s_t device;
+	// start with a clean pad so per-device state from a previous binding is gone
+	v5_smart_device_s_t device = {0};
 	device.device_type = device_type;
 	device.device_info = vexDeviceGetByIndex(port);
 	registry[port] = device;
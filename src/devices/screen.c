@@ -16,11 +16,13 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/_stdint.h>
 
 #include "common/linkedlist.h"
 #include "kapi.h"
 #include "pros/apix.h"
+#include "system/screen.h"
 #include "v5_api.h"  // vexDisplay* 
 
 /******************************************************************************/
@@ -30,6 +32,9 @@
 /******************************************************************************/
 
 static mutex_t _screen_mutex = NULL;
+// Bumped by every drawing operation that is not a text print. Cached text is
+// only trusted if nothing else has been drawn since it was printed.
+static volatile uint32_t _screen_draw_gen = 1;
 
 typedef struct touch_event_position_data_s {
 	int16_t x;
@@ -92,6 +97,7 @@ uint32_t screen_erase(void){
 		return PROS_ERR;
 	}
 	vexDisplayErase();
+	_screen_draw_gen++;
 	if (!mutex_give(_screen_mutex)) {
 		return PROS_ERR;
 	} else {
@@ -105,6 +111,7 @@ uint32_t screen_scroll(int16_t start_line, int16_t lines){
 		return PROS_ERR;
 	}
 	vexDisplayScroll(start_line, lines);
+	_screen_draw_gen++;
 	if (!mutex_give(_screen_mutex)) {
 		return PROS_ERR;
 	} else {
@@ -118,6 +125,7 @@ uint32_t screen_scroll_area(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int1
 		return PROS_ERR;
 	}
 	vexDisplayScrollRect(x0, y0, x1, y1, lines);
+	_screen_draw_gen++;
 	if (!mutex_give(_screen_mutex)) {
 		return PROS_ERR;
 	} else {
@@ -144,6 +152,7 @@ uint32_t screen_draw_pixel(int16_t x, int16_t y){
 		return PROS_ERR;
 	}
 	vexDisplayPixelSet(x, y);
+	_screen_draw_gen++;
 	if (!mutex_give(_screen_mutex)) {
 		return PROS_ERR;
 	} else {
@@ -157,6 +166,7 @@ uint32_t screen_erase_pixel(int16_t x, int16_t y){
 		return PROS_ERR;
 	}
 	vexDisplayPixelClear(x, y);
+	_screen_draw_gen++;
 	if (!mutex_give(_screen_mutex)) {
 		return PROS_ERR;
 	} else {
@@ -170,6 +180,7 @@ uint32_t screen_draw_line(int16_t x0, int16_t y0, int16_t x1, int16_t y1){
 		return PROS_ERR;
 	}
 	vexDisplayLineDraw(x0, y0, x1, y1);
+	_screen_draw_gen++;
 	if (!mutex_give(_screen_mutex)) {
 		return PROS_ERR;
 	} else {
@@ -183,6 +194,7 @@ uint32_t screen_erase_line(int16_t x0, int16_t y0, int16_t x1, int16_t y1){
 		return PROS_ERR;
 	}
 	vexDisplayLineClear(x0, y0, x1, y1);
+	_screen_draw_gen++;
 	if (!mutex_give(_screen_mutex)) {
 		return PROS_ERR;
 	} else {
@@ -196,6 +208,7 @@ uint32_t screen_draw_rect(int16_t x0, int16_t y0, int16_t x1, int16_t y1){
 		return PROS_ERR;
 	}
 	vexDisplayRectDraw(x0, y0, x1, y1);
+	_screen_draw_gen++;
 	if (!mutex_give(_screen_mutex)) {
 		return PROS_ERR;
 	} else {
@@ -209,6 +222,7 @@ uint32_t screen_erase_rect(int16_t x0, int16_t y0, int16_t x1, int16_t y1){
 		return PROS_ERR;
 	}
 	vexDisplayRectClear(x0, y0, x1, y1);
+	_screen_draw_gen++;
 	if (!mutex_give(_screen_mutex)) {
 		return PROS_ERR;
 	} else {
@@ -222,6 +236,7 @@ uint32_t screen_fill_rect(int16_t x0, int16_t y0, int16_t x1, int16_t y1){
 		return PROS_ERR;
 	}
 	vexDisplayRectFill(x0, y0, x1, y1);
+	_screen_draw_gen++;
 	if (!mutex_give(_screen_mutex)) {
 		return PROS_ERR;
 	} else {
@@ -235,6 +250,7 @@ uint32_t screen_draw_circle(int16_t x, int16_t y, int16_t radius){
 		return PROS_ERR;
 	}
 	vexDisplayCircleDraw(x, y, radius);
+	_screen_draw_gen++;
 	if (!mutex_give(_screen_mutex)) {
 		return PROS_ERR;
 	} else {
@@ -248,6 +264,7 @@ uint32_t screen_erase_circle(int16_t x, int16_t y, int16_t radius){
 		return PROS_ERR;
 	}
 	vexDisplayCircleClear(x, y, radius);
+	_screen_draw_gen++;
 	if (!mutex_give(_screen_mutex)) {
 		return PROS_ERR;
 	} else {
@@ -261,6 +278,7 @@ uint32_t screen_fill_circle(int16_t x, int16_t y, int16_t radius){
 		return PROS_ERR;
 	}
 	vexDisplayCircleFill(x, y, radius);
+	_screen_draw_gen++;
 	if (!mutex_give(_screen_mutex)) {
 		return PROS_ERR;
 	} else {
@@ -294,42 +312,99 @@ uint32_t screen_print_at(text_format_e_t txt_fmt, int16_t x, int16_t y, const ch
 	return 1;
 }
 
+// Text is formatted into a single buffer guarded by the screen mutex so that
+// printing never touches the heap and uses a bounded amount of stack
+#define SCREEN_TEXT_BUF_SIZE 128
+#define SCREEN_TEXT_CACHE_SIZE 16
+
+static char _screen_text_buf[SCREEN_TEXT_BUF_SIZE];
+
+// Generous upper bounds on glyph sizes, so the area a print covers is never
+// underestimated when checking what it drew over
+#define SCREEN_WIDTH 480
+#define SCREEN_LINE_HEIGHT 20
+#define SCREEN_SMALL_GLYPH_W 8
+#define SCREEN_SMALL_GLYPH_H 16
+#define SCREEN_MEDIUM_GLYPH_W 12
+#define SCREEN_MEDIUM_GLYPH_H 24
+#define SCREEN_LARGE_GLYPH_W 24
+#define SCREEN_LARGE_GLYPH_H 48
+
+typedef struct screen_text_cache_entry_s {
+	uint32_t pos;   // (x,y) or line the text was drawn at
+	uint32_t fmt;   // text format, with bit 8 set for line-based prints
+	uint32_t hash;  // hash of the text that was drawn
+	uint32_t gen;   // value of _screen_draw_gen when the text was drawn
+	int16_t x0, y0, x1, y1;  // area the text covers
+} screen_text_cache_entry_s_t;
+
+static screen_text_cache_entry_s_t _screen_text_cache[SCREEN_TEXT_CACHE_SIZE];
+
+void screen_text_cache_invalidate(void) {
+	_screen_draw_gen++;
+}
+
+// Returns true if identical text in the same colors was the last thing printed
+// at this position and nothing else has been drawn over it since. Otherwise the
+// caller draws the text, so cached text it overlaps is forgotten. Must be called
+// with the screen mutex.
+static bool _screen_text_unchanged(uint32_t pos, uint32_t fmt, const char* text, int16_t x0, int16_t y0,
+                                   int16_t x1, int16_t y1) {
+	// the pen and eraser colors are part of what was drawn
+	uint32_t hash = 2166136261u ^ vexDisplayForegroundColorGet() ^ (vexDisplayBackgroundColorGet() << 1);  // FNV-1a
+	for (const char* c = text; *c; c++) {
+		hash = (hash ^ (uint8_t)*c) * 16777619u;
+	}
+	screen_text_cache_entry_s_t* entry =
+	    &_screen_text_cache[(pos ^ (pos >> 16) ^ fmt) % SCREEN_TEXT_CACHE_SIZE];
+	uint32_t gen = _screen_draw_gen;
+	if (entry->gen == gen && entry->pos == pos && entry->fmt == fmt && entry->hash == hash) {
+		return true;
+	}
+	for (size_t i = 0; i < SCREEN_TEXT_CACHE_SIZE; i++) {
+		screen_text_cache_entry_s_t* other = &_screen_text_cache[i];
+		if (other->gen == gen && other->x0 < x1 && x0 < other->x1 && other->y0 < y1 && y0 < other->y1) {
+			other->gen = gen - 1;
+		}
+	}
+	entry->pos = pos;
+	entry->fmt = fmt;
+	entry->hash = hash;
+	entry->gen = gen;
+	entry->x0 = x0;
+	entry->y0 = y0;
+	entry->x1 = x1;
+	entry->y1 = y1;
+	return false;
+}
+
 uint32_t screen_vprintf(text_format_e_t txt_fmt, const int16_t line, const char* text, va_list args){
 	if (!mutex_take(_screen_mutex, TIMEOUT_MAX)) {
 		errno = EACCES;
 		return PROS_ERR;
 	}
-	char* out;
-	vasprintf(&out, text, args);
-	va_list empty;
-	switch(txt_fmt){
-	case E_TEXT_SMALL:
-	case E_TEXT_MEDIUM:
-		{
-            vexDisplayVString(line, out, empty);
-            break;
-        }
-    case E_TEXT_LARGE:
-		{
-            vexDisplayVBigString(line, out, empty);
-            break;
-        }
-    case E_TEXT_MEDIUM_CENTER:
-		{
-            vexDisplayVCenteredString(line, out, empty);
-            break;
-        }
-    case E_TEXT_LARGE_CENTER:
-        {
-            vexDisplayVBigCenteredString(line, out, empty);
-            break;
-        }
-    default:
-        {
-            vexDisplayVString(line, out, empty);
-            break;
-        }
-    }
+	vsnprintf(_screen_text_buf, SCREEN_TEXT_BUF_SIZE, text, args);
+	// line prints may be centered or large, so count the whole band as covered
+	int16_t top = line * SCREEN_LINE_HEIGHT;
+	if (!_screen_text_unchanged((uint16_t)line, (uint32_t)txt_fmt | (1 << 8), _screen_text_buf, 0, top, SCREEN_WIDTH,
+	                            top + SCREEN_LARGE_GLYPH_H)) {
+		switch(txt_fmt){
+		case E_TEXT_LARGE:
+			vexDisplayBigString(line, "%s", _screen_text_buf);
+			break;
+		case E_TEXT_MEDIUM_CENTER:
+			vexDisplayCenteredString(line, "%s", _screen_text_buf);
+			break;
+		case E_TEXT_LARGE_CENTER:
+			vexDisplayBigCenteredString(line, "%s", _screen_text_buf);
+			break;
+		case E_TEXT_SMALL:
+		case E_TEXT_MEDIUM:
+		default:
+			vexDisplayString(line, "%s", _screen_text_buf);
+			break;
+		}
+	}
 	if (!mutex_give(_screen_mutex)) {
 		return PROS_ERR;
 	} else {
@@ -342,39 +417,362 @@ uint32_t screen_vprintf_at(text_format_e_t txt_fmt, const int16_t x, const int16
 		errno = EACCES;
 		return PROS_ERR;
 	}
-	char* out;
-	vasprintf(&out, text, args);
-	va_list empty;
-	switch(txt_fmt){
-    case E_TEXT_SMALL:
-		{
-            vexDisplayVSmallStringAt(x, y, out, empty);
-            break;
-        }
-    case E_TEXT_MEDIUM:
-    case E_TEXT_MEDIUM_CENTER:
-		{
-            vexDisplayVStringAt(x, y, out, empty);
-            break;
-        }
-    case E_TEXT_LARGE:
-    case E_TEXT_LARGE_CENTER:
-		{
-            vexDisplayVBigStringAt(x, y, out, empty);
-            break;
-        }
-    default:
-        {
-            vexDisplayVStringAt(x, y, out, empty);
-            break;
-        }
-    }
+	vsnprintf(_screen_text_buf, SCREEN_TEXT_BUF_SIZE, text, args);
+	uint32_t pos = ((uint32_t)(uint16_t)x << 16) | (uint16_t)y;
+	int16_t glyph_w = SCREEN_MEDIUM_GLYPH_W;
+	int16_t glyph_h = SCREEN_MEDIUM_GLYPH_H;
+	if (txt_fmt == E_TEXT_SMALL) {
+		glyph_w = SCREEN_SMALL_GLYPH_W;
+		glyph_h = SCREEN_SMALL_GLYPH_H;
+	} else if (txt_fmt == E_TEXT_LARGE || txt_fmt == E_TEXT_LARGE_CENTER) {
+		glyph_w = SCREEN_LARGE_GLYPH_W;
+		glyph_h = SCREEN_LARGE_GLYPH_H;
+	}
+	int16_t right = x + (int16_t)strlen(_screen_text_buf) * glyph_w;
+	if (!_screen_text_unchanged(pos, (uint32_t)txt_fmt, _screen_text_buf, x, y, right, y + glyph_h)) {
+		switch(txt_fmt){
+		case E_TEXT_SMALL:
+			vexDisplaySmallStringAt(x, y, "%s", _screen_text_buf);
+			break;
+		case E_TEXT_LARGE:
+		case E_TEXT_LARGE_CENTER:
+			vexDisplayBigStringAt(x, y, "%s", _screen_text_buf);
+			break;
+		case E_TEXT_MEDIUM:
+		case E_TEXT_MEDIUM_CENTER:
+		default:
+			vexDisplayStringAt(x, y, "%s", _screen_text_buf);
+			break;
+		}
+	}
 	if (!mutex_give(_screen_mutex)) {
 		return PROS_ERR;
 	} else {
 		return 1;
 	}
 }
+
+/******************************************************************************/
+/**                       Screen Display List Functions                      **/
+/**                                                                          **/
+/**   These functions record drawing commands into a preallocated buffer so  **/
+/**       that a whole frame can be drawn while holding the screen once      **/
+/******************************************************************************/
+
+// Conservative glyph cell sizes used to bound recorded text
+#define SCREEN_CMD_SMALL_CHAR_W 8
+#define SCREEN_CMD_SMALL_CHAR_H 14
+#define SCREEN_CMD_MEDIUM_CHAR_W 10
+#define SCREEN_CMD_MEDIUM_CHAR_H 20
+#define SCREEN_CMD_LARGE_CHAR_W 20
+#define SCREEN_CMD_LARGE_CHAR_H 40
+
+#define SCREEN_CMD_MIN(a, b) ((a) < (b) ? (a) : (b))
+#define SCREEN_CMD_MAX(a, b) ((a) > (b) ? (a) : (b))
+
+uint32_t screen_cmd_list_init(screen_cmd_list_s_t* list, screen_cmd_s_t* cmd_buf, uint32_t capacity, char* text_buf,
+                              uint32_t text_capacity) {
+	if (list == NULL || cmd_buf == NULL || capacity == 0) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	list->cmds = cmd_buf;
+	list->capacity = capacity;
+	list->count = 0;
+	list->text = text_buf;
+	list->text_capacity = text_buf ? text_capacity : 0;
+	list->text_used = 0;
+	list->cull = false;
+	list->dirty_x0 = list->dirty_y0 = list->dirty_x1 = list->dirty_y1 = 0;
+	return 1;
+}
+
+uint32_t screen_cmd_list_clear(screen_cmd_list_s_t* list) {
+	if (list == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	list->count = 0;
+	list->text_used = 0;
+	return 1;
+}
+
+uint32_t screen_cmd_list_set_dirty(screen_cmd_list_s_t* list, int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+	if (list == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	list->dirty_x0 = SCREEN_CMD_MIN(x0, x1);
+	list->dirty_y0 = SCREEN_CMD_MIN(y0, y1);
+	list->dirty_x1 = SCREEN_CMD_MAX(x0, x1);
+	list->dirty_y1 = SCREEN_CMD_MAX(y0, y1);
+	list->cull = true;
+	return 1;
+}
+
+uint32_t screen_cmd_list_clear_dirty(screen_cmd_list_s_t* list) {
+	if (list == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	list->cull = false;
+	return 1;
+}
+
+// Reserves the next command slot and fills in its geometry and bounding box
+static screen_cmd_s_t* _screen_cmd_push(screen_cmd_list_s_t* list, screen_cmd_e_t type, int16_t x0, int16_t y0,
+                                        int16_t x1, int16_t y1) {
+	if (list == NULL) {
+		errno = EINVAL;
+		return NULL;
+	}
+	if (list->count >= list->capacity) {
+		errno = ENOBUFS;
+		return NULL;
+	}
+	screen_cmd_s_t* cmd = &list->cmds[list->count++];
+	cmd->type = type;
+	cmd->x0 = x0;
+	cmd->y0 = y0;
+	cmd->x1 = x1;
+	cmd->y1 = y1;
+	cmd->color = 0;
+	cmd->txt_fmt = E_TEXT_MEDIUM;
+	cmd->text = NULL;
+	switch (type) {
+	case E_SCREEN_CMD_DRAW_PIXEL:
+	case E_SCREEN_CMD_ERASE_PIXEL:
+		cmd->bx0 = cmd->bx1 = x0;
+		cmd->by0 = cmd->by1 = y0;
+		break;
+	case E_SCREEN_CMD_DRAW_CIRCLE:
+	case E_SCREEN_CMD_ERASE_CIRCLE:
+	case E_SCREEN_CMD_FILL_CIRCLE:
+		cmd->bx0 = x0 - x1;
+		cmd->by0 = y0 - x1;
+		cmd->bx1 = x0 + x1;
+		cmd->by1 = y0 + x1;
+		break;
+	default:
+		cmd->bx0 = SCREEN_CMD_MIN(x0, x1);
+		cmd->by0 = SCREEN_CMD_MIN(y0, y1);
+		cmd->bx1 = SCREEN_CMD_MAX(x0, x1);
+		cmd->by1 = SCREEN_CMD_MAX(y0, y1);
+		break;
+	}
+	return cmd;
+}
+
+static uint32_t _screen_cmd_color(screen_cmd_list_s_t* list, screen_cmd_e_t type, uint32_t color) {
+	screen_cmd_s_t* cmd = _screen_cmd_push(list, type, 0, 0, 0, 0);
+	if (cmd == NULL) {
+		return PROS_ERR;
+	}
+	cmd->color = color;
+	return 1;
+}
+
+static uint32_t _screen_cmd_shape(screen_cmd_list_s_t* list, screen_cmd_e_t type, int16_t x0, int16_t y0,
+                                  int16_t x1, int16_t y1) {
+	return _screen_cmd_push(list, type, x0, y0, x1, y1) == NULL ? PROS_ERR : 1;
+}
+
+uint32_t screen_cmd_set_pen(screen_cmd_list_s_t* list, uint32_t color) {
+	return _screen_cmd_color(list, E_SCREEN_CMD_SET_PEN, color);
+}
+
+uint32_t screen_cmd_set_eraser(screen_cmd_list_s_t* list, uint32_t color) {
+	return _screen_cmd_color(list, E_SCREEN_CMD_SET_ERASER, color);
+}
+
+uint32_t screen_cmd_draw_pixel(screen_cmd_list_s_t* list, int16_t x, int16_t y) {
+	return _screen_cmd_shape(list, E_SCREEN_CMD_DRAW_PIXEL, x, y, x, y);
+}
+
+uint32_t screen_cmd_erase_pixel(screen_cmd_list_s_t* list, int16_t x, int16_t y) {
+	return _screen_cmd_shape(list, E_SCREEN_CMD_ERASE_PIXEL, x, y, x, y);
+}
+
+uint32_t screen_cmd_draw_line(screen_cmd_list_s_t* list, int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+	return _screen_cmd_shape(list, E_SCREEN_CMD_DRAW_LINE, x0, y0, x1, y1);
+}
+
+uint32_t screen_cmd_erase_line(screen_cmd_list_s_t* list, int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+	return _screen_cmd_shape(list, E_SCREEN_CMD_ERASE_LINE, x0, y0, x1, y1);
+}
+
+uint32_t screen_cmd_draw_rect(screen_cmd_list_s_t* list, int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+	return _screen_cmd_shape(list, E_SCREEN_CMD_DRAW_RECT, x0, y0, x1, y1);
+}
+
+uint32_t screen_cmd_erase_rect(screen_cmd_list_s_t* list, int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+	return _screen_cmd_shape(list, E_SCREEN_CMD_ERASE_RECT, x0, y0, x1, y1);
+}
+
+uint32_t screen_cmd_fill_rect(screen_cmd_list_s_t* list, int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+	return _screen_cmd_shape(list, E_SCREEN_CMD_FILL_RECT, x0, y0, x1, y1);
+}
+
+uint32_t screen_cmd_draw_circle(screen_cmd_list_s_t* list, int16_t x, int16_t y, int16_t radius) {
+	return _screen_cmd_shape(list, E_SCREEN_CMD_DRAW_CIRCLE, x, y, radius, 0);
+}
+
+uint32_t screen_cmd_erase_circle(screen_cmd_list_s_t* list, int16_t x, int16_t y, int16_t radius) {
+	return _screen_cmd_shape(list, E_SCREEN_CMD_ERASE_CIRCLE, x, y, radius, 0);
+}
+
+uint32_t screen_cmd_fill_circle(screen_cmd_list_s_t* list, int16_t x, int16_t y, int16_t radius) {
+	return _screen_cmd_shape(list, E_SCREEN_CMD_FILL_CIRCLE, x, y, radius, 0);
+}
+
+uint32_t screen_cmd_print_at(screen_cmd_list_s_t* list, text_format_e_t txt_fmt, int16_t x, int16_t y,
+                             const char* text, ...) {
+	va_list args;
+	va_start(args, text);
+	uint32_t rtn = screen_cmd_vprintf_at(list, txt_fmt, x, y, text, args);
+	va_end(args);
+	return rtn;
+}
+
+uint32_t screen_cmd_vprintf_at(screen_cmd_list_s_t* list, text_format_e_t txt_fmt, int16_t x, int16_t y,
+                               const char* text, va_list args) {
+	if (list == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	uint32_t avail = list->text_capacity - list->text_used;
+	if (list->count >= list->capacity || avail == 0) {
+		errno = ENOBUFS;
+		return PROS_ERR;
+	}
+	char* out = list->text + list->text_used;
+	int len = vsnprintf(out, avail, text, args);
+	if (len < 0 || (uint32_t)len >= avail) {
+		// leave the text buffer as it was so the caller can flush and retry
+		out[0] = '\0';
+		errno = ENOBUFS;
+		return PROS_ERR;
+	}
+	list->text_used += len + 1;
+
+	int16_t char_w, char_h;
+	switch (txt_fmt) {
+	case E_TEXT_SMALL:
+		char_w = SCREEN_CMD_SMALL_CHAR_W;
+		char_h = SCREEN_CMD_SMALL_CHAR_H;
+		break;
+	case E_TEXT_LARGE:
+	case E_TEXT_LARGE_CENTER:
+		char_w = SCREEN_CMD_LARGE_CHAR_W;
+		char_h = SCREEN_CMD_LARGE_CHAR_H;
+		break;
+	default:
+		char_w = SCREEN_CMD_MEDIUM_CHAR_W;
+		char_h = SCREEN_CMD_MEDIUM_CHAR_H;
+		break;
+	}
+	screen_cmd_s_t* cmd = _screen_cmd_push(list, E_SCREEN_CMD_PRINT_AT, x, y, x + len * char_w, y + char_h);
+	cmd->txt_fmt = txt_fmt;
+	cmd->text = out;
+	return 1;
+}
+
+static inline bool _screen_cmd_visible(const screen_cmd_list_s_t* list, const screen_cmd_s_t* cmd) {
+	if (!list->cull || cmd->type == E_SCREEN_CMD_SET_PEN || cmd->type == E_SCREEN_CMD_SET_ERASER) {
+		return true;
+	}
+	return cmd->bx0 <= list->dirty_x1 && cmd->bx1 >= list->dirty_x0 && cmd->by0 <= list->dirty_y1 &&
+	       cmd->by1 >= list->dirty_y0;
+}
+
+uint32_t screen_cmd_list_execute(const screen_cmd_list_s_t* list, screen_cmd_exec_fn_t fn, void* arg) {
+	if (list == NULL || fn == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	uint32_t executed = 0;
+	for (uint32_t i = 0; i < list->count; i++) {
+		if (_screen_cmd_visible(list, &list->cmds[i])) {
+			fn(&list->cmds[i], arg);
+			executed++;
+		}
+	}
+	return executed;
+}
+
+// Executor used by screen_cmd_list_submit, called with the screen mutex held
+static void _screen_cmd_draw(const screen_cmd_s_t* cmd, void* ignore) {
+	switch (cmd->type) {
+	case E_SCREEN_CMD_SET_PEN:
+		vexDisplayForegroundColor(cmd->color);
+		break;
+	case E_SCREEN_CMD_SET_ERASER:
+		vexDisplayBackgroundColor(cmd->color);
+		break;
+	case E_SCREEN_CMD_DRAW_PIXEL:
+		vexDisplayPixelSet(cmd->x0, cmd->y0);
+		break;
+	case E_SCREEN_CMD_ERASE_PIXEL:
+		vexDisplayPixelClear(cmd->x0, cmd->y0);
+		break;
+	case E_SCREEN_CMD_DRAW_LINE:
+		vexDisplayLineDraw(cmd->x0, cmd->y0, cmd->x1, cmd->y1);
+		break;
+	case E_SCREEN_CMD_ERASE_LINE:
+		vexDisplayLineClear(cmd->x0, cmd->y0, cmd->x1, cmd->y1);
+		break;
+	case E_SCREEN_CMD_DRAW_RECT:
+		vexDisplayRectDraw(cmd->x0, cmd->y0, cmd->x1, cmd->y1);
+		break;
+	case E_SCREEN_CMD_ERASE_RECT:
+		vexDisplayRectClear(cmd->x0, cmd->y0, cmd->x1, cmd->y1);
+		break;
+	case E_SCREEN_CMD_FILL_RECT:
+		vexDisplayRectFill(cmd->x0, cmd->y0, cmd->x1, cmd->y1);
+		break;
+	case E_SCREEN_CMD_DRAW_CIRCLE:
+		vexDisplayCircleDraw(cmd->x0, cmd->y0, cmd->x1);
+		break;
+	case E_SCREEN_CMD_ERASE_CIRCLE:
+		vexDisplayCircleClear(cmd->x0, cmd->y0, cmd->x1);
+		break;
+	case E_SCREEN_CMD_FILL_CIRCLE:
+		vexDisplayCircleFill(cmd->x0, cmd->y0, cmd->x1);
+		break;
+	case E_SCREEN_CMD_PRINT_AT:
+		switch (cmd->txt_fmt) {
+		case E_TEXT_SMALL:
+			vexDisplaySmallStringAt(cmd->x0, cmd->y0, "%s", cmd->text);
+			break;
+		case E_TEXT_LARGE:
+		case E_TEXT_LARGE_CENTER:
+			vexDisplayBigStringAt(cmd->x0, cmd->y0, "%s", cmd->text);
+			break;
+		default:
+			vexDisplayStringAt(cmd->x0, cmd->y0, "%s", cmd->text);
+			break;
+		}
+		break;
+	}
+}
+
+uint32_t screen_cmd_list_submit(const screen_cmd_list_s_t* list) {
+	if (list == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	if (!mutex_take(_screen_mutex, TIMEOUT_MAX)) {
+		errno = EACCES;
+		return PROS_ERR;
+	}
+	uint32_t executed = screen_cmd_list_execute(list, _screen_cmd_draw, NULL);
+	_screen_draw_gen++;
+	if (!mutex_give(_screen_mutex)) {
+		return PROS_ERR;
+	}
+	return executed;
+}
+
 /******************************************************************************/
 /**                         Screen Touch Functions                           **/
 /**                                                                          **/
@@ -382,28 +780,46 @@ uint32_t screen_vprintf_at(text_format_e_t txt_fmt, const int16_t x, const int16
 /**                    information about screen touches                      **/
 /******************************************************************************/
 
-static const screen_touch_status_s_t PROS_SCREEN_ERR = {.touch_status = E_TOUCH_ERROR, .x = -1, .y = -1, .press_count = -1, .release_count = -1};
+// The touch screen is sampled only by _touch_handle_task. Both the touch
+// callbacks and the LVGL input driver read from the latest sample.
+#define TOUCH_DEFAULT_SAMPLE_PERIOD 10
+
+static V5_TouchStatus _touch_sample;
+static uint32_t _touch_sample_period = TOUCH_DEFAULT_SAMPLE_PERIOD;
+static uint32_t _touch_hold_interval = 0;
+
+void screen_touch_sample_get(V5_TouchStatus* status) {
+	rtos_suspend_all();
+	*status = _touch_sample;
+	rtos_resume_all();
+}
 
 screen_touch_status_s_t screen_touch_status(void){
-	if (!mutex_take(_screen_mutex, TIMEOUT_MAX)) {
-		errno = EACCES;
-		return PROS_SCREEN_ERR;
-	}
 	V5_TouchStatus v5_touch_status;
 	screen_touch_status_s_t rtv;
-	vexTouchDataGet(&v5_touch_status);
+	screen_touch_sample_get(&v5_touch_status);
 	rtv.touch_status = (last_touch_e_t)v5_touch_status.lastEvent;
 	rtv.x = v5_touch_status.lastXpos;
 	rtv.y = v5_touch_status.lastYpos;
 	rtv.press_count = v5_touch_status.pressCount;
 	rtv.release_count = v5_touch_status.releaseCount;
-	if (!mutex_give(_screen_mutex)) {
-		errno = EACCES;
-		return PROS_SCREEN_ERR;
-	} 
 	return rtv;
 }
 
+uint32_t screen_touch_set_sample_period(uint32_t period) {
+	if (period == 0) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	_touch_sample_period = period;
+	return 1;
+}
+
+uint32_t screen_touch_set_hold_interval(uint32_t interval) {
+	_touch_hold_interval = interval;
+	return 1;
+}
+
 static linked_list_s_t* _touch_event_release_handler_list = NULL;
 static linked_list_s_t* _touch_event_press_handler_list = NULL;
 static linked_list_s_t* _touch_event_press_auto_handler_list = NULL;
@@ -454,12 +870,18 @@ static inline bool _touch_status_equivalent(V5_TouchStatus x, V5_TouchStatus y)
 }
 
 void _touch_handle_task(void* ignore) {
-	V5_TouchStatus last, current;
+	V5_TouchStatus last = {0}, current;
+	uint32_t last_held_dispatch = 0;
+	uint32_t time = millis();
 	while (true) {
 		mutex_take(_screen_mutex, TIMEOUT_MAX);
-        vexTouchDataGet(&current);
+		vexTouchDataGet(&current);
 		mutex_give(_screen_mutex);
+		rtos_suspend_all();
+		_touch_sample = current;
+		rtos_resume_all();
 		if (!_touch_status_equivalent(current, last)) {
+			bool dispatched = true;
 			switch (current.lastEvent) {
 			case E_TOUCH_RELEASED:
 				linked_list_foreach(_touch_event_release_handler_list, _handle_cb, NULL);
@@ -468,12 +890,22 @@ void _touch_handle_task(void* ignore) {
 				linked_list_foreach(_touch_event_press_handler_list, _handle_cb, NULL);
 				break;
 			case E_TOUCH_HELD:
-				linked_list_foreach(_touch_event_press_auto_handler_list, _handle_cb, NULL);
+				// coalesce drags: a held touch that moves between samples is
+				// dispatched at most once per hold interval. Undispatched samples
+				// don't update last, so the final position is still delivered.
+				if (last.lastEvent == E_TOUCH_HELD && time - last_held_dispatch < _touch_hold_interval) {
+					dispatched = false;
+				} else {
+					linked_list_foreach(_touch_event_press_auto_handler_list, _handle_cb, NULL);
+					last_held_dispatch = time;
+				}
 				break;
 			}
-			last = current;
+			if (dispatched) {
+				last = current;
+			}
 		}
-		delay(10);
+		task_delay_until(&time, _touch_sample_period);
 	}
 }
 
@@ -15,6 +15,7 @@
 
 #include "vdml/vdml.h"
 #include "kapi.h"
+#include "system/flight_recorder.h"
 #include "v5_api.h"
 #include "vdml/registry.h"
 
@@ -126,6 +127,9 @@ void port_mutex_give_all() {
 
 void vdml_set_port_error(uint8_t port) {
 	if (VALIDATE_PORT_NO(port)) {
+		// only record the first error, since a port in error is usually hit again
+		// on every access
+		if (!(port_errors & (1 << port))) flight_recorder_record(E_FLIGHT_EVENT_PORT_ERROR, port + 1, 0);
 		port_errors |= (1 << port);
 	}
 }
@@ -158,12 +162,19 @@ void vdml_reset_port_error() {
  * plugged in according to the system, then compares that with the registry
  * records.
  *
+ * Also sends pending controller framebuffer updates, records new IMU, optical
+ * and rotation sensor samples, steps the pose estimator, and drains buffered
+ * generic serial ports.
+ *
  * On warnings, no operation is performed.
  */
 void vdml_background_processing() {
 	static int32_t last_port_errors = 0;
 	static int cycle = 0;
 	cycle++;
+
+	// Send pending controller framebuffer updates
+	controller_background_processing();
 	if (cycle % 5000 == 0) {
 		vdml_reset_port_error();
 		last_port_errors = 0;
@@ -181,6 +192,14 @@ void vdml_background_processing() {
 		if (error_arr[i] != 0) num_errors++;
 		if (error_arr[i] == 2) mismatch_errors++;
 	}
+
+	// Record new samples for devices with a sample ring, step the pose
+	// estimator, and drain buffered generic serial ports
+	imu_background_processing();
+	optical_background_processing();
+	rotation_background_processing();
+	pose_background_processing();
+	serial_background_processing();
 	// Every 50 ms
 	if (cycle % 50 == 0) {
 		if (last_port_errors == port_errors) {
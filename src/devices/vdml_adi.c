@@ -30,6 +30,10 @@ int32_t adi_port_set_value(uint8_t port, int32_t value) {
 	return ext_adi_port_set_value(INTERNAL_ADI_PORT, port, value);
 }
 
+int32_t adi_read_all(adi_snapshot_s_t* snapshot) {
+	return ext_adi_read_all(INTERNAL_ADI_PORT, snapshot);
+}
+
 int32_t adi_analog_calibrate(uint8_t port) {
 	return ext_adi_analog_calibrate(INTERNAL_ADI_PORT, port);
 }
@@ -213,6 +213,26 @@ std::int32_t ADILed::clear() {
 	return ext_adi_led_clear_all((adi_led_t)merge_adi_ports(_smart_port, _adi_port), (uint32_t*)_buffer.data(), _buffer.size());
 }
 
+std::int32_t ADILed::start_engine() {
+	return ext_adi_led_engine_start((adi_led_t)merge_adi_ports(_smart_port, _adi_port), _buffer.size());
+}
+
+std::int32_t ADILed::stop_engine() {
+	return ext_adi_led_engine_stop((adi_led_t)merge_adi_ports(_smart_port, _adi_port));
+}
+
+std::int32_t ADILed::commit() {
+	adi_led_t led = (adi_led_t)merge_adi_ports(_smart_port, _adi_port);
+	if (ext_adi_led_engine_write(led, _buffer.data(), 0, _buffer.size()) != PROS_SUCCESS) {
+		return PROS_ERR;
+	}
+	return ext_adi_led_engine_commit(led);
+}
+
+std::int32_t ADILed::set_effect(const ext_adi_led_effect_s_t& effect) {
+	return ext_adi_led_engine_set_effect((adi_led_t)merge_adi_ports(_smart_port, _adi_port), &effect);
+}
+
 std::int32_t ADILed::clear_pixel(uint32_t pixel_position) {
 	return ext_adi_led_clear_pixel((adi_led_t)merge_adi_ports(_smart_port, _adi_port), (uint32_t*)_buffer.data(), _buffer.size(), pixel_position);
 }
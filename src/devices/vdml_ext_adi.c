@@ -13,6 +13,7 @@
 #include <errno.h>
 #include <math.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "kapi.h"
 #include "pros/adi.h"
@@ -152,6 +153,45 @@ int32_t ext_adi_port_set_value(uint8_t smart_port, uint8_t adi_port, int32_t val
 	return_port(smart_port - 1, 1);
 }
 
+// Reads every ADI port of a claimed device
+static void _adi_snapshot(v5_smart_device_s_t* device, uint8_t smart_port, adi_snapshot_s_t* snapshot) {
+	snapshot->smart_port = smart_port;
+	for (uint8_t i = 0; i < NUM_ADI_PORTS; i++) {
+		adi_port_config_e_t config = (adi_port_config_e_t)vexDeviceAdiPortConfigGet(device->device_info, i);
+		int32_t value = vexDeviceAdiValueGet(device->device_info, i);
+		if (config == E_ADI_LEGACY_ENCODER && ((adi_data_s_t*)device->pad)[i].encoder_data.reversed) {
+			value = -value;
+		}
+		snapshot->configs[i] = config;
+		snapshot->values[i] = value;
+	}
+}
+
+int32_t ext_adi_read_all(uint8_t smart_port, adi_snapshot_s_t* snapshot) {
+	if (snapshot == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	claim_port_i(smart_port - 1, E_DEVICE_ADI);
+	_adi_snapshot(device, smart_port, snapshot);
+	return_port(smart_port - 1, 1);
+}
+
+int32_t adi_read_all_brain(adi_snapshot_s_t* snapshots, uint32_t max) {
+	if (snapshots == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	uint32_t count = 0;
+	for (uint8_t port = 0; port < NUM_V5_PORTS && count < max; port++) {
+		if (registry_get_plugged_type(port) != E_DEVICE_ADI) continue;
+		if (!claim_port_try(port, E_DEVICE_ADI)) continue;
+		_adi_snapshot(registry_get_device(port), port + 1, &snapshots[count++]);
+		port_mutex_give(port);
+	}
+	return count;
+}
+
 int32_t ext_adi_analog_calibrate(uint8_t smart_port, uint8_t adi_port) {
 	transform_adi_port(adi_port);
 	claim_port_i(smart_port - 1, E_DEVICE_ADI);
@@ -509,3 +549,243 @@ int32_t ext_adi_led_clear_all(ext_adi_led_t led, uint32_t* buffer, uint32_t buff
 int32_t ext_adi_led_clear_pixel(ext_adi_led_t led, uint32_t* buffer, uint32_t buffer_length, uint32_t pixel_position) {
 	return ext_adi_led_set_pixel(led, buffer, buffer_length, 0, pixel_position);
 }
+
+// Addressable LED engine. Every field of a strip is protected by the engine
+// mutex, which the engine task holds for the whole of each frame.
+
+#define LED_ENGINE_DEFAULT_PERIOD 20  // ms
+
+typedef struct led_strip {
+	ext_adi_led_t led;  // 0 when the slot is free
+	uint32_t length;
+	uint32_t back[MAX_LED];   // next frame, written by the user or an effect
+	uint32_t front[MAX_LED];  // what the strip is showing
+	bool committed;
+	bool resend;  // the whole strip must be sent, e.g. after it was started
+	ext_adi_led_effect_s_t effect;
+	uint32_t effect_start;
+} led_strip_s_t;
+
+static led_strip_s_t _led_strips[ADI_LED_ENGINE_MAX_STRIPS];
+static uint32_t _led_engine_period = LED_ENGINE_DEFAULT_PERIOD;
+static ext_adi_led_engine_stats_s_t _led_engine_stats;
+
+static static_sem_s_t _led_engine_mutex_buf;
+static mutex_t _led_engine_mutex = NULL;
+static task_stack_t _led_engine_task_stack[TASK_STACK_DEPTH_DEFAULT];
+static static_task_s_t _led_engine_task_buffer;
+static task_t _led_engine_task = NULL;
+
+static uint32_t _led_blend(uint32_t a, uint32_t b, uint32_t num, uint32_t den) {
+	uint32_t rtn = 0;
+	for (int shift = 0; shift <= 16; shift += 8) {
+		int32_t ca = (a >> shift) & 0xFF;
+		int32_t cb = (b >> shift) & 0xFF;
+		rtn |= (uint32_t)(ca + (cb - ca) * (int32_t)num / (int32_t)den) << shift;
+	}
+	return rtn;
+}
+
+static void _led_draw_effect(led_strip_s_t* strip, uint32_t now) {
+	ext_adi_led_effect_s_t* effect = &strip->effect;
+	uint32_t step = effect->period ? (now - strip->effect_start) / effect->period : 0;
+	for (uint32_t i = 0; i < strip->length; i++) {
+		uint32_t color;
+		switch (effect->type) {
+			case E_ADI_LED_EFFECT_GRADIENT: {
+				uint32_t pos = (i + step) % strip->length;
+				color = strip->length > 1 ? _led_blend(effect->color, effect->color2, pos, strip->length - 1) : effect->color;
+				break;
+			}
+			case E_ADI_LED_EFFECT_CHASE:
+				color = (i + strip->length - step % strip->length) % strip->length < effect->width ? effect->color
+				                                                                                   : effect->color2;
+				break;
+			default:
+				color = effect->color;
+				break;
+		}
+		strip->back[i] = color;
+	}
+	strip->committed = true;
+}
+
+// Sends the changed span of a strip, returning the number of LEDs sent. If the
+// expander is busy the frame stays committed and is retried next frame.
+static uint32_t _led_send(led_strip_s_t* strip) {
+	uint32_t first = 0;
+	uint32_t last = strip->length;
+	if (!strip->resend) {
+		while (first < strip->length && strip->back[first] == strip->front[first]) first++;
+		while (last > first && strip->back[last - 1] == strip->front[last - 1]) last--;
+	}
+	if (first == last) {
+		strip->committed = false;
+		return 0;
+	}
+	uint8_t smart_port, adi_port;
+	get_ports(strip->led, smart_port, adi_port);
+	adi_port--;
+	if (!claim_port_try(smart_port, E_DEVICE_ADI)) return 0;
+	v5_smart_device_s_t* device = registry_get_device(smart_port);
+	memcpy(&strip->front[first], &strip->back[first], (last - first) * sizeof(uint32_t));
+	// pData holds the nLength colors starting at LED nOffset
+	vexDeviceAdiAddrLedSet(device->device_info, adi_port, &strip->front[first], first, last - first, 0);
+	port_mutex_give(smart_port);
+	strip->committed = false;
+	strip->resend = false;
+	return last - first;
+}
+
+static void _led_engine_task_fn(void* ignore) {
+	uint32_t time = millis();
+	while (true) {
+		uint64_t start = micros();
+		uint32_t sent = 0;
+		mutex_take(_led_engine_mutex, TIMEOUT_MAX);
+		for (int i = 0; i < ADI_LED_ENGINE_MAX_STRIPS; i++) {
+			led_strip_s_t* strip = &_led_strips[i];
+			if (!strip->led) continue;
+			if (strip->effect.type != E_ADI_LED_EFFECT_NONE) {
+				_led_draw_effect(strip, time);
+			}
+			if (strip->committed || strip->resend) {
+				sent += _led_send(strip);
+			}
+		}
+		mutex_give(_led_engine_mutex);
+		uint32_t elapsed = micros() - start;
+		_led_engine_stats.frames++;
+		_led_engine_stats.last_frame_us = elapsed;
+		if (elapsed > _led_engine_stats.max_frame_us) _led_engine_stats.max_frame_us = elapsed;
+		_led_engine_stats.leds_sent += sent;
+		task_delay_until(&time, _led_engine_period);
+	}
+}
+
+// Looks up the strip for a led. Must be called with the engine mutex held.
+static led_strip_s_t* _led_engine_find(ext_adi_led_t led) {
+	for (int i = 0; i < ADI_LED_ENGINE_MAX_STRIPS; i++) {
+		if (_led_strips[i].led == led) return &_led_strips[i];
+	}
+	return NULL;
+}
+
+// Takes the engine mutex and finds the strip for a led, setting errno if it
+// isn't being driven
+static led_strip_s_t* _led_engine_take(ext_adi_led_t led) {
+	if (_led_engine_mutex == NULL) {
+		errno = ENOENT;
+		return NULL;
+	}
+	mutex_take(_led_engine_mutex, TIMEOUT_MAX);
+	led_strip_s_t* strip = led ? _led_engine_find(led) : NULL;
+	if (strip == NULL) {
+		mutex_give(_led_engine_mutex);
+		errno = ENOENT;
+	}
+	return strip;
+}
+
+int32_t ext_adi_led_engine_start(ext_adi_led_t led, uint32_t length) {
+	if (length < 1 || length > MAX_LED) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	uint8_t smart_port, adi_port;
+	get_ports(led, smart_port, adi_port);
+	transform_adi_port(adi_port);
+	claim_port_i(smart_port, E_DEVICE_ADI);
+	validate_type(device, adi_port, smart_port, E_ADI_DIGITAL_OUT);
+	port_mutex_give(smart_port);
+
+	rtos_suspend_all();
+	if (_led_engine_mutex == NULL) {
+		_led_engine_mutex = mutex_create_static(&_led_engine_mutex_buf);
+	}
+	rtos_resume_all();
+	mutex_take(_led_engine_mutex, TIMEOUT_MAX);
+	led_strip_s_t* strip = _led_engine_find(led);
+	if (strip == NULL) strip = _led_engine_find(0);
+	if (strip == NULL) {
+		mutex_give(_led_engine_mutex);
+		errno = ENOMEM;
+		return PROS_ERR;
+	}
+	memset(strip, 0, sizeof(*strip));
+	strip->led = led;
+	strip->length = length;
+	strip->resend = true;
+	if (_led_engine_task == NULL) {
+		_led_engine_task =
+		    task_create_static(_led_engine_task_fn, NULL, TASK_PRIORITY_MIN + 2, TASK_STACK_DEPTH_DEFAULT,
+		                       "PROS LED Engine", _led_engine_task_stack, &_led_engine_task_buffer);
+	}
+	mutex_give(_led_engine_mutex);
+	return PROS_SUCCESS;
+}
+
+int32_t ext_adi_led_engine_stop(ext_adi_led_t led) {
+	led_strip_s_t* strip = _led_engine_take(led);
+	if (strip == NULL) return PROS_ERR;
+	strip->led = 0;
+	mutex_give(_led_engine_mutex);
+	return PROS_SUCCESS;
+}
+
+int32_t ext_adi_led_engine_write(ext_adi_led_t led, const uint32_t* colors, uint32_t offset, uint32_t count) {
+	led_strip_s_t* strip = _led_engine_take(led);
+	if (strip == NULL) return PROS_ERR;
+	if (colors == NULL || offset > strip->length || count > strip->length - offset) {
+		mutex_give(_led_engine_mutex);
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	strip->effect.type = E_ADI_LED_EFFECT_NONE;
+	memcpy(&strip->back[offset], colors, count * sizeof(uint32_t));
+	mutex_give(_led_engine_mutex);
+	return PROS_SUCCESS;
+}
+
+int32_t ext_adi_led_engine_commit(ext_adi_led_t led) {
+	led_strip_s_t* strip = _led_engine_take(led);
+	if (strip == NULL) return PROS_ERR;
+	strip->committed = true;
+	mutex_give(_led_engine_mutex);
+	return PROS_SUCCESS;
+}
+
+int32_t ext_adi_led_engine_set_effect(ext_adi_led_t led, const ext_adi_led_effect_s_t* effect) {
+	if (effect != NULL && (effect->type < E_ADI_LED_EFFECT_NONE || effect->type > E_ADI_LED_EFFECT_CHASE)) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	led_strip_s_t* strip = _led_engine_take(led);
+	if (strip == NULL) return PROS_ERR;
+	if (effect == NULL) {
+		strip->effect.type = E_ADI_LED_EFFECT_NONE;
+	} else {
+		strip->effect = *effect;
+		strip->effect_start = millis();
+	}
+	mutex_give(_led_engine_mutex);
+	return PROS_SUCCESS;
+}
+
+int32_t ext_adi_led_engine_set_frame_period(uint32_t period) {
+	if (period == 0) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	_led_engine_period = period;
+	return PROS_SUCCESS;
+}
+
+int32_t ext_adi_led_engine_get_stats(ext_adi_led_engine_stats_s_t* stats) {
+	if (stats == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	*stats = _led_engine_stats;
+	return PROS_SUCCESS;
+}
@@ -37,6 +37,14 @@ typedef struct __attribute__((packed)) imu_reset_data {
 	double pitch_offset;
 	double yaw_offset;
 	double roll_offset;
+	// Sample ring filled by imu_background_processing. The background task is
+	// the only writer of ring_head and the consumer the only writer of ring_tail.
+	imu_sample_s_t* ring;
+	uint32_t ring_capacity;
+	volatile uint32_t ring_head;
+	volatile uint32_t ring_tail;
+	uint32_t ring_last_timestamp;
+	uint32_t ring_dropped;
 } imu_data_s_t;
 
 int32_t imu_reset(uint8_t port) {
@@ -136,16 +144,9 @@ double imu_get_heading(uint8_t port) {
 #define QUATERNION_ERR_INIT \
 	{ .x = PROS_ERR_F, .y = PROS_ERR_F, .z = PROS_ERR_F, .w = PROS_ERR_F }
 
-quaternion_s_t imu_get_quaternion(uint8_t port) {
-	quaternion_s_t rtn = QUATERNION_ERR_INIT;
-	if (!claim_port_try(port - 1, E_DEVICE_IMU)) {
-		return rtn;
-	}
-	v5_smart_device_s_t* device = registry_get_device(port - 1);
-	ERROR_IMU_STILL_CALIBRATING(port, device, rtn);
-	euler_s_t euler;
-	vexDeviceImuAttitudeGet(device->device_info, (V5_DeviceImuAttitude*)&euler);
-	imu_data_s_t* data = (imu_data_s_t*)device->pad;
+// Converts the sensor's attitude plus the tare offsets into a quaternion
+static quaternion_s_t _imu_quaternion_from_euler(euler_s_t euler, imu_data_s_t* data) {
+	quaternion_s_t rtn;
 	// To calculate the quaternion values, we first get the euler values, add the offsets,
 	// and then do the calculations.
 	double roll = fmod(euler.roll + data->roll_offset, 2.0 * IMU_EULER_LIMIT);
@@ -163,7 +164,19 @@ quaternion_s_t imu_get_quaternion(uint8_t port) {
 	rtn.x = sr * cp * cy - cr * sp * sy;
 	rtn.y = cr * sp * cy + sr * cp * sy;
 	rtn.z = cr * cp * sy - sr * sp * cy;
+	return rtn;
+}
 
+quaternion_s_t imu_get_quaternion(uint8_t port) {
+	quaternion_s_t rtn = QUATERNION_ERR_INIT;
+	if (!claim_port_try(port - 1, E_DEVICE_IMU)) {
+		return rtn;
+	}
+	v5_smart_device_s_t* device = registry_get_device(port - 1);
+	ERROR_IMU_STILL_CALIBRATING(port, device, rtn);
+	euler_s_t euler;
+	vexDeviceImuAttitudeGet(device->device_info, (V5_DeviceImuAttitude*)&euler);
+	rtn = _imu_quaternion_from_euler(euler, (imu_data_s_t*)device->pad);
 	return_port(port - 1, rtn);
 }
 
@@ -415,3 +428,89 @@ imu_orientation_e_t imu_get_physical_orientation(uint8_t port) {
 	}
 	return (status >> 1) & 7;
 }
+
+int32_t imu_sample_ring_start(uint8_t port, imu_sample_s_t* buffer, uint32_t capacity) {
+	if (buffer == NULL || capacity < 2) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	claim_port_i(port - 1, E_DEVICE_IMU);
+	imu_data_s_t* data = (imu_data_s_t*)device->pad;
+	data->ring = NULL;
+	data->ring_capacity = capacity;
+	data->ring_head = 0;
+	data->ring_tail = 0;
+	data->ring_last_timestamp = 0;
+	data->ring_dropped = 0;
+	data->ring = buffer;
+	return_port(port - 1, PROS_SUCCESS);
+}
+
+int32_t imu_sample_ring_stop(uint8_t port) {
+	claim_port_i(port - 1, E_DEVICE_IMU);
+	((imu_data_s_t*)device->pad)->ring = NULL;
+	return_port(port - 1, PROS_SUCCESS);
+}
+
+int32_t imu_sample_ring_read(uint8_t port, imu_sample_s_t* samples, uint32_t max) {
+	claim_port_i(port - 1, E_DEVICE_IMU);
+	imu_data_s_t* data = (imu_data_s_t*)device->pad;
+	if (data->ring == NULL) {
+		errno = ENOENT;
+		return_port(port - 1, PROS_ERR);
+	}
+	uint32_t tail = data->ring_tail;
+	uint32_t head = data->ring_head;
+	__sync_synchronize();  // read samples only after seeing the new head
+	uint32_t count = 0;
+	while (tail != head && count < max) {
+		samples[count++] = data->ring[tail];
+		tail = (tail + 1) % data->ring_capacity;
+	}
+	__sync_synchronize();  // finish reading before releasing the slots
+	data->ring_tail = tail;
+	return_port(port - 1, count);
+}
+
+int32_t imu_sample_ring_get_dropped(uint8_t port) {
+	claim_port_i(port - 1, E_DEVICE_IMU);
+	int32_t dropped = ((imu_data_s_t*)device->pad)->ring_dropped;
+	return_port(port - 1, dropped);
+}
+
+void imu_background_processing() {
+	for (int i = 0; i < NUM_V5_PORTS; i++) {
+		v5_smart_device_s_t* device = registry_get_device(i);
+		imu_data_s_t* data = (imu_data_s_t*)device->pad;
+		if (device->device_type != E_DEVICE_IMU || data->ring == NULL) continue;
+		if (registry_get_plugged_type(i) != E_DEVICE_IMU) continue;
+		if (vexDeviceImuStatusGet(device->device_info) & E_IMU_STATUS_CALIBRATING) continue;
+		// only record each packet from the sensor once
+		uint32_t timestamp = vexDeviceGetTimestamp(device->device_info);
+		if (timestamp == data->ring_last_timestamp) continue;
+		data->ring_last_timestamp = timestamp;
+
+		uint32_t head = data->ring_head;
+		uint32_t next = (head + 1) % data->ring_capacity;
+		if (next == data->ring_tail) {
+			data->ring_dropped++;
+			continue;
+		}
+		imu_sample_s_t* sample = &data->ring[head];
+		quaternion_s_t raw;
+		euler_s_t euler;
+		sample->timestamp = timestamp;
+		vexDeviceImuRawGyroGet(device->device_info, (V5_DeviceImuRaw*)&raw);
+		sample->gyro.x = raw.x;
+		sample->gyro.y = raw.y;
+		sample->gyro.z = raw.z;
+		vexDeviceImuRawAccelGet(device->device_info, (V5_DeviceImuRaw*)&raw);
+		sample->accel.x = raw.x;
+		sample->accel.y = raw.y;
+		sample->accel.z = raw.z;
+		vexDeviceImuAttitudeGet(device->device_info, (V5_DeviceImuAttitude*)&euler);
+		sample->quaternion = _imu_quaternion_from_euler(euler, data);
+		__sync_synchronize();  // publish the sample before the new head
+		data->ring_head = next;
+	}
+}
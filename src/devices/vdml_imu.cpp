@@ -125,4 +125,16 @@ pros::c::imu_orientation_e_t Imu::get_physical_orientation() const {
 	return pros::c::imu_get_physical_orientation(_port);
 }
 
+std::int32_t Imu::start_sample_ring(pros::c::imu_sample_s_t* buffer, std::uint32_t capacity) const {
+	return pros::c::imu_sample_ring_start(_port, buffer, capacity);
+}
+
+std::int32_t Imu::stop_sample_ring() const {
+	return pros::c::imu_sample_ring_stop(_port);
+}
+
+std::int32_t Imu::read_samples(pros::c::imu_sample_s_t* samples, std::uint32_t max) const {
+	return pros::c::imu_sample_ring_read(_port, samples, max);
+}
+
 }  // namespace pros
@@ -216,3 +216,52 @@ uint32_t link_clear_receive_buf(uint8_t port) {
     return_port(port - 1, rtv);
 }
 
+
+// Byte stream of a VEXlink radio for the link transport. The context is the
+// radio's port number.
+static uint32_t _link_radio_transmit(void* context, const uint8_t* data, uint32_t size) {
+    uint8_t port = (uint32_t)context;
+    claim_port(port - 1, E_DEVICE_SERIAL, 0);
+    uint32_t rtv = 0;
+    if (vexDeviceGenericRadioLinkStatus(device->device_info)) {
+        rtv = vexDeviceGenericRadioTransmit(device->device_info, (uint8_t*)data, size);
+    }
+    return_port(port - 1, rtv);
+}
+
+static uint32_t _link_radio_receive(void* context, uint8_t* data, uint32_t size) {
+    uint8_t port = (uint32_t)context;
+    claim_port(port - 1, E_DEVICE_SERIAL, 0);
+    uint32_t rtv = 0;
+    if (vexDeviceGenericRadioLinkStatus(device->device_info)) {
+        uint32_t avail = vexDeviceGenericRadioReceiveAvail(device->device_info);
+        rtv = vexDeviceGenericRadioReceive(device->device_info, data, avail < size ? avail : size);
+    }
+    return_port(port - 1, rtv);
+}
+
+static uint32_t _link_radio_transmittable(void* context) {
+    uint8_t port = (uint32_t)context;
+    claim_port(port - 1, E_DEVICE_SERIAL, 0);
+    uint32_t rtv = 0;
+    if (vexDeviceGenericRadioLinkStatus(device->device_info)) {
+        rtv = vexDeviceGenericRadioWriteFree(device->device_info);
+    }
+    return_port(port - 1, rtv);
+}
+
+int32_t link_transport_init(link_transport_s_t* transport, uint8_t port) {
+    if (!VALIDATE_PORT_NO(port - 1)) {
+        errno = ENXIO;
+        return PROS_ERR;
+    }
+    link_radio_s_t radio = {.transmit = _link_radio_transmit,
+                            .receive = _link_radio_receive,
+                            .transmittable = _link_radio_transmittable,
+                            .context = (void*)(uint32_t)port};
+    if (link_transport_init_radio(transport, &radio) != 1) {
+        return PROS_ERR;
+    }
+    transport->port = port;
+    return 1;
+}
@@ -0,0 +1,388 @@
+/**
+ * \file vdml_link_transport.c
+ *
+ * \brief Reliable message transport for robot to robot communications.
+ *
+ * Messages are split into frames of up to LINK_TRANSPORT_FRAME_PAYLOAD bytes:
+ *
+ *   0x33 0xCC | flags | seq | ack | length | session | peer | payload | CRC-16
+ *
+ * The CRC is CRC-16/CCITT-FALSE over everything after the sync bytes. Frames
+ * are sent with go-back-N: up to LINK_TRANSPORT_WINDOW data frames are in
+ * flight, every frame carries the sequence number the sender expects next
+ * from the other end as a cumulative acknowledgement, and if nothing new is
+ * acknowledged within the timeout every unacknowledged frame is sent again.
+ * The receiver only accepts the frame it expects next, so fragments always
+ * arrive in order. When a frame is corrupted, the parser drops one byte at a
+ * time until it finds the start of a frame whose CRC matches.
+ *
+ * Sequence numbers only mean something within a session. Each end picks a
+ * random 16-bit session number when it is set up, sends it in every frame as
+ * session, and echoes the last session it heard from the other end as peer.
+ * When a frame arrives with a session that is new, the other end has
+ * restarted with its sequence numbers back at zero, so the receiver starts
+ * expecting zero as well, drops any half-assembled message, and numbers its
+ * own unacknowledged frames from zero again. Acknowledgements and data are
+ * only taken from frames that echo our current session, since anything else
+ * was numbered for a session that no longer exists; such a frame is answered
+ * with an acknowledgement so the other end learns our session. The 16-bit
+ * fields are little endian, as is the CRC.
+ *
+ * The transport only needs the byte stream described by link_radio_s_t, so it
+ * can be run over an in-memory stand-in as well as a VEXlink radio.
+ *
+ * This file should not be modified by users, since it gets replaced whenever
+ * a kernel upgrade occurs.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "kapi.h"
+#include "pros/link.h"
+
+#define SYNC_0 0x33
+#define SYNC_1 0xCC
+#define HEADER_SIZE 10
+
+#define FLAG_DATA 0x01
+#define FLAG_ACK 0x02
+#define FLAG_MORE 0x80  // more fragments of the message follow
+
+#define DEFAULT_TIMEOUT 100  // ms
+
+static uint16_t _crc16(const uint8_t* data, uint32_t size) {
+	uint16_t crc = 0xFFFF;
+	for (uint32_t i = 0; i < size; i++) {
+		crc ^= (uint16_t)data[i] << 8;
+		for (int bit = 0; bit < 8; bit++) {
+			crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+		}
+	}
+	return crc;
+}
+
+// Sends one frame if the whole frame fits in the radio's buffer
+static bool _send_frame(link_transport_s_t* t, uint8_t flags, uint8_t seq, const uint8_t* payload, uint8_t length) {
+	uint8_t frame[LINK_TRANSPORT_FRAME_PAYLOAD + LINK_TRANSPORT_FRAME_OVERHEAD];
+	uint32_t size = length + LINK_TRANSPORT_FRAME_OVERHEAD;
+	if (t->radio.transmittable(t->radio.context) < size) return false;
+	frame[0] = SYNC_0;
+	frame[1] = SYNC_1;
+	frame[2] = flags;
+	frame[3] = seq;
+	frame[4] = t->rx_expected;
+	frame[5] = length;
+	frame[6] = t->session & 0xFF;
+	frame[7] = t->session >> 8;
+	frame[8] = t->peer_session & 0xFF;
+	frame[9] = t->peer_session >> 8;
+	memcpy(&frame[HEADER_SIZE], payload, length);
+	uint16_t crc = _crc16(&frame[2], HEADER_SIZE - 2 + length);
+	frame[HEADER_SIZE + length] = crc & 0xFF;
+	frame[HEADER_SIZE + length + 1] = crc >> 8;
+	t->radio.transmit(t->radio.context, frame, size);
+	// every frame carries the acknowledgement
+	t->ack_pending = false;
+	return true;
+}
+
+static void _rx_ring_write(link_transport_s_t* t, const uint8_t* data, uint32_t size) {
+	for (uint32_t i = 0; i < size; i++) {
+		t->rx_buffer[t->rx_head] = data[i];
+		t->rx_head = (t->rx_head + 1) % LINK_TRANSPORT_RX_BUFFER;
+	}
+	t->rx_used += size;
+}
+
+static void _rx_ring_read(link_transport_s_t* t, uint8_t* data, uint32_t size) {
+	for (uint32_t i = 0; i < size; i++) {
+		data[i] = t->rx_buffer[t->rx_tail];
+		t->rx_tail = (t->rx_tail + 1) % LINK_TRANSPORT_RX_BUFFER;
+	}
+	t->rx_used -= size;
+}
+
+static void _handle_ack(link_transport_s_t* t, uint8_t ack) {
+	uint8_t acked = ack - t->tx_seq;
+	if (acked == 0 || acked > t->tx_sent) return;
+	for (uint8_t i = 0; i < acked; i++) {
+		t->tx_mid_message = t->tx_frames[t->tx_base].flags & FLAG_MORE;
+		if (!t->tx_mid_message) t->stats.messages_sent++;
+		t->tx_base = (t->tx_base + 1) % LINK_TRANSPORT_TX_FRAMES;
+	}
+	t->tx_count -= acked;
+	t->tx_sent -= acked;
+	t->tx_resend = t->tx_resend > acked ? t->tx_resend - acked : 0;
+	t->tx_seq += acked;
+	t->tx_last_progress = millis();
+}
+
+// The other end started a new session, so both directions start over from
+// sequence number zero
+static void _handle_restart(link_transport_s_t* t, uint16_t session) {
+	if (t->peer_session != 0) {
+		t->peer_session_prev = t->peer_session;
+		t->stats.peer_restarts++;
+	}
+	t->peer_session = session;
+	t->rx_expected = 0;
+	t->assembly_length = 0;
+	t->ack_pending = true;
+	// the rest of a message whose first fragments went to the old session would
+	// be put together with the wrong message, so drop it
+	while (t->tx_mid_message && t->tx_count > 0) {
+		t->tx_mid_message = t->tx_frames[t->tx_base].flags & FLAG_MORE;
+		t->tx_base = (t->tx_base + 1) % LINK_TRANSPORT_TX_FRAMES;
+		t->tx_count--;
+	}
+	t->tx_mid_message = false;
+	t->tx_seq = 0;
+	t->tx_sent = 0;
+	t->tx_resend = 0;
+	t->tx_last_progress = millis();
+}
+
+static void _handle_data(link_transport_s_t* t, uint8_t flags, uint8_t seq, const uint8_t* payload, uint8_t length) {
+	t->ack_pending = true;
+	if (seq != t->rx_expected) return;
+	if (t->assembly_length + length > LINK_TRANSPORT_MAX_MESSAGE) {
+		// the other end never sends this, so start over on the next message
+		t->assembly_length = 0;
+		return;
+	}
+	if (!(flags & FLAG_MORE)) {
+		uint32_t message_length = t->assembly_length + length;
+		// without room for the message, leave the frame unacknowledged so the
+		// sender tries again later
+		if (LINK_TRANSPORT_RX_BUFFER - t->rx_used < message_length + 2) return;
+		uint8_t prefix[2] = {message_length & 0xFF, message_length >> 8};
+		_rx_ring_write(t, prefix, 2);
+		_rx_ring_write(t, t->assembly, t->assembly_length);
+		_rx_ring_write(t, payload, length);
+		t->assembly_length = 0;
+		t->stats.messages_received++;
+	} else {
+		memcpy(&t->assembly[t->assembly_length], payload, length);
+		t->assembly_length += length;
+	}
+	t->rx_expected++;
+}
+
+static void _drop_parsed(link_transport_s_t* t, uint32_t count) {
+	t->parse_length -= count;
+	memmove(t->parse, &t->parse[count], t->parse_length);
+}
+
+static void _parse(link_transport_s_t* t) {
+	while (t->parse_length > 0) {
+		if (t->parse[0] != SYNC_0 || (t->parse_length > 1 && t->parse[1] != SYNC_1)) {
+			t->stats.resyncs++;
+			_drop_parsed(t, 1);
+			continue;
+		}
+		if (t->parse_length < HEADER_SIZE) return;
+		uint8_t length = t->parse[5];
+		if (length > LINK_TRANSPORT_FRAME_PAYLOAD) {
+			t->stats.resyncs++;
+			_drop_parsed(t, 1);
+			continue;
+		}
+		uint32_t size = length + LINK_TRANSPORT_FRAME_OVERHEAD;
+		if (t->parse_length < size) return;
+		uint16_t crc = t->parse[HEADER_SIZE + length] | (t->parse[HEADER_SIZE + length + 1] << 8);
+		if (crc != _crc16(&t->parse[2], HEADER_SIZE - 2 + length)) {
+			t->stats.crc_errors++;
+			_drop_parsed(t, 1);
+			continue;
+		}
+		uint16_t session = t->parse[6] | (t->parse[7] << 8);
+		uint16_t peer = t->parse[8] | (t->parse[9] << 8);
+		if (session == 0 || (session != t->peer_session && session == t->peer_session_prev)) {
+			// left over from before the other end restarted
+			_drop_parsed(t, size);
+			continue;
+		}
+		t->stats.frames_received++;
+		if (session != t->peer_session) _handle_restart(t, session);
+		uint8_t flags = t->parse[2];
+		if (peer != t->session) {
+			t->ack_pending = true;
+		} else {
+			_handle_ack(t, t->parse[4]);
+			if (flags & FLAG_DATA) {
+				_handle_data(t, flags, t->parse[3], &t->parse[HEADER_SIZE], length);
+			}
+		}
+		_drop_parsed(t, size);
+	}
+}
+
+static void _poll(link_transport_s_t* t) {
+	// receive
+	uint8_t chunk[64];
+	uint32_t received;
+	while ((received = t->radio.receive(t->radio.context, chunk, sizeof(chunk))) > 0) {
+		for (uint32_t i = 0; i < received; i++) {
+			t->parse[t->parse_length++] = chunk[i];
+			_parse(t);
+		}
+		if (received < sizeof(chunk)) break;
+	}
+
+	// go back to the oldest unacknowledged frame if the other end stopped
+	// acknowledging
+	uint32_t now = millis();
+	if (t->tx_sent > 0 && now - t->tx_last_progress > t->timeout) {
+		t->tx_resend = 0;
+		t->tx_last_progress = now;
+	}
+
+	// send
+	while (t->tx_resend < t->tx_count && t->tx_resend < LINK_TRANSPORT_WINDOW) {
+		uint32_t index = (t->tx_base + t->tx_resend) % LINK_TRANSPORT_TX_FRAMES;
+		uint8_t flags = t->tx_frames[index].flags;
+		if (!_send_frame(t, flags, t->tx_seq + t->tx_resend, t->tx_frames[index].payload, t->tx_frames[index].length)) {
+			break;
+		}
+		t->stats.frames_sent++;
+		if (t->tx_resend < t->tx_sent) {
+			t->stats.retransmissions++;
+		} else {
+			if (t->tx_sent == 0) t->tx_last_progress = now;
+			t->tx_sent++;
+		}
+		t->tx_resend++;
+	}
+	if (t->ack_pending) {
+		_send_frame(t, FLAG_ACK, 0, NULL, 0);
+	}
+}
+
+// Picks a session number that is unlikely to match the one used before a
+// restart. Programs start at different times after power on, so the low bits
+// of the timer differ between runs, and the counter keeps transports set up
+// in the same microsecond apart.
+static uint16_t _new_session(link_transport_s_t* t) {
+	static uint16_t counter = 0;
+	uint64_t now = micros();
+	uint16_t session = (uint16_t)(now ^ (now >> 16) ^ ((uint32_t)t >> 2)) + ++counter * 0x9E37;
+	return session != 0 ? session : 1;
+}
+
+int32_t link_transport_init_radio(link_transport_s_t* transport, const link_radio_s_t* radio) {
+	if (transport == NULL || radio == NULL || radio->transmit == NULL || radio->receive == NULL ||
+	    radio->transmittable == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	memset(transport, 0, sizeof(*transport));
+	transport->mutex = mutex_create();
+	if (transport->mutex == NULL) {
+		errno = ENOMEM;
+		return PROS_ERR;
+	}
+	transport->radio = *radio;
+	transport->timeout = DEFAULT_TIMEOUT;
+	transport->session = _new_session(transport);
+	return 1;
+}
+
+int32_t link_transport_set_timeout(link_transport_s_t* transport, uint32_t timeout) {
+	if (transport == NULL || timeout == 0) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	transport->timeout = timeout;
+	return 1;
+}
+
+int32_t link_transport_send(link_transport_s_t* transport, const void* data, uint32_t size) {
+	if (transport == NULL || data == NULL || size == 0) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	if (size > LINK_TRANSPORT_MAX_MESSAGE) {
+		errno = EMSGSIZE;
+		return PROS_ERR;
+	}
+	link_transport_s_t* t = transport;
+	uint32_t fragments = (size + LINK_TRANSPORT_FRAME_PAYLOAD - 1) / LINK_TRANSPORT_FRAME_PAYLOAD;
+	mutex_take(t->mutex, TIMEOUT_MAX);
+	if (LINK_TRANSPORT_TX_FRAMES - t->tx_count < fragments) {
+		_poll(t);
+		if (LINK_TRANSPORT_TX_FRAMES - t->tx_count < fragments) {
+			mutex_give(t->mutex);
+			errno = EBUSY;
+			return PROS_ERR;
+		}
+	}
+	const uint8_t* bytes = (const uint8_t*)data;
+	for (uint32_t i = 0; i < fragments; i++) {
+		uint32_t index = (t->tx_base + t->tx_count) % LINK_TRANSPORT_TX_FRAMES;
+		uint32_t length = size > LINK_TRANSPORT_FRAME_PAYLOAD ? LINK_TRANSPORT_FRAME_PAYLOAD : size;
+		t->tx_frames[index].flags = FLAG_DATA | (i + 1 < fragments ? FLAG_MORE : 0);
+		t->tx_frames[index].length = length;
+		memcpy(t->tx_frames[index].payload, bytes, length);
+		bytes += length;
+		size -= length;
+		t->tx_count++;
+	}
+	_poll(t);
+	mutex_give(t->mutex);
+	return 1;
+}
+
+int32_t link_transport_receive(link_transport_s_t* transport, void* dest, uint32_t size) {
+	if (transport == NULL || dest == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	link_transport_s_t* t = transport;
+	mutex_take(t->mutex, TIMEOUT_MAX);
+	_poll(t);
+	if (t->rx_used == 0) {
+		mutex_give(t->mutex);
+		return 0;
+	}
+	uint32_t length = t->rx_buffer[t->rx_tail] | (t->rx_buffer[(t->rx_tail + 1) % LINK_TRANSPORT_RX_BUFFER] << 8);
+	if (length > size) {
+		mutex_give(t->mutex);
+		errno = EMSGSIZE;
+		return PROS_ERR;
+	}
+	uint8_t prefix[2];
+	_rx_ring_read(t, prefix, 2);
+	_rx_ring_read(t, (uint8_t*)dest, length);
+	mutex_give(t->mutex);
+	return length;
+}
+
+int32_t link_transport_poll(link_transport_s_t* transport) {
+	if (transport == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	mutex_take(transport->mutex, TIMEOUT_MAX);
+	_poll(transport);
+	int32_t rtn = transport->tx_count;
+	mutex_give(transport->mutex);
+	return rtn;
+}
+
+int32_t link_transport_get_stats(link_transport_s_t* transport, link_transport_stats_s_t* stats) {
+	if (transport == NULL || stats == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	mutex_take(transport->mutex, TIMEOUT_MAX);
+	*stats = transport->stats;
+	mutex_give(transport->mutex);
+	return 1;
+}
@@ -22,6 +22,21 @@
 #define MIN_INTEGRATION_TIME 3 // ms
 #define MAX_INTEGRATION_TIME 712 // ms
 
+typedef struct optical_data {
+	// Classifier state used by optical_background_processing. The background
+	// task is the only writer of event_head and the reader the only writer of
+	// event_tail.
+	const optical_band_s_t* bands;
+	uint32_t band_count;
+	optical_event_s_t* events;
+	uint32_t event_capacity;
+	volatile uint32_t event_head;
+	volatile uint32_t event_tail;
+	uint32_t last_timestamp;
+	uint32_t dropped;
+	uint8_t band;
+} optical_data_s_t;
+
 double optical_get_hue(uint8_t port) {
 	claim_port_i(port - 1, E_DEVICE_OPTICAL);
 	double rtn = vexDeviceOpticalHueGet(device->device_info);
@@ -156,3 +171,107 @@ int32_t optical_set_integration_time(uint8_t port, double time) {
 	vexDeviceOpticalIntegrationTimeSet(device->device_info, time);
 	return_port(port - 1, PROS_SUCCESS);
 }
+
+uint8_t optical_classify(const optical_band_s_t* bands, uint32_t band_count, double hue, double saturation,
+                         int32_t proximity) {
+	for (uint32_t i = 0; i < band_count; i++) {
+		const optical_band_s_t* band = &bands[i];
+		if (saturation < band->saturation_min || proximity < band->proximity_min || proximity > band->proximity_max) {
+			continue;
+		}
+		bool in_hue = band->hue_min <= band->hue_max ? (hue >= band->hue_min && hue <= band->hue_max)
+		                                             : (hue >= band->hue_min || hue <= band->hue_max);
+		if (in_hue) return i;
+	}
+	return OPTICAL_BAND_NONE;
+}
+
+int32_t optical_classifier_start(uint8_t port, const optical_band_s_t* bands, uint32_t band_count,
+                                 optical_event_s_t* events, uint32_t capacity) {
+	if (bands == NULL || events == NULL || band_count == 0 || band_count >= OPTICAL_BAND_NONE || capacity < 2) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	claim_port_i(port - 1, E_DEVICE_OPTICAL);
+	optical_data_s_t* data = (optical_data_s_t*)device->pad;
+	data->events = NULL;
+	data->bands = bands;
+	data->band_count = band_count;
+	data->event_capacity = capacity;
+	data->event_head = 0;
+	data->event_tail = 0;
+	data->last_timestamp = 0;
+	data->dropped = 0;
+	data->band = OPTICAL_BAND_NONE;
+	data->events = events;
+	return_port(port - 1, PROS_SUCCESS);
+}
+
+int32_t optical_classifier_stop(uint8_t port) {
+	claim_port_i(port - 1, E_DEVICE_OPTICAL);
+	((optical_data_s_t*)device->pad)->events = NULL;
+	return_port(port - 1, PROS_SUCCESS);
+}
+
+int32_t optical_classifier_read(uint8_t port, optical_event_s_t* events, uint32_t max) {
+	claim_port_i(port - 1, E_DEVICE_OPTICAL);
+	optical_data_s_t* data = (optical_data_s_t*)device->pad;
+	if (data->events == NULL) {
+		errno = ENOENT;
+		return_port(port - 1, PROS_ERR);
+	}
+	uint32_t tail = data->event_tail;
+	uint32_t head = data->event_head;
+	__sync_synchronize();  // read events only after seeing the new head
+	uint32_t count = 0;
+	while (tail != head && count < max) {
+		events[count++] = data->events[tail];
+		tail = (tail + 1) % data->event_capacity;
+	}
+	__sync_synchronize();  // finish reading before releasing the slots
+	data->event_tail = tail;
+	return_port(port - 1, count);
+}
+
+int32_t optical_classifier_get_dropped(uint8_t port) {
+	claim_port_i(port - 1, E_DEVICE_OPTICAL);
+	int32_t dropped = ((optical_data_s_t*)device->pad)->dropped;
+	return_port(port - 1, dropped);
+}
+
+void optical_background_processing() {
+	for (int i = 0; i < NUM_V5_PORTS; i++) {
+		v5_smart_device_s_t* device = registry_get_device(i);
+		optical_data_s_t* data = (optical_data_s_t*)device->pad;
+		if (device->device_type != E_DEVICE_OPTICAL || data->events == NULL) continue;
+		if (registry_get_plugged_type(i) != E_DEVICE_OPTICAL) continue;
+		// only classify each reading from the sensor once
+		uint32_t timestamp = vexDeviceGetTimestamp(device->device_info);
+		if (timestamp == data->last_timestamp) continue;
+		data->last_timestamp = timestamp;
+
+		double hue = vexDeviceOpticalHueGet(device->device_info);
+		double saturation = vexDeviceOpticalSatGet(device->device_info);
+		int32_t proximity = vexDeviceOpticalProximityGet(device->device_info);
+		uint8_t band = optical_classify(data->bands, data->band_count, hue, saturation, proximity);
+		if (band == data->band) continue;
+
+		uint32_t head = data->event_head;
+		uint32_t next = (head + 1) % data->event_capacity;
+		if (next == data->event_tail) {
+			// leave the band unchanged so the change is reported once there is room
+			data->dropped++;
+			continue;
+		}
+		optical_event_s_t* event = &data->events[head];
+		event->timestamp = timestamp;
+		event->band = band;
+		event->previous = data->band;
+		event->hue = hue;
+		event->saturation = saturation;
+		event->proximity = proximity;
+		data->band = band;
+		__sync_synchronize();  // publish the event before the new head
+		data->event_head = next;
+	}
+}
@@ -77,6 +77,19 @@ std::int32_t Optical::set_integration_time(double time) {
   return optical_set_integration_time(_port, time);
 }
 
+std::int32_t Optical::start_classifier(const optical_band_s_t* bands, std::uint32_t band_count,
+                                       optical_event_s_t* events, std::uint32_t capacity) {
+  return optical_classifier_start(_port, bands, band_count, events, capacity);
+}
+
+std::int32_t Optical::stop_classifier() {
+  return optical_classifier_stop(_port);
+}
+
+std::int32_t Optical::read_events(optical_event_s_t* events, std::uint32_t max) {
+  return optical_classifier_read(_port, events, max);
+}
+
 std::uint8_t Optical::get_port(){
   return _port;
 }
@@ -11,7 +11,10 @@
  */
 
 #include <errno.h>
+#include <string.h>
 
+#include "common/matrix.h"
+#include "kapi.h"
 #include "pros/rotation.h"
 #include "v5_api.h"
 #include "vdml/registry.h"
@@ -19,9 +22,30 @@
 
 #define ROTATION_RESET_TIMEOUT 1000
 
+// Background velocity estimation. These don't fit in the device pad, so they
+// are kept per port here. Everything but the published estimate is only
+// touched with the port mutex held.
+typedef struct rotation_estimator_port {
+	rotation_estimator_s_t estimator;
+	volatile bool running;
+	uint32_t last_timestamp;
+	// Writers bump the sequence number to an odd value before writing and back
+	// to an even value after, and readers retry if it changed.
+	volatile uint32_t seq;
+	rotation_estimate_s_t published;
+} rotation_estimator_port_s_t;
+
+static rotation_estimator_port_s_t _rotation_estimators[NUM_V5_PORTS];
+
+static void _rotation_estimator_clear(uint8_t port) {
+	_rotation_estimators[port].estimator.count = 0;
+	_rotation_estimators[port].estimator.velocity = 0;
+}
+
 int32_t rotation_reset(uint8_t port) {
 	claim_port_i(port - 1, E_DEVICE_ROTATION);
 	vexDeviceAbsEncReset(device->device_info);
+	_rotation_estimator_clear(port - 1);
 	return_port(port - 1, PROS_SUCCESS);
 }
 
@@ -42,12 +66,14 @@ int32_t rotation_set_data_rate(uint8_t port, uint32_t rate) {
 int32_t rotation_reset_position(uint8_t port) {
 	claim_port_i(port - 1, E_DEVICE_ROTATION);
 	vexDeviceAbsEncPositionSet(device->device_info, 0);
+	_rotation_estimator_clear(port - 1);
 	return_port(port - 1, PROS_SUCCESS);
 }
 
 int32_t rotation_set_position(uint8_t port, uint32_t position) {
 	claim_port_i(port - 1, E_DEVICE_ROTATION);
 	vexDeviceAbsEncPositionSet(device->device_info, position);
+	_rotation_estimator_clear(port - 1);
 	return_port(port - 1, PROS_SUCCESS);
 }
 
@@ -105,4 +131,178 @@ int32_t rotation_get_reversed(uint8_t port) {
 	claim_port_i(port - 1, E_DEVICE_ROTATION);
 	int32_t rtn = vexDeviceAbsEncReverseFlagGet(device->device_info);
 	return_port(port - 1, rtn);
-}
\ No newline at end of file
+}
+
+int32_t rotation_estimator_init(rotation_estimator_s_t* estimator, const rotation_estimator_config_s_t* config) {
+	if (estimator == NULL || config == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	bool valid;
+	switch (config->type) {
+		case E_ROTATION_ESTIMATOR_WINDOW:
+			valid = config->window >= 2 && config->window <= ROTATION_ESTIMATOR_MAX_WINDOW;
+			break;
+		case E_ROTATION_ESTIMATOR_ALPHA_BETA:
+			valid = config->alpha > 0 && config->alpha <= 1 && config->beta > 0 && config->beta < 2;
+			break;
+		case E_ROTATION_ESTIMATOR_SAVITZKY_GOLAY:
+			valid = config->window >= 3 && config->window <= ROTATION_ESTIMATOR_MAX_WINDOW;
+			break;
+		default:
+			valid = false;
+	}
+	if (!valid) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	memset(estimator, 0, sizeof(*estimator));
+	estimator->config = *config;
+	return 1;
+}
+
+// Slope at the newest sample of a least squares quadratic through the window.
+// Times and positions are taken relative to the newest sample to keep the
+// normal equations well conditioned.
+static double _rotation_savitzky_golay(const rotation_estimator_s_t* est, uint32_t count) {
+	uint32_t newest = (est->head + ROTATION_ESTIMATOR_MAX_WINDOW - 1) % ROTATION_ESTIMATOR_MAX_WINDOW;
+	double sums[5] = {0};
+	double rhs[3] = {0};
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t idx = (newest + ROTATION_ESTIMATOR_MAX_WINDOW - i) % ROTATION_ESTIMATOR_MAX_WINDOW;
+		double t = -(double)(est->timestamps[newest] - est->timestamps[idx]);
+		double p = est->positions[idx] - est->positions[newest];
+		double tk = 1;
+		for (int k = 0; k < 5; k++) {
+			if (k < 3) rhs[k] += p * tk;
+			sums[k] += tk;
+			tk *= t;
+		}
+	}
+	mat3_s_t normal = {{{sums[0], sums[1], sums[2]}, {sums[1], sums[2], sums[3]}, {sums[2], sums[3], sums[4]}}};
+	if (!mat3_inverse(&normal, &normal)) return est->velocity;
+	double coefficients[3];
+	mat3_mul_vec(coefficients, &normal, rhs);
+	return coefficients[1] * 1000;
+}
+
+double rotation_estimator_step(rotation_estimator_s_t* estimator, uint32_t timestamp, int32_t position) {
+	rotation_estimator_s_t* est = estimator;
+	uint32_t newest = (est->head + ROTATION_ESTIMATOR_MAX_WINDOW - 1) % ROTATION_ESTIMATOR_MAX_WINDOW;
+	if (est->count > 0 && (int32_t)(timestamp - est->timestamps[newest]) <= 0) {
+		return est->velocity;
+	}
+
+	if (est->config.type == E_ROTATION_ESTIMATOR_ALPHA_BETA) {
+		if (est->count == 0) {
+			est->filter_position = position;
+			est->velocity = 0;
+		} else {
+			double dt = (timestamp - est->timestamps[newest]) / 1000.0;
+			double predicted = est->filter_position + est->velocity * dt;
+			double residual = position - predicted;
+			est->filter_position = predicted + est->config.alpha * residual;
+			est->velocity += est->config.beta * residual / dt;
+		}
+	}
+
+	est->timestamps[est->head] = timestamp;
+	est->positions[est->head] = position;
+	est->head = (est->head + 1) % ROTATION_ESTIMATOR_MAX_WINDOW;
+	if (est->count < ROTATION_ESTIMATOR_MAX_WINDOW) est->count++;
+
+	uint32_t count = est->count < est->config.window ? est->count : est->config.window;
+	switch (est->config.type) {
+		case E_ROTATION_ESTIMATOR_WINDOW:
+			if (count >= 2) {
+				uint32_t oldest = (est->head + ROTATION_ESTIMATOR_MAX_WINDOW - count) % ROTATION_ESTIMATOR_MAX_WINDOW;
+				est->velocity = (double)(position - est->positions[oldest]) * 1000 / (timestamp - est->timestamps[oldest]);
+			}
+			break;
+		case E_ROTATION_ESTIMATOR_SAVITZKY_GOLAY:
+			if (count >= 3) {
+				est->velocity = _rotation_savitzky_golay(est, count);
+			}
+			break;
+		default:
+			break;
+	}
+	return est->velocity;
+}
+
+// Copies the latest estimate out for rotation_get_estimate(). Callers outside
+// the system daemon suspend the scheduler around this, or a higher priority
+// reader could spin forever waiting on a preempted publish.
+static void _rotation_publish(rotation_estimator_port_s_t* port, uint32_t timestamp, int32_t position) {
+	port->seq++;
+	__sync_synchronize();
+	port->published.timestamp = timestamp;
+	port->published.position = position;
+	port->published.velocity = port->estimator.velocity;
+	__sync_synchronize();
+	port->seq++;
+}
+
+int32_t rotation_estimator_start(uint8_t port, const rotation_estimator_config_s_t* config) {
+	claim_port_i(port - 1, E_DEVICE_ROTATION);
+	rotation_estimator_port_s_t* est = &_rotation_estimators[port - 1];
+	est->running = false;
+	if (rotation_estimator_init(&est->estimator, config) != 1) {
+		return_port(port - 1, PROS_ERR);
+	}
+	uint32_t timestamp = vexDeviceGetTimestamp(device->device_info);
+	int32_t position = vexDeviceAbsEncPositionGet(device->device_info);
+	rotation_estimator_step(&est->estimator, timestamp, position);
+	est->last_timestamp = timestamp;
+	rtos_suspend_all();
+	_rotation_publish(est, timestamp, position);
+	rtos_resume_all();
+	est->running = true;
+	return_port(port - 1, PROS_SUCCESS);
+}
+
+int32_t rotation_estimator_stop(uint8_t port) {
+	claim_port_i(port - 1, E_DEVICE_ROTATION);
+	_rotation_estimators[port - 1].running = false;
+	return_port(port - 1, PROS_SUCCESS);
+}
+
+#define ESTIMATE_ERR_INIT \
+	{ .timestamp = PROS_ERR, .position = PROS_ERR, .velocity = PROS_ERR_F }
+
+rotation_estimate_s_t rotation_get_estimate(uint8_t port) {
+	rotation_estimate_s_t rtn = ESTIMATE_ERR_INIT;
+	if (!VALIDATE_PORT_NO(port - 1)) {
+		errno = ENXIO;
+		return rtn;
+	}
+	rotation_estimator_port_s_t* est = &_rotation_estimators[port - 1];
+	if (!est->running) {
+		errno = ENOENT;
+		return rtn;
+	}
+	uint32_t seq;
+	do {
+		seq = est->seq;
+		__sync_synchronize();
+		rtn = est->published;
+		__sync_synchronize();
+	} while ((seq & 1) || seq != est->seq);
+	return rtn;
+}
+
+void rotation_background_processing() {
+	for (int i = 0; i < NUM_V5_PORTS; i++) {
+		rotation_estimator_port_s_t* est = &_rotation_estimators[i];
+		if (!est->running) continue;
+		v5_smart_device_s_t* device = registry_get_device(i);
+		if (device->device_type != E_DEVICE_ROTATION || registry_get_plugged_type(i) != E_DEVICE_ROTATION) continue;
+		// only step on each packet from the sensor once
+		uint32_t timestamp = vexDeviceGetTimestamp(device->device_info);
+		if (timestamp == est->last_timestamp) continue;
+		est->last_timestamp = timestamp;
+		int32_t position = vexDeviceAbsEncPositionGet(device->device_info);
+		rotation_estimator_step(&est->estimator, timestamp, position);
+		_rotation_publish(est, timestamp, position);
+	}
+}
@@ -58,4 +58,16 @@ std::int32_t Rotation::get_reversed(void) {
     return pros::c::rotation_get_reversed(_port);
 }
 
+std::int32_t Rotation::start_estimator(const pros::c::rotation_estimator_config_s_t& config) {
+    return pros::c::rotation_estimator_start(_port, &config);
+}
+
+std::int32_t Rotation::stop_estimator(void) {
+    return pros::c::rotation_estimator_stop(_port);
+}
+
+pros::c::rotation_estimate_s_t Rotation::get_estimate(void) {
+    return pros::c::rotation_get_estimate(_port);
+}
+
 }  // namespace pros
@@ -13,13 +13,90 @@
 #include <errno.h>
 #include <math.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "kapi.h"
 #include "pros/serial.h"
+#include "system/dev/wait.h"
 #include "v5_api.h"
 #include "vdml/registry.h"
 #include "vdml/vdml.h"
 
+// Receive ring filled by serial_background_processing. The background task is
+// the only writer of ring_head and the reader the only writer of ring_tail.
+typedef struct serial_data {
+	uint8_t* ring;
+	uint32_t ring_capacity;
+	volatile uint32_t ring_head;
+	volatile uint32_t ring_tail;
+	uint32_t ring_high_water;
+} serial_data_s_t;
+
+static serial_data_s_t* _serial_data(uint8_t port) {
+	return (serial_data_s_t*)registry_get_device(port - 1)->pad;
+}
+
+static uint32_t _serial_ring_count(serial_data_s_t* data) {
+	return (data->ring_head + data->ring_capacity - data->ring_tail) % data->ring_capacity;
+}
+
+// Copies up to length bytes out of the ring, optionally leaving them in place
+static int32_t _serial_ring_read(serial_data_s_t* data, uint8_t* buffer, uint32_t length, bool consume) {
+	uint32_t tail = data->ring_tail;
+	uint32_t head = data->ring_head;
+	__sync_synchronize();  // read bytes only after seeing the new head
+	uint32_t count = (head + data->ring_capacity - tail) % data->ring_capacity;
+	if (count > length) count = length;
+	// at most two copies, split where the ring wraps
+	uint32_t first = data->ring_capacity - tail;
+	if (first > count) first = count;
+	memcpy(buffer, &data->ring[tail], first);
+	memcpy(buffer + first, data->ring, count - first);
+	if (consume) {
+		__sync_synchronize();  // finish reading before releasing the bytes
+		data->ring_tail = (tail + count) % data->ring_capacity;
+	}
+	return count;
+}
+
+// The receive ring is read without the port mutex so readers never wait for
+// background processing, but the binding is still checked so the pad of a port
+// now bound to another type of device is never read as a ring. Returns NULL,
+// setting errno, if the ring can't be used.
+static serial_data_s_t* _serial_ring_claim(uint8_t port) {
+	if (!VALIDATE_PORT_NO(port - 1)) {
+		errno = EINVAL;
+		return NULL;
+	}
+	if (registry_validate_binding(port - 1, E_DEVICE_SERIAL) != 0) return NULL;
+	serial_data_s_t* data = _serial_data(port);
+	if (data->ring == NULL) {
+		errno = ENOENT;
+		return NULL;
+	}
+	return data;
+}
+
+#define SERIAL_ALL_PORTS ((1u << NUM_V5_PORTS) - 1)
+
+// Checks which of the given ports can be read or written without blocking. A
+// port that is not a generic serial port counts as ready, so reading it fails
+// instead of blocking forever.
+static uint32_t _serial_check_ready(uint32_t* rx_ports, uint32_t* tx_ports) {
+	int saved_errno = errno;
+	uint32_t rx_ready = 0;
+	uint32_t tx_ready = 0;
+	for (uint8_t port = 1; port <= NUM_V5_PORTS; port++) {
+		uint32_t bit = 1u << (port - 1);
+		if ((*rx_ports & bit) && serial_get_read_avail(port) != 0) rx_ready |= bit;
+		if ((*tx_ports & bit) && serial_get_write_free(port) != 0) tx_ready |= bit;
+	}
+	errno = saved_errno;
+	*rx_ports = rx_ready;
+	*tx_ports = tx_ready;
+	return __builtin_popcount(rx_ready) + __builtin_popcount(tx_ready);
+}
+
 // Control function
 
 int32_t serial_enable(uint8_t port) {
@@ -51,12 +128,17 @@ int32_t serial_set_baudrate(uint8_t port, int32_t baudrate) {
 int32_t serial_flush(uint8_t port) {
 	claim_port_i(port - 1, E_DEVICE_SERIAL);
 	vexDeviceGenericSerialFlush(device->device_info);
+	serial_data_s_t* data = (serial_data_s_t*)device->pad;
+	if (data->ring != NULL) data->ring_tail = data->ring_head;
 	return_port(port - 1, PROS_SUCCESS);
 }
 
 // Telemetry functions
 
 int32_t serial_get_read_avail(uint8_t port) {
+	if (registry_validate_binding(port - 1, E_DEVICE_SERIAL) == 0 && _serial_data(port)->ring != NULL) {
+		return _serial_ring_count(_serial_data(port));
+	}
 	claim_port_i(port - 1, E_DEVICE_SERIAL);
 	int32_t rtn = vexDeviceGenericSerialReceiveAvail(device->device_info);
 	return_port(port - 1, rtn);
@@ -71,23 +153,175 @@ int32_t serial_get_write_free(uint8_t port) {
 // Read functions
 
 int32_t serial_peek_byte(uint8_t port) {
+	if (registry_validate_binding(port - 1, E_DEVICE_SERIAL) == 0 && _serial_data(port)->ring != NULL) {
+		uint8_t byte;
+		return _serial_ring_read(_serial_data(port), &byte, 1, false) ? byte : -1;
+	}
 	claim_port_i(port - 1, E_DEVICE_SERIAL);
 	int32_t rtn = vexDeviceGenericSerialPeekChar(device->device_info);
 	return_port(port - 1, rtn);
 }
 
 int32_t serial_read_byte(uint8_t port) {
+	if (registry_validate_binding(port - 1, E_DEVICE_SERIAL) == 0 && _serial_data(port)->ring != NULL) {
+		uint8_t byte;
+		return _serial_ring_read(_serial_data(port), &byte, 1, true) ? byte : -1;
+	}
 	claim_port_i(port - 1, E_DEVICE_SERIAL);
 	int32_t rtn = vexDeviceGenericSerialReadChar(device->device_info);
 	return_port(port - 1, rtn);
 }
 
 int32_t serial_read(uint8_t port, uint8_t* buffer, int32_t length) {
+	if (registry_validate_binding(port - 1, E_DEVICE_SERIAL) == 0 && _serial_data(port)->ring != NULL) {
+		return length > 0 ? _serial_ring_read(_serial_data(port), buffer, length, true) : 0;
+	}
 	claim_port_i(port - 1, E_DEVICE_SERIAL);
 	int32_t rtn = vexDeviceGenericSerialReceive(device->device_info, buffer, length);
 	return_port(port - 1, rtn);
 }
 
+typedef struct {
+	uint32_t rx_ports, tx_ports;
+	uint32_t rx_ready, tx_ready;
+} serial_wait_arg_t;
+
+static int32_t _serial_wait_check(void* arg, uint64_t* sources) {
+	serial_wait_arg_t* wait = (serial_wait_arg_t*)arg;
+	wait->rx_ready = wait->rx_ports;
+	wait->tx_ready = wait->tx_ports;
+	return _serial_check_ready(&wait->rx_ready, &wait->tx_ready);
+}
+
+int32_t serial_wait(uint32_t* rx_ports, uint32_t* tx_ports, uint32_t timeout) {
+	if (rx_ports == NULL || tx_ports == NULL || ((*rx_ports | *tx_ports) & ~SERIAL_ALL_PORTS) ||
+	    (*rx_ports | *tx_ports) == 0) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	serial_wait_arg_t wait = {.rx_ports = *rx_ports, .tx_ports = *tx_ports};
+	// the receive and transmit masks line up with the wait sources
+	int32_t ready = io_wait_for(*rx_ports | (uint64_t)*tx_ports << NUM_V5_PORTS, _serial_wait_check, &wait, timeout);
+	*rx_ports = wait.rx_ready;
+	*tx_ports = wait.tx_ready;
+	return ready;
+}
+
+// Waits for more bytes on a port for what is left of a timeout
+static void _serial_wait_rx(uint8_t port, uint32_t timeout, uint32_t elapsed) {
+	uint32_t rx_ports = 1u << (port - 1);
+	uint32_t tx_ports = 0;
+	serial_wait(&rx_ports, &tx_ports, timeout == TIMEOUT_MAX ? TIMEOUT_MAX : timeout - elapsed);
+}
+
+int32_t serial_read_timeout(uint8_t port, uint8_t* buffer, int32_t length, uint32_t timeout) {
+	serial_data_s_t* data = _serial_ring_claim(port);
+	if (data == NULL) return PROS_ERR;
+	uint32_t start = millis();
+	int32_t count = 0;
+	while (true) {
+		if (length > count) count += _serial_ring_read(data, buffer + count, length - count, true);
+		uint32_t elapsed = millis() - start;
+		if (count >= length || elapsed >= timeout) return count;
+		_serial_wait_rx(port, timeout, elapsed);
+	}
+}
+
+int32_t serial_read_until(uint8_t port, uint8_t* buffer, int32_t length, uint8_t delimiter, uint32_t timeout) {
+	if (length <= 0) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	serial_data_s_t* data = _serial_ring_claim(port);
+	if (data == NULL) return PROS_ERR;
+	uint32_t start = millis();
+	// bytes already checked for the delimiter, so each byte is only scanned once
+	uint32_t scanned = 0;
+	while (true) {
+		uint32_t tail = data->ring_tail;
+		uint32_t avail = _serial_ring_count(data);
+		__sync_synchronize();  // read bytes only after seeing the new head
+		while (scanned < avail && scanned < (uint32_t)length) {
+			if (data->ring[(tail + scanned++) % data->ring_capacity] == delimiter) {
+				return _serial_ring_read(data, buffer, scanned, true);
+			}
+		}
+		if (scanned >= (uint32_t)length) return _serial_ring_read(data, buffer, length, true);
+		uint32_t elapsed = millis() - start;
+		if (elapsed >= timeout) {
+			errno = ETIMEDOUT;
+			return PROS_ERR;
+		}
+		_serial_wait_rx(port, timeout, elapsed);
+	}
+}
+
+int32_t serial_rx_buffer_start(uint8_t port, uint8_t* buffer, uint32_t capacity) {
+	if (buffer == NULL || capacity < 2) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	claim_port_i(port - 1, E_DEVICE_SERIAL);
+	serial_data_s_t* data = (serial_data_s_t*)device->pad;
+	data->ring = NULL;
+	data->ring_capacity = capacity;
+	data->ring_head = 0;
+	data->ring_tail = 0;
+	data->ring_high_water = 0;
+	data->ring = buffer;
+	return_port(port - 1, PROS_SUCCESS);
+}
+
+int32_t serial_rx_buffer_stop(uint8_t port) {
+	claim_port_i(port - 1, E_DEVICE_SERIAL);
+	((serial_data_s_t*)device->pad)->ring = NULL;
+	return_port(port - 1, PROS_SUCCESS);
+}
+
+int32_t serial_rx_buffer_peek(uint8_t port, uint32_t offset, uint8_t** data) {
+	if (data == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	serial_data_s_t* ring = _serial_ring_claim(port);
+	if (ring == NULL) return PROS_ERR;
+	uint32_t count = _serial_ring_count(ring);
+	__sync_synchronize();  // read bytes only after seeing the new head
+	if (offset >= count) {
+		*data = NULL;
+		return 0;
+	}
+	uint32_t index = (ring->ring_tail + offset) % ring->ring_capacity;
+	uint32_t contiguous = count - offset;
+	if (contiguous > ring->ring_capacity - index) contiguous = ring->ring_capacity - index;
+	*data = &ring->ring[index];
+	return contiguous;
+}
+
+int32_t serial_rx_buffer_consume(uint8_t port, uint32_t count) {
+	serial_data_s_t* data = _serial_ring_claim(port);
+	if (data == NULL) return PROS_ERR;
+	if (count > _serial_ring_count(data)) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	__sync_synchronize();  // finish reading before releasing the bytes
+	data->ring_tail = (data->ring_tail + count) % data->ring_capacity;
+	return PROS_SUCCESS;
+}
+
+int32_t serial_rx_buffer_get_high_water(uint8_t port) {
+	serial_data_s_t* data = _serial_ring_claim(port);
+	if (data == NULL) return PROS_ERR;
+	return data->ring_high_water;
+}
+
+int32_t serial_rx_buffer_get_capacity(uint8_t port) {
+	serial_data_s_t* data = _serial_ring_claim(port);
+	if (data == NULL) return PROS_ERR;
+	return data->ring_capacity - 1;
+}
+
 // Write functions
 
 int32_t serial_write_byte(uint8_t port, uint8_t buffer) {
@@ -109,3 +343,56 @@ int32_t serial_write(uint8_t port, uint8_t* buffer, int32_t length) {
 	}
 	return_port(port - 1, rtn);
 }
+
+// Wakes tasks waiting for a port that is now ready. Run from background
+// processing with every port mutex held.
+static void _serial_wake_waiters(void) {
+	uint64_t wanted = io_wait_sources();
+	if (wanted == 0) return;
+	uint64_t ready = 0;
+	for (int i = 0; i < NUM_V5_PORTS; i++) {
+		uint64_t rx = WAIT_SERIAL_RX(i + 1);
+		uint64_t tx = WAIT_SERIAL_TX(i + 1);
+		if (!(wanted & (rx | tx))) continue;
+		v5_smart_device_s_t* device = registry_get_device(i);
+		// the pad only holds serial data while the port is bound as serial
+		if (device->device_type != E_DEVICE_SERIAL || registry_get_plugged_type(i) != E_DEVICE_SERIAL) continue;
+		serial_data_s_t* data = (serial_data_s_t*)device->pad;
+		if ((wanted & rx) && (data->ring != NULL ? _serial_ring_count(data) > 0
+		                                         : vexDeviceGenericSerialReceiveAvail(device->device_info) > 0)) {
+			ready |= rx;
+		}
+		if ((wanted & tx) && vexDeviceGenericSerialWriteFree(device->device_info) > 0) ready |= tx;
+	}
+	io_wake(ready);
+}
+
+void serial_background_processing() {
+	for (int i = 0; i < NUM_V5_PORTS; i++) {
+		v5_smart_device_s_t* device = registry_get_device(i);
+		serial_data_s_t* data = (serial_data_s_t*)device->pad;
+		if (device->device_type != E_DEVICE_SERIAL || data->ring == NULL) continue;
+		if (registry_get_plugged_type(i) != E_DEVICE_SERIAL) continue;
+		int32_t avail = vexDeviceGenericSerialReceiveAvail(device->device_info);
+		if (avail <= 0) continue;
+
+		// Drain into the free space with as few bulk receives as possible. When
+		// the ring is full the rest stays in the VEXos buffer for the next tick.
+		uint32_t head = data->ring_head;
+		uint32_t free = (data->ring_tail + data->ring_capacity - head - 1) % data->ring_capacity;
+		uint32_t want = (uint32_t)avail < free ? (uint32_t)avail : free;
+		while (want > 0) {
+			uint32_t span = data->ring_capacity - head;
+			if (span > want) span = want;
+			int32_t got = vexDeviceGenericSerialReceive(device->device_info, &data->ring[head], span);
+			if (got <= 0) break;
+			head = (head + got) % data->ring_capacity;
+			want -= got;
+		}
+		__sync_synchronize();  // publish the bytes before the new head
+		data->ring_head = head;
+		uint32_t count = _serial_ring_count(data);
+		if (count > data->ring_high_water) data->ring_high_water = count;
+	}
+	_serial_wake_waiters();
+}
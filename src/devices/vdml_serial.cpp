@@ -10,6 +10,9 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
+#include <cstring>
+
+#include "common/cobs.h"
 #include "kapi.h"
 #include "pros/serial.hpp"
 
@@ -57,6 +60,23 @@ std::int32_t Serial::read(std::uint8_t* buffer, std::int32_t length) const {
 	return serial_read(_port, buffer, length);
 }
 
+std::int32_t Serial::read_timeout(std::uint8_t* buffer, std::int32_t length, std::uint32_t timeout) const {
+	return serial_read_timeout(_port, buffer, length, timeout);
+}
+
+std::int32_t Serial::read_until(std::uint8_t* buffer, std::int32_t length, std::uint8_t delimiter,
+                                std::uint32_t timeout) const {
+	return serial_read_until(_port, buffer, length, delimiter, timeout);
+}
+
+std::int32_t Serial::start_rx_buffer(std::uint8_t* buffer, std::uint32_t capacity) const {
+	return serial_rx_buffer_start(_port, buffer, capacity);
+}
+
+std::int32_t Serial::stop_rx_buffer() const {
+	return serial_rx_buffer_stop(_port);
+}
+
 std::int32_t Serial::write_byte(std::uint8_t buffer) const {
 	return serial_write_byte(_port, buffer);
 }
@@ -65,6 +85,202 @@ std::int32_t Serial::write(std::uint8_t* buffer, std::int32_t length) const {
 	return serial_write(_port, buffer, length);
 }
 
+SerialRxSource::SerialRxSource(std::uint8_t port) : _port(port) {}
+
+std::int32_t SerialRxSource::peek(std::size_t offset, std::uint8_t** data) {
+	return serial_rx_buffer_peek(_port, offset, data);
+}
+
+std::int32_t SerialRxSource::consume(std::size_t count) {
+	return serial_rx_buffer_consume(_port, count);
+}
+
+std::size_t SerialSource::capacity() {
+	return 0;
+}
+
+std::size_t SerialRxSource::capacity() {
+	std::int32_t rtn = serial_rx_buffer_get_capacity(_port);
+	return rtn == PROS_ERR ? 0 : rtn;
+}
+
+SerialParser::SerialParser(std::uint8_t port, std::size_t max_frame)
+    : _max_frame(max_frame), _port_source(port), _source(_port_source), _scratch(new std::uint8_t[max_frame]) {}
+
+SerialParser::SerialParser(SerialSource& source, std::size_t max_frame)
+    : _max_frame(max_frame), _port_source(0), _source(source), _scratch(new std::uint8_t[max_frame]) {}
+
+std::int32_t SerialParser::_refresh() {
+	std::int32_t first = _source.peek(0, &_piece[0]);
+	if (first == PROS_ERR) return PROS_ERR;
+	_piece_size[0] = first;
+	_piece_size[1] = 0;
+	if (first > 0) {
+		std::int32_t second = _source.peek(first, &_piece[1]);
+		if (second == PROS_ERR) return PROS_ERR;
+		_piece_size[1] = second;
+	}
+	std::size_t capacity = _source.capacity();
+	_full = capacity != 0 && available() >= capacity;
+	return PROS_SUCCESS;
+}
+
+std::int32_t SerialParser::_consume(std::size_t count) {
+	_scanned = 0;
+	return _source.consume(count);
+}
+
+std::size_t SerialParser::available() const {
+	return _piece_size[0] + _piece_size[1];
+}
+
+std::uint8_t SerialParser::byte_at(std::size_t index) const {
+	return index < _piece_size[0] ? _piece[0][index] : _piece[1][index - _piece_size[0]];
+}
+
+std::int32_t SerialParser::decode(std::uint8_t* data, std::size_t length) {
+	return length;
+}
+
+std::int32_t SerialParser::next(SerialFrame& frame) {
+	if (release() == PROS_ERR) return PROS_ERR;
+	while (true) {
+		if (_refresh() == PROS_ERR) return PROS_ERR;
+		std::size_t start = 0, length = 0, consume = 0;
+		Scan result = scan(start, length, consume);
+		if (result == Scan::need_more) return 0;
+		if (result == Scan::frame) {
+			std::uint8_t* data;
+			if (start + length <= _piece_size[0]) {
+				data = _piece[0] + start;
+			} else if (start >= _piece_size[0]) {
+				data = _piece[1] + (start - _piece_size[0]);
+			} else {
+				// the frame wraps around the end of the ring
+				std::size_t first = _piece_size[0] - start;
+				std::memcpy(_scratch.get(), _piece[0] + start, first);
+				std::memcpy(_scratch.get() + first, _piece[1], length - first);
+				data = _scratch.get();
+			}
+			std::int32_t size = decode(data, length);
+			if (size >= 0) {
+				_pending = consume;
+				frame.data = data;
+				frame.size = size;
+				return 1;
+			}
+			_errors++;
+		}
+		if (_consume(consume) == PROS_ERR) return PROS_ERR;
+	}
+}
+
+std::int32_t SerialParser::next(SerialFrame& frame, std::uint32_t timeout) {
+	std::uint32_t start = millis();
+	while (true) {
+		std::int32_t rtn = next(frame);
+		if (rtn != 0 || millis() - start >= timeout) return rtn;
+		// the receive ring only fills once per daemon tick
+		delay(1);
+	}
+}
+
+std::int32_t SerialParser::release() {
+	if (_pending == 0) return PROS_SUCCESS;
+	std::size_t pending = _pending;
+	_pending = 0;
+	return _consume(pending);
+}
+
+std::uint32_t SerialParser::get_errors() const {
+	return _errors;
+}
+
+SerialDelimitedParser::SerialDelimitedParser(std::uint8_t port, std::size_t max_frame, std::uint8_t delimiter)
+    : SerialParser(port, max_frame), _delimiter(delimiter) {}
+
+SerialDelimitedParser::SerialDelimitedParser(SerialSource& source, std::size_t max_frame, std::uint8_t delimiter)
+    : SerialParser(source, max_frame), _delimiter(delimiter) {}
+
+SerialParser::Scan SerialDelimitedParser::scan(std::size_t& start, std::size_t& length, std::size_t& consume) {
+	std::size_t avail = available();
+	for (; _scanned < avail; _scanned++) {
+		if (byte_at(_scanned) == _delimiter) {
+			consume = _scanned + 1;
+			if (_discarding) {
+				_discarding = false;
+				return Scan::skip;
+			}
+			start = 0;
+			length = _scanned;
+			return Scan::frame;
+		}
+		if (_scanned >= _max_frame) {
+			// drop what has been seen so far and everything up to the next delimiter
+			if (!_discarding) _errors++;
+			_discarding = true;
+			consume = _scanned;
+			return Scan::skip;
+		}
+	}
+	if (_full && avail > 0) {
+		// the delimiter can never arrive, so treat the frame as oversized
+		if (!_discarding) _errors++;
+		_discarding = true;
+		consume = avail;
+		return Scan::skip;
+	}
+	return Scan::need_more;
+}
+
+SerialCobsParser::SerialCobsParser(std::uint8_t port, std::size_t max_frame)
+    : SerialDelimitedParser(port, max_frame, 0) {}
+
+SerialCobsParser::SerialCobsParser(SerialSource& source, std::size_t max_frame)
+    : SerialDelimitedParser(source, max_frame, 0) {}
+
+SerialParser::Scan SerialCobsParser::scan(std::size_t& start, std::size_t& length, std::size_t& consume) {
+	Scan result = SerialDelimitedParser::scan(start, length, consume);
+	// back to back delimiters are allowed and are not frames
+	if (result == Scan::frame && length == 0) return Scan::skip;
+	return result;
+}
+
+std::int32_t SerialCobsParser::decode(std::uint8_t* data, std::size_t length) {
+	return cobs_decode(data, data, length);
+}
+
+SerialLengthPrefixedParser::SerialLengthPrefixedParser(std::uint8_t port, std::size_t max_frame,
+                                                       std::uint8_t header_size)
+    : SerialParser(port, max_frame), _header_size(header_size == 1 ? 1 : 2) {}
+
+SerialLengthPrefixedParser::SerialLengthPrefixedParser(SerialSource& source, std::size_t max_frame,
+                                                       std::uint8_t header_size)
+    : SerialParser(source, max_frame), _header_size(header_size == 1 ? 1 : 2) {}
+
+SerialParser::Scan SerialLengthPrefixedParser::scan(std::size_t& start, std::size_t& length, std::size_t& consume) {
+	std::size_t avail = available();
+	if (avail < _header_size) {
+		if (!_full) return Scan::need_more;
+		_errors++;
+		consume = 1;
+		return Scan::skip;
+	}
+	std::size_t size = byte_at(0);
+	if (_header_size == 2) size |= byte_at(1) << 8;
+	// a frame longer than the ring can hold would never finish arriving
+	if (size > _max_frame || (_full && avail < _header_size + size)) {
+		_errors++;
+		consume = 1;
+		return Scan::skip;
+	}
+	if (avail < _header_size + size) return Scan::need_more;
+	start = _header_size;
+	length = size;
+	consume = _header_size + size;
+	return Scan::frame;
+}
+
 namespace literals {
 const pros::Serial operator"" _ser(const unsigned long long int m) {
 	return pros::Serial(m);
@@ -11,9 +11,163 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
 #include "kapi.h"
 #include "v5_api.h"
 
+#define BENCH_PATH_MAX 64
+
 int32_t usd_is_installed(void) {
 	return vexFileDriveStatus(0);
 }
+
+static int bench_compare(const void* a, const void* b) {
+	uint32_t x = *(const uint32_t*)a;
+	uint32_t y = *(const uint32_t*)b;
+	return (x > y) - (x < y);
+}
+
+// sorts the operation times and summarizes them. bytes were moved in total_us
+static void bench_summarize(usd_bench_stats_s_t* stats, uint32_t* samples, uint32_t count, uint64_t bytes,
+                            uint64_t total_us) {
+	qsort(samples, count, sizeof(*samples), bench_compare);
+	stats->bytes_per_sec = total_us ? (uint32_t)(bytes * 1000000 / total_us) : UINT32_MAX;
+	stats->p50_us = samples[(count - 1) * 50 / 100];
+	stats->p90_us = samples[(count - 1) * 90 / 100];
+	stats->p99_us = samples[(count - 1) * 99 / 100];
+	stats->max_us = samples[count - 1];
+}
+
+static void bench_print(const char* name, uint32_t block_size, const usd_bench_stats_s_t* stats) {
+	printf("%8lu  %-11s %10lu %8lu %8lu %8lu %8lu\n", block_size, name, stats->bytes_per_sec / 1024, stats->p50_us,
+	       stats->p90_us, stats->p99_us, stats->max_us);
+}
+
+// runs the tests for one block size. buffer holds at least block_size bytes and
+// samples at least file_size / block_size entries
+static int32_t bench_block(const char* path, uint32_t file_size, usd_bench_result_s_t* result, uint8_t* buffer,
+                           uint32_t* samples) {
+	uint32_t block_size = result->block_size;
+	uint32_t count = file_size / block_size;
+	uint64_t bytes = (uint64_t)count * block_size;
+
+	int file = open(path, O_WRONLY | O_CREAT | O_TRUNC);
+	if (file < 0) return PROS_ERR;
+	uint64_t start = micros();
+	for (uint32_t i = 0; i < count; i++) {
+		uint64_t op = micros();
+		ssize_t written = write(file, buffer, block_size);
+		samples[i] = micros() - op;
+		if (written != (ssize_t)block_size) {
+			if (written >= 0) errno = EIO;
+			close(file);
+			return PROS_ERR;
+		}
+	}
+	// the card only finishes writing when the file is closed
+	close(file);
+	bench_summarize(&result->write, samples, count, bytes, micros() - start);
+
+	file = open(path, O_RDONLY);
+	if (file < 0) return PROS_ERR;
+	start = micros();
+	for (uint32_t i = 0; i < count; i++) {
+		uint64_t op = micros();
+		ssize_t got = read(file, buffer, block_size);
+		samples[i] = micros() - op;
+		if (got != (ssize_t)block_size) {
+			if (got >= 0) errno = EIO;
+			close(file);
+			return PROS_ERR;
+		}
+	}
+	bench_summarize(&result->read, samples, count, bytes, micros() - start);
+
+	// xorshift, so every run visits the blocks in the same order
+	uint32_t state = 2463534242u;
+	start = micros();
+	for (uint32_t i = 0; i < count; i++) {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		uint64_t op = micros();
+		ssize_t got = -1;
+		if (lseek(file, (off_t)(state % count) * block_size, SEEK_SET) != (off_t)-1) {
+			got = read(file, buffer, block_size);
+			if (got != (ssize_t)block_size && got >= 0) errno = EIO;
+		}
+		samples[i] = micros() - op;
+		if (got != (ssize_t)block_size) {
+			close(file);
+			return PROS_ERR;
+		}
+	}
+	bench_summarize(&result->random_read, samples, count, bytes, micros() - start);
+	close(file);
+	return 1;
+}
+
+int32_t usd_benchmark(const char* dir, uint32_t file_size, usd_bench_result_s_t* results, size_t count) {
+	usd_bench_result_s_t defaults[] = {{.block_size = 512}, {.block_size = 4096}, {.block_size = 32768}};
+	if (results == NULL) {
+		results = defaults;
+		count = sizeof(defaults) / sizeof(*defaults);
+	}
+	char path[BENCH_PATH_MAX];
+	if (dir == NULL || file_size == 0 || count == 0 ||
+	    snprintf(path, sizeof(path), "%s/bench.tmp", dir) >= (int)sizeof(path)) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	uint32_t max_block = 0;
+	uint32_t min_block = UINT32_MAX;
+	for (size_t i = 0; i < count; i++) {
+		if (results[i].block_size > max_block) max_block = results[i].block_size;
+		if (results[i].block_size < min_block) min_block = results[i].block_size;
+	}
+	if (min_block == 0 || max_block > file_size) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+
+	uint8_t* buffer = kmalloc(max_block);
+	uint32_t* samples = kmalloc((file_size / min_block) * sizeof(*samples));
+	if (buffer == NULL || samples == NULL) {
+		kfree(buffer);
+		kfree(samples);
+		errno = ENOMEM;
+		return PROS_ERR;
+	}
+	for (uint32_t i = 0; i < max_block; i++) {
+		buffer[i] = (uint8_t)i;
+	}
+
+	printf("BEGIN USD BENCHMARK (%s, %lu byte file)\n", path, file_size);
+	printf("   block  test              KB/s   p50 us   p90 us   p99 us   max us\n");
+	int32_t ret = 1;
+	for (size_t i = 0; i < count && ret == 1; i++) {
+		ret = bench_block(path, file_size, &results[i], buffer, samples);
+		if (ret == 1) {
+			bench_print("write", results[i].block_size, &results[i].write);
+			bench_print("read", results[i].block_size, &results[i].read);
+			bench_print("random read", results[i].block_size, &results[i].random_read);
+		} else {
+			printf("%8lu  failed with errno %d\n", results[i].block_size, errno);
+		}
+	}
+	printf("END USD BENCHMARK\n");
+	fflush(stdout);
+
+	int saved_errno = errno;
+	// not every file system can remove files, so the test file may stay behind
+	unlink(path);
+	errno = saved_errno;
+	kfree(buffer);
+	kfree(samples);
+	return ret;
+}
@@ -215,6 +215,64 @@ int32_t vision_read_by_code(uint8_t port, const uint32_t size_id, const vision_c
 	return _vision_read_by_sig(port, size_id, color_code, object_count, object_arr);
 }
 
+static uint32_t _vision_object_area(const vision_object_s_t* object) {
+	return (uint32_t)object->width * object->height;
+}
+
+int32_t vision_snapshot(uint8_t port, vision_snapshot_s_t* snapshot) {
+	if (snapshot == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	claim_port_i(port - 1, E_DEVICE_VISION);
+	uint32_t frame = vexDeviceGetTimestamp(device->device_info);
+	if (frame == snapshot->frame) {
+		return_port(port - 1, 0);
+	}
+
+	uint32_t count = vexDeviceVisionObjectCountGet(device->device_info);
+	if (count > VISION_SNAPSHOT_MAX_OBJECTS) {
+		count = VISION_SNAPSHOT_MAX_OBJECTS;
+	}
+	for (uint32_t i = 0; i < count; i++) {
+		if (!vexDeviceVisionObjectGet(device->device_info, i, (V5_DeviceVisionObject*)&snapshot->objects[i])) {
+			snapshot->count = 0;
+			errno = EAGAIN;
+			return_port(port - 1, PROS_ERR);
+		}
+		_vision_transform_coords(port - 1, &snapshot->objects[i]);
+	}
+	port_mutex_give(port - 1);
+
+	// the sensor only roughly orders objects by size, so sort an index by area
+	for (uint32_t i = 0; i < count; i++) {
+		uint8_t idx = i;
+		uint32_t area = _vision_object_area(&snapshot->objects[idx]);
+		uint32_t j = i;
+		while (j > 0 && _vision_object_area(&snapshot->objects[snapshot->by_size[j - 1]]) < area) {
+			snapshot->by_size[j] = snapshot->by_size[j - 1];
+			j--;
+		}
+		snapshot->by_size[j] = idx;
+	}
+	snapshot->count = count;
+	snapshot->frame = frame;
+	return 1;
+}
+
+uint32_t vision_snapshot_filter(const vision_snapshot_s_t* snapshot, uint32_t sig_mask,
+                                vision_object_s_t* const object_arr, uint32_t object_count) {
+	uint32_t copied = 0;
+	for (uint32_t i = 0; i < snapshot->count && copied < object_count; i++) {
+		const vision_object_s_t* object = &snapshot->objects[snapshot->by_size[i]];
+		uint32_t bit = object->signature > 7 ? VISION_SIG_MASK_COLOR_CODES : VISION_SIG_MASK(object->signature);
+		if (sig_mask & bit) {
+			object_arr[copied++] = *object;
+		}
+	}
+	return copied;
+}
+
 vision_signature_s_t vision_get_signature(uint8_t port, const uint8_t signature_id) {
 	vision_signature_s_t sig;
 	sig.id = VISION_OBJECT_ERR_SIG;
@@ -115,4 +115,8 @@ std::int32_t Vision::set_zero_point(vision_zero_e_t zero_point) const {
 std::int32_t Vision::set_wifi_mode(const std::uint8_t enable) const {
 	return vision_set_wifi_mode(_port, enable);
 }
+
+std::int32_t Vision::snapshot(vision_snapshot_s_t* snapshot) const {
+	return vision_snapshot(_port, snapshot);
+}
 }  // namespace pros
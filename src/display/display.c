@@ -10,31 +10,62 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
+#include <string.h>
+
 #include "display/lvgl.h"
 #include "kapi.h"
+#include "system/screen.h"
 #include "v5_api.h"
 
 static task_stack_t disp_daemon_task_stack[TASK_STACK_DEPTH_DEFAULT];
 static static_task_s_t disp_daemon_task_buffer;
 static task_t disp_daemon_task;
 
+// Held while LVGL is running so that a render can be forced from another task
+static static_sem_s_t disp_mutex_buffer;
+static mutex_t disp_mutex;
+
+static uint32_t* volatile capture_fb = NULL;
+
+static bool touch_injected = false;
+static lv_indev_data_t touch_injected_data;
+
 static void disp_daemon(void* ign) {
 	uint32_t time = millis();
 	while (true) {
+		mutex_take(disp_mutex, TIMEOUT_MAX);
 		lv_task_handler();
+		mutex_give(disp_mutex);
 		task_delay_until(&time, 2);
 		lv_tick_inc(2);
 	}
 }
 
 static void vex_display_flush(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const lv_color_t* color) {
+	uint32_t* fb = capture_fb;
+	if (fb) {
+		int32_t width = x2 - x1 + 1;
+		for (int32_t y = y1; y <= y2; y++) {
+			memcpy(&fb[y * LV_HOR_RES + x1], color, width * sizeof(uint32_t));
+			color += width;
+		}
+		lv_flush_ready();
+		return;
+	}
+	// text printed through the screen API may have been drawn over
+	screen_text_cache_invalidate();
 	vexDisplayCopyRect(x1, y1, x2, y2, (uint32_t*)color, x2 - x1 + 1);
 	lv_flush_ready();
 }
 
 static bool vex_read_touch(lv_indev_data_t* data) {
-	static V5_TouchStatus v5_touch_status;
-	vexTouchDataGet(&v5_touch_status);
+	if (touch_injected) {
+		*data = touch_injected_data;
+		return false;
+	}
+	// the touch screen is sampled by the screen touch task
+	V5_TouchStatus v5_touch_status;
+	screen_touch_sample_get(&v5_touch_status);
 	switch (v5_touch_status.lastEvent) {
 		case kTouchEventPress:
 		case kTouchEventPressAuto:
@@ -51,7 +82,47 @@ static bool vex_read_touch(lv_indev_data_t* data) {
 	return false;
 }
 
+void display_capture_set(uint32_t* framebuffer) {
+	capture_fb = framebuffer;
+}
+
+void display_touch_inject(int16_t x, int16_t y, bool pressed) {
+	mutex_take(disp_mutex, TIMEOUT_MAX);
+	touch_injected_data.point.x = x;
+	touch_injected_data.point.y = y;
+	touch_injected_data.state = pressed ? LV_INDEV_STATE_PR : LV_INDEV_STATE_REL;
+	touch_injected = true;
+	mutex_give(disp_mutex);
+}
+
+void display_touch_inject_stop(void) {
+	mutex_take(disp_mutex, TIMEOUT_MAX);
+	touch_injected = false;
+	mutex_give(disp_mutex);
+}
+
+void display_lock(void) {
+	mutex_take(disp_mutex, TIMEOUT_MAX);
+}
+
+void display_unlock(void) {
+	mutex_give(disp_mutex);
+}
+
+uint32_t display_render_now(void) {
+	mutex_take(disp_mutex, TIMEOUT_MAX);
+	lv_area_t area = {.x1 = 0, .y1 = 0, .x2 = LV_HOR_RES - 1, .y2 = LV_VER_RES - 1};
+	lv_inv_area(&area);
+	uint64_t start = micros();
+	lv_refr_now();
+	uint32_t elapsed = micros() - start;
+	mutex_give(disp_mutex);
+	return elapsed;
+}
+
 void display_initialize(void) {
+	disp_mutex = mutex_create_static(&disp_mutex_buffer);
+
 	lv_init();
 
 	lv_disp_drv_t disp_drv;
@@ -159,6 +159,11 @@ bool _lcd_vprint(lv_obj_t* lcd_dummy, int16_t line, const char* fmt, va_list arg
 	char buf[33];
 	vsnprintf(buf, 33, fmt, args);
 
+	// setting a label's text reallocates it and invalidates the label's area,
+	// so leave the label alone when the text has not changed
+	if (strcmp(lv_label_get_text(lcd->lcd_text[line]), buf) == 0) {
+		return true;
+	}
 	lv_label_set_text(lcd->lcd_text[line], buf);
 	lv_obj_set_width(lcd->lcd_text[line], 426);
 	return true;
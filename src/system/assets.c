@@ -0,0 +1,223 @@
+/**
+ * \file system/assets.c
+ *
+ * Read-only asset packs
+ *
+ * A pack file, as written by tools/pack_assets.py, is laid out as follows.
+ * All integers are little endian.
+ *
+ *   header   asset_header_t
+ *   entries  count asset_entry_t, sorted by name
+ *   table    buckets uint32_t, each 0 for empty or 1 + an entry index
+ *   names    NUL terminated names, referenced by entry name offsets
+ *   data     each asset at an 8 byte aligned offset
+ *
+ * The table is an open addressing hash table of FNV-1a name hashes with linear
+ * probing, and has at least twice as many buckets as there are assets, so a
+ * lookup usually checks one or two buckets. Everything before data_offset is
+ * read into the arena with one read when the pack is opened, and each asset is
+ * read with one seek and one read the first time it is requested.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "kapi.h"
+#include "pros/assets.h"
+
+#define ASSET_MAGIC 0x4b415041  // "APAK"
+#define ASSET_VERSION 1
+#define ASSET_ALIGN 8
+
+typedef struct asset_header {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t reserved;
+	uint32_t count;
+	uint32_t buckets;  // power of two
+	uint32_t names_offset;
+	uint32_t data_offset;
+	uint32_t file_size;
+	uint32_t reserved2;
+} asset_header_t;
+
+typedef struct asset_entry {
+	uint32_t hash;
+	uint32_t name;  // offset into the names
+	uint32_t offset;
+	uint32_t size;
+} asset_entry_t;
+
+// guards lazy loading, so two tasks asking for the same asset read it once
+static static_sem_s_t assets_mutex_buf;
+static mutex_t assets_mutex = NULL;
+
+static uint32_t asset_hash(const char* name) {
+	uint32_t hash = 2166136261u;
+	while (*name) {
+		hash ^= (uint8_t)*name++;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+// Takes aligned space from the arena, or returns NULL if it is full
+static void* asset_alloc(asset_pack_s_t* pack, size_t size) {
+	size_t start = (pack->arena_used + ASSET_ALIGN - 1) & ~(size_t)(ASSET_ALIGN - 1);
+	if (start > pack->arena_size || size > pack->arena_size - start) return NULL;
+	pack->arena_used = start + size;
+	return pack->arena + start;
+}
+
+static bool asset_read(int file, void* buffer, size_t size) {
+	size_t done = 0;
+	while (done < size) {
+		ssize_t count = read(file, (uint8_t*)buffer + done, size - done);
+		if (count <= 0) return false;
+		done += count;
+	}
+	return true;
+}
+
+int32_t asset_pack_open(asset_pack_s_t* pack, const char* path, void* arena, size_t arena_size) {
+	if (pack == NULL || path == NULL || arena == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	pack->loaded = NULL;
+	// the mutex is only needed once a pack exists, so it is made here
+	if (assets_mutex == NULL) {
+		rtos_suspend_all();
+		if (assets_mutex == NULL) assets_mutex = mutex_create_static(&assets_mutex_buf);
+		rtos_resume_all();
+	}
+	int file = open(path, O_RDONLY);
+	if (file < 0) return PROS_ERR;
+
+	asset_header_t header;
+	if (!asset_read(file, &header, sizeof(header))) {
+		close(file);
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	// 64 bit so a corrupt count cannot wrap around
+	uint64_t table_offset = sizeof(header) + (uint64_t)header.count * sizeof(asset_entry_t);
+	if (header.magic != ASSET_MAGIC || header.version != ASSET_VERSION || header.buckets < header.count ||
+	    (header.buckets & (header.buckets - 1)) != 0 ||
+	    header.names_offset != table_offset + (uint64_t)header.buckets * sizeof(uint32_t) ||
+	    header.data_offset < header.names_offset || header.data_offset > header.file_size) {
+		close(file);
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+
+	pack->arena = arena;
+	pack->arena_size = arena_size;
+	pack->arena_used = 0;
+	size_t index_size = header.data_offset - sizeof(header);
+	uint8_t* index = asset_alloc(pack, index_size);
+	const void** loaded = asset_alloc(pack, header.count * sizeof(void*));
+	if (index == NULL || loaded == NULL) {
+		close(file);
+		errno = ENOMEM;
+		return PROS_ERR;
+	}
+	if (!asset_read(file, index, index_size)) {
+		close(file);
+		errno = EIO;
+		return PROS_ERR;
+	}
+	const asset_entry_t* entries = (const asset_entry_t*)index;
+	size_t names_size = header.data_offset - header.names_offset;
+	for (uint32_t i = 0; i < header.count; i++) {
+		// check the offset first so the size check can't wrap around
+		if (entries[i].name >= names_size || entries[i].offset < header.data_offset ||
+		    entries[i].offset > header.file_size || entries[i].size > header.file_size - entries[i].offset) {
+			close(file);
+			errno = EINVAL;
+			return PROS_ERR;
+		}
+	}
+	// names must be terminated so a bad pack cannot run strcmp off the end
+	if (names_size == 0 || index[index_size - 1] != '\0') {
+		close(file);
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	memset(loaded, 0, header.count * sizeof(void*));
+
+	pack->file = file;
+	pack->count = header.count;
+	pack->buckets = header.buckets;
+	pack->entries = entries;
+	pack->table = (const uint32_t*)(index + table_offset - sizeof(header));
+	pack->names = (const char*)(index + header.names_offset - sizeof(header));
+	pack->loaded = loaded;
+	return 1;
+}
+
+const void* asset_get(asset_pack_s_t* pack, const char* name, size_t* size) {
+	if (pack == NULL || name == NULL || pack->loaded == NULL) {
+		errno = EINVAL;
+		return NULL;
+	}
+	const asset_entry_t* entries = pack->entries;
+	uint32_t hash = asset_hash(name);
+	uint32_t mask = pack->buckets - 1;
+	const asset_entry_t* entry = NULL;
+	for (uint32_t bucket = hash & mask, probes = 0; probes < pack->buckets; bucket = (bucket + 1) & mask, probes++) {
+		uint32_t slot = pack->table[bucket];
+		if (slot == 0 || slot > pack->count) break;
+		if (entries[slot - 1].hash == hash && strcmp(pack->names + entries[slot - 1].name, name) == 0) {
+			entry = &entries[slot - 1];
+			break;
+		}
+	}
+	if (entry == NULL) {
+		errno = ENOENT;
+		return NULL;
+	}
+	if (size != NULL) *size = entry->size;
+
+	uint32_t index = entry - entries;
+	if (pack->loaded[index] != NULL) return pack->loaded[index];
+	mutex_take(assets_mutex, TIMEOUT_MAX);
+	const void* asset = pack->loaded[index];
+	if (asset == NULL) {
+		size_t arena_used = pack->arena_used;
+		void* buffer = asset_alloc(pack, entry->size);
+		if (buffer == NULL) {
+			errno = ENOMEM;
+		} else if (pack->file < 0 || lseek(pack->file, entry->offset, SEEK_SET) == (off_t)-1 ||
+		           !asset_read(pack->file, buffer, entry->size)) {
+			pack->arena_used = arena_used;
+			errno = EIO;
+		} else {
+			asset = buffer;
+			__sync_synchronize();  // publish the data before the pointer
+			pack->loaded[index] = asset;
+		}
+	}
+	mutex_give(assets_mutex);
+	return asset;
+}
+
+int32_t asset_pack_close(asset_pack_s_t* pack) {
+	if (pack == NULL || pack->loaded == NULL || pack->file < 0) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	mutex_take(assets_mutex, TIMEOUT_MAX);
+	close(pack->file);
+	pack->file = -1;
+	mutex_give(assets_mutex);
+	return 1;
+}
@@ -0,0 +1,269 @@
+/**
+ * \file system/dev/aio.c
+ *
+ * Asynchronous file I/O
+ *
+ * Every driver in the VFS is synchronous, so a task that opens or reads a
+ * large file is blocked until the driver finishes. Instead, requests can be
+ * queued for a low priority I/O worker task, which performs them through the
+ * same VFS calls a synchronous caller would use, so every driver (ser, dev,
+ * and usd) supports them without changes. The submitter can poll, wait, or be
+ * notified when each one finishes.
+ *
+ * Requests run in the order they were submitted, except that a read or write
+ * on a file that is not ready, such as a serial port with no bytes waiting,
+ * stays in the queue without holding up requests on other files. Later
+ * requests on the same file wait behind it, so each file still sees its
+ * requests in order. The worker checks readiness with the same driver hooks
+ * poll() uses, and sleeps on the I/O wait queue until a request is submitted or
+ * a file it is waiting on becomes ready. A write may still wait for the rest of
+ * its bytes to drain once started, but a started read never waits for input.
+ * aio_wait() sleeps on the wait queue as well.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "kapi.h"
+#include "system/dev/aio.h"
+#include "system/dev/vfs.h"
+#include "system/dev/wait.h"
+
+extern int _open(const char* file, int flags, int mode);
+extern ssize_t _read(int file, void* buf, size_t len);
+extern ssize_t _write(int file, const void* buf, size_t len);
+extern int _close(int file);
+extern off_t _lseek(int file, off_t ptr, int dir);
+
+// most files the worker skips over at once while they are not ready
+#define AIO_MAX_BLOCKED_FILES 8
+
+static task_stack_t aio_task_stack[TASK_STACK_DEPTH_DEFAULT];
+static static_task_s_t aio_task_buffer;
+
+// FIFO of queued requests, linked through their next pointers
+static static_sem_s_t aio_mutex_buf;
+static mutex_t aio_mutex;
+static aio_request_s_t* aio_head = NULL;
+static aio_request_s_t* aio_tail = NULL;
+
+static void aio_perform(aio_request_s_t* request) {
+	errno = 0;
+	if (request->offset >= 0 && (request->op == E_AIO_READ || request->op == E_AIO_WRITE) &&
+	    _lseek(request->file, request->offset, SEEK_SET) == (off_t)-1) {
+		request->result = -1;
+		request->error = errno;
+		return;
+	}
+	switch (request->op) {
+		case E_AIO_OPEN:
+			request->result = _open(request->path, request->flags, 0);
+			break;
+		case E_AIO_READ:
+			request->result = _read(request->file, request->buffer, request->length);
+			break;
+		case E_AIO_WRITE:
+			request->result = _write(request->file, request->buffer, request->length);
+			break;
+		case E_AIO_CLOSE:
+			request->result = _close(request->file);
+			break;
+	}
+	request->error = request->result < 0 ? errno : 0;
+}
+
+// Takes the first queued request that can run without waiting for its file off
+// the queue, or returns NULL. Adds the wait sources of the files that are not
+// ready to sources. Called with aio_mutex held.
+static aio_request_s_t* aio_next(uint64_t* sources) {
+	int blocked[AIO_MAX_BLOCKED_FILES];
+	size_t blocked_count = 0;
+	aio_request_s_t* prev = NULL;
+	for (aio_request_s_t* it = aio_head; it != NULL; prev = it, it = it->next) {
+		bool wait = false;
+		for (size_t i = 0; i < blocked_count && !wait; i++) wait = it->file == blocked[i];
+		if (wait) continue;
+		if (it->op == E_AIO_READ || it->op == E_AIO_WRITE) {
+			int events = it->op == E_AIO_READ ? POLLIN : POLLOUT;
+			// errors and bad files are ready too, so the operation reports them
+			if (!vfs_poll_r(_REENT, it->file, events, sources)) {
+				// with no room to remember the file, later requests can't safely pass it
+				if (blocked_count == AIO_MAX_BLOCKED_FILES) return NULL;
+				blocked[blocked_count++] = it->file;
+				continue;
+			}
+		}
+		if (prev != NULL) {
+			prev->next = it->next;
+		} else {
+			aio_head = it->next;
+		}
+		if (aio_tail == it) aio_tail = prev;
+		return it;
+	}
+	return NULL;
+}
+
+// Takes the next request that can run, adding what the blocked ones wait on to
+// sources
+static int32_t aio_take_next(void* arg, uint64_t* sources) {
+	aio_request_s_t** request = (aio_request_s_t**)arg;
+	mutex_take(aio_mutex, TIMEOUT_MAX);
+	*request = aio_next(sources);
+	if (*request != NULL) (*request)->state = E_AIO_RUNNING;
+	mutex_give(aio_mutex);
+	return *request != NULL;
+}
+
+static void aio_task_fn(void* ign) {
+	while (true) {
+		aio_request_s_t* request;
+		io_wait_for(WAIT_AIO_QUEUED, aio_take_next, &request, TIMEOUT_MAX);
+
+		aio_perform(request);
+		// the submitter may reuse the request as soon as it sees it is done, so
+		// read what is needed to notify it first
+		task_t task = request->task;
+		uint32_t bits = request->notify_bits;
+		__sync_synchronize();  // publish the result before the state
+		request->state = E_AIO_DONE;
+		if (task != NULL) {
+			task_notify_ext(task, bits, bits ? E_NOTIFY_ACTION_BITS : E_NOTIFY_ACTION_INCR, NULL);
+		}
+		io_wake(WAIT_AIO_DONE);
+	}
+}
+
+void aio_initialize(void) {
+	aio_mutex = mutex_create_static(&aio_mutex_buf);
+	task_create_static(aio_task_fn, NULL, TASK_PRIORITY_MIN + 2, TASK_STACK_DEPTH_DEFAULT, "PROS I/O Worker",
+	                   aio_task_stack, &aio_task_buffer);
+}
+
+// Fills in and queues a request, unless it is already queued or running
+static int32_t aio_submit(aio_request_s_t* request, aio_op_e_t op, int file, const char* path, int flags, void* buffer,
+                          size_t length, int32_t offset) {
+	mutex_take(aio_mutex, TIMEOUT_MAX);
+	if (request->state == E_AIO_QUEUED || request->state == E_AIO_RUNNING) {
+		mutex_give(aio_mutex);
+		errno = EBUSY;
+		return PROS_ERR;
+	}
+	request->op = op;
+	request->file = file;
+	request->path = path;
+	request->flags = flags;
+	request->buffer = buffer;
+	request->length = length;
+	request->offset = offset;
+	request->result = -1;
+	request->error = 0;
+	request->next = NULL;
+	request->state = E_AIO_QUEUED;
+	if (aio_tail != NULL) {
+		aio_tail->next = request;
+	} else {
+		aio_head = request;
+	}
+	aio_tail = request;
+	mutex_give(aio_mutex);
+	io_wake(WAIT_AIO_QUEUED);
+	return 1;
+}
+
+int32_t aio_submit_open(aio_request_s_t* request, const char* path, int flags) {
+	if (request == NULL || path == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	return aio_submit(request, E_AIO_OPEN, -1, path, flags, NULL, 0, -1);
+}
+
+int32_t aio_submit_read(aio_request_s_t* request, int file, void* buffer, size_t length, int32_t offset) {
+	if (request == NULL || buffer == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	return aio_submit(request, E_AIO_READ, file, NULL, 0, buffer, length, offset);
+}
+
+int32_t aio_submit_write(aio_request_s_t* request, int file, const void* buffer, size_t length, int32_t offset) {
+	if (request == NULL || buffer == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	return aio_submit(request, E_AIO_WRITE, file, NULL, 0, (void*)buffer, length, offset);
+}
+
+int32_t aio_submit_close(aio_request_s_t* request, int file) {
+	if (request == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	return aio_submit(request, E_AIO_CLOSE, file, NULL, 0, NULL, 0, -1);
+}
+
+bool aio_done(const aio_request_s_t* request) {
+	return request->state == E_AIO_DONE || request->state == E_AIO_CANCELED;
+}
+
+static int32_t aio_check_done(void* arg, uint64_t* sources) {
+	return aio_done((const aio_request_s_t*)arg);
+}
+
+int32_t aio_wait(aio_request_s_t* request, uint32_t timeout) {
+	if (request == NULL || request->state == E_AIO_IDLE) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	if (!io_wait_for(WAIT_AIO_DONE, aio_check_done, request, timeout)) {
+		errno = ETIMEDOUT;
+		return PROS_ERR;
+	}
+	__sync_synchronize();  // read the result only after seeing the state
+	if (request->state == E_AIO_CANCELED) {
+		errno = ECANCELED;
+		return PROS_ERR;
+	}
+	if (request->result < 0) {
+		errno = request->error;
+		return PROS_ERR;
+	}
+	return request->result;
+}
+
+int32_t aio_cancel(aio_request_s_t* request) {
+	if (request == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	mutex_take(aio_mutex, TIMEOUT_MAX);
+	if (request->state != E_AIO_QUEUED) {
+		mutex_give(aio_mutex);
+		errno = EBUSY;
+		return PROS_ERR;
+	}
+	aio_request_s_t* prev = NULL;
+	for (aio_request_s_t* it = aio_head; it != NULL; prev = it, it = it->next) {
+		if (it != request) continue;
+		if (prev != NULL) {
+			prev->next = it->next;
+		} else {
+			aio_head = it->next;
+		}
+		if (aio_tail == it) aio_tail = prev;
+		break;
+	}
+	request->state = E_AIO_CANCELED;
+	mutex_give(aio_mutex);
+	io_wake(WAIT_AIO_DONE);
+	return 1;
+}
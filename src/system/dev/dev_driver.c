@@ -25,6 +25,7 @@
 #include "kapi.h"
 #include "system/dev/dev.h"
 #include "system/dev/vfs.h"
+#include "system/dev/wait.h"
 #include "system/optimizers.h"
 #include "v5_api.h"
 #include "vdml/vdml.h"
@@ -36,6 +37,14 @@ typedef struct dev_file_arg {
 	int flags;
 } dev_file_arg_t;
 
+// Blocks until the port has bytes to read or space to write. The generic serial
+// background processing wakes the task as soon as it sees the port is ready.
+static void dev_wait(uint32_t port, bool read) {
+	uint32_t rx_ports = read ? 1u << (port - 1) : 0;
+	uint32_t tx_ports = read ? 0 : 1u << (port - 1);
+	serial_wait(&rx_ports, &tx_ports, TIMEOUT_MAX);
+}
+
 /******************************************************************************/
 /**                         newlib driver functions                          **/
 /******************************************************************************/
@@ -51,7 +60,7 @@ int dev_read_r(struct _reent* r, void* const arg, uint8_t* buffer, const size_t
 		if (file_arg->flags & O_NONBLOCK || recv >= 1) {
 			break;
 		}
-		task_delay(2);
+		dev_wait(port, true);
 	}
 	if (recv == 0) {
 		errno = EAGAIN;
@@ -73,7 +82,7 @@ int dev_write_r(struct _reent* r, void* const arg, const uint8_t* buf, const siz
 		if (file_arg->flags & O_NONBLOCK || wrtn >= len) {
 			break;
 		}
-		task_delay(2);
+		dev_wait(port, false);
 	}
 	if (wrtn == 0) {
 		errno = EAGAIN;
@@ -113,12 +122,44 @@ int dev_ctl(void* const arg, const uint32_t cmd, void* const extra_arg) {
 			return serial_get_write_free(port);
 		case DEVCTL_SET_BAUDRATE:
 			return serial_set_baudrate(port, (int32_t)extra_arg);
+		case DEVCTL_SELECT: {
+			dev_select_s_t* select = (dev_select_s_t*)extra_arg;
+			if (select == NULL) {
+				errno = EINVAL;
+				return PROS_ERR;
+			}
+			return serial_wait(&select->read_ports, &select->write_ports, select->timeout);
+		}
 		default:
 			errno = EINVAL;
 			return PROS_ERR;
 	}
 }
 
+int dev_poll_r(struct _reent* r, void* const arg, int events, uint64_t* sources) {
+	uint32_t port = ((dev_file_arg_t*)arg)->port;
+	int revents = 0;
+	if (events & POLLIN) {
+		int32_t avail = serial_get_read_avail(port);
+		if (avail == PROS_ERR) {
+			revents |= POLLERR;
+		} else if (avail > 0) {
+			revents |= POLLIN;
+		}
+		*sources |= WAIT_SERIAL_RX(port);
+	}
+	if (events & POLLOUT) {
+		int32_t free = serial_get_write_free(port);
+		if (free == PROS_ERR) {
+			revents |= POLLERR;
+		} else if (free > 0) {
+			revents |= POLLOUT;
+		}
+		*sources |= WAIT_SERIAL_TX(port);
+	}
+	return revents;
+}
+
 /******************************************************************************/
 /**                           Driver description                             **/
 /******************************************************************************/
@@ -128,7 +169,8 @@ const struct fs_driver _dev_driver = {.close_r = dev_close_r,
                                       .lseek_r = dev_lseek_r,
                                       .read_r = dev_read_r,
                                       .write_r = dev_write_r,
-                                      .ctl = dev_ctl};
+                                      .ctl = dev_ctl,
+                                      .poll_r = dev_poll_r};
 
 const struct fs_driver* const dev_driver = &_dev_driver;
 
@@ -52,11 +52,6 @@ char* getcwd(char* buf, size_t size) {
 	return NULL;
 }
 
-int _unlink(const char* name) {
-	errno = ENOSYS;
-	return -1;
-}
-
 int _link(const char* old, const char* new) {
 	errno = ENOSYS;
 	return -1;
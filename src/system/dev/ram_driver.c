@@ -0,0 +1,443 @@
+/**
+ * \file system/dev/ram_driver.c
+ *
+ * Contains the driver for files kept in RAM.
+ *
+ * Files under /ram behave like microSD card files but never touch the card,
+ * so they are fast, are not limited to 8 open at once, and can be used to hand
+ * data between tasks. Each file is stored as a list of extents that grow
+ * geometrically, so appending never copies existing data, and each open file
+ * remembers the extent it last used so sequential access does not walk the
+ * list. All files together may not use more than a configurable amount of
+ * memory.
+ *
+ * Files can be marked to be saved to the microSD card under the same name,
+ * which happens when ramctl(RAMCTL_SAVE, NULL) is called or the program exits.
+ * Saving on exit is skipped if another RAM file operation is in progress, so
+ * programs that must not lose data should call ramctl(RAMCTL_SAVE, NULL).
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "kapi.h"
+#include "system/dev/ram.h"
+#include "system/dev/vfs.h"
+#include "system/optimizers.h"
+
+#define RAM_MAX_NAME 64
+#define RAM_DEFAULT_CAPACITY (1024 * 1024)
+#define RAM_MIN_EXTENT 512
+#define RAM_MAX_EXTENT (64 * 1024)
+
+typedef struct ram_extent {
+	struct ram_extent* next;
+	size_t size;
+	uint8_t data[];
+} ram_extent_t;
+
+typedef struct ram_file {
+	char name[RAM_MAX_NAME];
+	ram_extent_t* extents;
+	ram_extent_t* last;
+	size_t size;       // bytes of data
+	size_t allocated;  // bytes of extent storage
+	// bumped whenever extents are freed so open files drop their cached extent
+	uint32_t generation;
+	uint32_t open_count;
+	bool unlinked;
+	bool persist;
+	struct ram_file* next;
+} ram_file_t;
+
+typedef struct ram_file_arg {
+	ram_file_t* file;
+	int flags;
+	size_t position;
+	// extent containing position, and the file offset it starts at
+	ram_extent_t* cursor;
+	size_t cursor_start;
+	uint32_t generation;
+} ram_file_arg_t;
+
+static static_sem_s_t ram_mutex_buf;
+static mutex_t ram_mutex;
+static ram_file_t* ram_files = NULL;
+static size_t ram_capacity = RAM_DEFAULT_CAPACITY;
+static size_t ram_used = 0;
+
+void ram_initialize(void) {
+	ram_mutex = mutex_create_static(&ram_mutex_buf);
+}
+
+static ram_file_t* ram_find(const char* name) {
+	for (ram_file_t* file = ram_files; file != NULL; file = file->next) {
+		if (!file->unlinked && strcmp(file->name, name) == 0) return file;
+	}
+	return NULL;
+}
+
+static void ram_free_extents(ram_file_t* file) {
+	ram_extent_t* extent = file->extents;
+	while (extent != NULL) {
+		ram_extent_t* next = extent->next;
+		kfree(extent);
+		extent = next;
+	}
+	ram_used -= file->allocated;
+	file->extents = file->last = NULL;
+	file->size = file->allocated = 0;
+	file->generation++;
+}
+
+// Frees a file once it is unlinked and no longer open
+static void ram_release(ram_file_t* file) {
+	if (!file->unlinked || file->open_count > 0) return;
+	ram_free_extents(file);
+	ram_file_t** link = &ram_files;
+	while (*link != file) link = &(*link)->next;
+	*link = file->next;
+	ram_used -= sizeof(ram_file_t);
+	kfree(file);
+}
+
+// Grows a file's storage to at least size bytes, doubling the extent size up
+// to RAM_MAX_EXTENT. Returns false if the memory cap or heap runs out.
+static bool ram_reserve(ram_file_t* file, size_t size) {
+	while (file->allocated < size) {
+		size_t extent_size = file->allocated;
+		if (extent_size < RAM_MIN_EXTENT) extent_size = RAM_MIN_EXTENT;
+		if (extent_size > RAM_MAX_EXTENT) extent_size = RAM_MAX_EXTENT;
+		if (ram_used + extent_size > ram_capacity) {
+			// settle for whatever is left under the cap
+			if (ram_used + RAM_MIN_EXTENT > ram_capacity) return false;
+			extent_size = ram_capacity - ram_used;
+		}
+		ram_extent_t* extent = kmalloc(sizeof(ram_extent_t) + extent_size);
+		if (extent == NULL) return false;
+		extent->next = NULL;
+		extent->size = extent_size;
+		if (file->last != NULL) {
+			file->last->next = extent;
+		} else {
+			file->extents = extent;
+		}
+		file->last = extent;
+		file->allocated += extent_size;
+		ram_used += extent_size;
+	}
+	return true;
+}
+
+// Moves the open file's cursor to the extent containing its position
+static void ram_seek_cursor(ram_file_arg_t* arg) {
+	if (arg->generation != arg->file->generation || arg->cursor == NULL || arg->cursor_start > arg->position) {
+		arg->generation = arg->file->generation;
+		arg->cursor = arg->file->extents;
+		arg->cursor_start = 0;
+	}
+	while (arg->cursor != NULL && arg->cursor_start + arg->cursor->size <= arg->position) {
+		arg->cursor_start += arg->cursor->size;
+		arg->cursor = arg->cursor->next;
+	}
+}
+
+// Copies between a buffer and the file at the open file's position
+static void ram_copy(ram_file_arg_t* arg, uint8_t* buffer, size_t len, bool to_file) {
+	size_t done = 0;
+	while (done < len) {
+		ram_seek_cursor(arg);
+		size_t offset = arg->position - arg->cursor_start;
+		size_t span = arg->cursor->size - offset;
+		if (span > len - done) span = len - done;
+		if (to_file) {
+			memcpy(&arg->cursor->data[offset], buffer + done, span);
+		} else {
+			memcpy(buffer + done, &arg->cursor->data[offset], span);
+		}
+		done += span;
+		arg->position += span;
+	}
+}
+
+static int ram_save(ram_file_t* file) {
+	char path[RAM_MAX_NAME + 8];
+	snprintf(path, sizeof(path), "/usd/%s", file->name);
+	int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC);
+	if (fd < 0) return PROS_ERR;
+	size_t remaining = file->size;
+	for (ram_extent_t* extent = file->extents; extent != NULL && remaining > 0; extent = extent->next) {
+		size_t len = remaining < extent->size ? remaining : extent->size;
+		if (write(fd, extent->data, len) != (ssize_t)len) {
+			close(fd);
+			errno = EIO;
+			return PROS_ERR;
+		}
+		remaining -= len;
+	}
+	close(fd);
+	return 0;
+}
+
+/******************************************************************************/
+/**                         newlib driver functions                          **/
+/******************************************************************************/
+int ram_read_r(struct _reent* r, void* const arg, uint8_t* buffer, const size_t len) {
+	ram_file_arg_t* file_arg = (ram_file_arg_t*)arg;
+	if ((file_arg->flags & O_ACCMODE) == O_WRONLY) {
+		r->_errno = EBADF;
+		return -1;
+	}
+	mutex_take(ram_mutex, TIMEOUT_MAX);
+	size_t count = 0;
+	if (file_arg->position < file_arg->file->size) {
+		count = file_arg->file->size - file_arg->position;
+		if (count > len) count = len;
+		ram_copy(file_arg, buffer, count, false);
+	}
+	mutex_give(ram_mutex);
+	return count;
+}
+
+int ram_write_r(struct _reent* r, void* const arg, const uint8_t* buf, const size_t len) {
+	ram_file_arg_t* file_arg = (ram_file_arg_t*)arg;
+	ram_file_t* file = file_arg->file;
+	if ((file_arg->flags & O_ACCMODE) == O_RDONLY) {
+		r->_errno = EBADF;
+		return -1;
+	}
+	mutex_take(ram_mutex, TIMEOUT_MAX);
+	if (file_arg->flags & O_APPEND) file_arg->position = file->size;
+	size_t end = file_arg->position + len;
+	size_t count = len;
+	if (!ram_reserve(file, end)) {
+		// write as much as fits
+		end = file->allocated > file_arg->position ? file->allocated : file_arg->position;
+		count = end - file_arg->position;
+	}
+	if (file_arg->position > file->size && count > 0) {
+		// fill the gap left by seeking past the end with zeros
+		size_t position = file_arg->position;
+		file_arg->position = file->size;
+		while (file_arg->position < position) {
+			static const uint8_t zeros[64];
+			size_t span = position - file_arg->position;
+			ram_copy(file_arg, (uint8_t*)zeros, span < sizeof(zeros) ? span : sizeof(zeros), true);
+		}
+	}
+	ram_copy(file_arg, (uint8_t*)buf, count, true);
+	if (file_arg->position > file->size) file->size = file_arg->position;
+	mutex_give(ram_mutex);
+	if (count == 0 && len > 0) {
+		r->_errno = ENOSPC;
+		return -1;
+	}
+	return count;
+}
+
+int ram_close_r(struct _reent* r, void* const arg) {
+	ram_file_arg_t* file_arg = (ram_file_arg_t*)arg;
+	mutex_take(ram_mutex, TIMEOUT_MAX);
+	file_arg->file->open_count--;
+	ram_release(file_arg->file);
+	mutex_give(ram_mutex);
+	kfree(file_arg);
+	return 0;
+}
+
+int ram_fstat_r(struct _reent* r, void* const arg, struct stat* st) {
+	ram_file_arg_t* file_arg = (ram_file_arg_t*)arg;
+	st->st_mode = S_IFREG;
+	st->st_size = file_arg->file->size;
+	return 0;
+}
+
+int ram_isatty_r(struct _reent* r, void* const arg) {
+	return 0;
+}
+
+off_t ram_lseek_r(struct _reent* r, void* const arg, off_t ptr, int dir) {
+	ram_file_arg_t* file_arg = (ram_file_arg_t*)arg;
+	off_t base;
+	switch (dir) {
+		case SEEK_SET:
+			base = 0;
+			break;
+		case SEEK_CUR:
+			base = file_arg->position;
+			break;
+		case SEEK_END:
+			base = file_arg->file->size;
+			break;
+		default:
+			r->_errno = EINVAL;
+			return (off_t)-1;
+	}
+	if (base + ptr < 0) {
+		r->_errno = EINVAL;
+		return (off_t)-1;
+	}
+	file_arg->position = base + ptr;
+	return file_arg->position;
+}
+
+int ram_ctl(void* const arg, const uint32_t cmd, void* const extra_arg) {
+	ram_file_arg_t* file_arg = (ram_file_arg_t*)arg;
+	int rtn = 0;
+	switch (cmd) {
+		case RAMCTL_PERSIST:
+			file_arg->file->persist = extra_arg != NULL;
+			return 0;
+		case RAMCTL_SAVE:
+			mutex_take(ram_mutex, TIMEOUT_MAX);
+			rtn = ram_save(file_arg->file);
+			mutex_give(ram_mutex);
+			return rtn;
+		default:
+			errno = EINVAL;
+			return PROS_ERR;
+	}
+}
+
+/******************************************************************************/
+/**                           Driver description                             **/
+/******************************************************************************/
+
+const struct fs_driver _ram_driver = {.close_r = ram_close_r,
+                                      .fstat_r = ram_fstat_r,
+                                      .isatty_r = ram_isatty_r,
+                                      .lseek_r = ram_lseek_r,
+                                      .read_r = ram_read_r,
+                                      .write_r = ram_write_r,
+                                      .ctl = ram_ctl};
+const struct fs_driver* const ram_driver = &_ram_driver;
+
+int ram_open_r(struct _reent* r, const char* path, int flags, int mode) {
+	if (*path == '/') path++;
+	if (*path == '\0') {
+		r->_errno = ENOENT;
+		return -1;
+	}
+	if (strlen(path) >= RAM_MAX_NAME) {
+		r->_errno = ENAMETOOLONG;
+		return -1;
+	}
+	// the usd driver creates files for any write, so do the same
+	if ((flags & O_ACCMODE) != O_RDONLY) flags |= O_CREAT;
+
+	ram_file_arg_t* file_arg = kmalloc(sizeof(*file_arg));
+	if (file_arg == NULL) {
+		r->_errno = ENOMEM;
+		return -1;
+	}
+	mutex_take(ram_mutex, TIMEOUT_MAX);
+	ram_file_t* file = ram_find(path);
+	if (file != NULL && (flags & O_CREAT) && (flags & O_EXCL)) {
+		mutex_give(ram_mutex);
+		kfree(file_arg);
+		r->_errno = EEXIST;
+		return -1;
+	}
+	if (file == NULL) {
+		if (!(flags & O_CREAT)) {
+			mutex_give(ram_mutex);
+			kfree(file_arg);
+			r->_errno = ENOENT;
+			return -1;
+		}
+		file = ram_used + sizeof(ram_file_t) <= ram_capacity ? kmalloc(sizeof(ram_file_t)) : NULL;
+		if (file == NULL) {
+			mutex_give(ram_mutex);
+			kfree(file_arg);
+			r->_errno = ENOSPC;
+			return -1;
+		}
+		memset(file, 0, sizeof(*file));
+		strcpy(file->name, path);
+		file->next = ram_files;
+		ram_files = file;
+		ram_used += sizeof(ram_file_t);
+	} else if ((flags & O_TRUNC) && (flags & O_ACCMODE) != O_RDONLY) {
+		ram_free_extents(file);
+	}
+	file->open_count++;
+	mutex_give(ram_mutex);
+
+	memset(file_arg, 0, sizeof(*file_arg));
+	file_arg->file = file;
+	file_arg->flags = flags;
+	file_arg->generation = file->generation;
+	return vfs_add_entry_r(r, ram_driver, file_arg);
+}
+
+int ram_unlink_r(struct _reent* r, const char* path) {
+	if (*path == '/') path++;
+	mutex_take(ram_mutex, TIMEOUT_MAX);
+	ram_file_t* file = ram_find(path);
+	if (file == NULL) {
+		mutex_give(ram_mutex);
+		r->_errno = ENOENT;
+		return -1;
+	}
+	// open handles keep the data until they are closed
+	file->unlinked = true;
+	ram_release(file);
+	mutex_give(ram_mutex);
+	return 0;
+}
+
+// Saves every file marked with RAMCTL_PERSIST, returning PROS_ERR if any fails.
+// The RAM mutex must be held.
+static int32_t ram_save_all(void) {
+	int32_t rtn = 0;
+	for (ram_file_t* file = ram_files; file != NULL; file = file->next) {
+		if (file->persist && !file->unlinked && ram_save(file) == PROS_ERR) rtn = PROS_ERR;
+	}
+	return rtn;
+}
+
+bool ram_save_persisted(void) {
+	// the exiting task or one that will never run again may hold the mutex
+	if (!mutex_take(ram_mutex, 0)) return false;
+	ram_save_all();
+	mutex_give(ram_mutex);
+	return true;
+}
+
+int32_t ramctl(const uint32_t action, void* const extra_arg) {
+	int32_t rtn = 0;
+	mutex_take(ram_mutex, TIMEOUT_MAX);
+	switch (action) {
+		case RAMCTL_SET_CAPACITY:
+			if ((size_t)extra_arg < ram_used) {
+				errno = EBUSY;
+				rtn = PROS_ERR;
+			} else {
+				ram_capacity = (size_t)extra_arg;
+			}
+			break;
+		case RAMCTL_GET_USAGE:
+			rtn = ram_used;
+			break;
+		case RAMCTL_SAVE:
+			rtn = ram_save_all();
+			break;
+		default:
+			errno = EINVAL;
+			rtn = PROS_ERR;
+	}
+	mutex_give(ram_mutex);
+	return rtn;
+}
@@ -7,6 +7,11 @@
  * characters and responding to any kernel commands (like printing the banner or
  * enabling COBS)
  *
+ * Kernel commands start with "pR" and a command character, followed by a fixed
+ * number of argument bytes. The one exception is '$', which is followed by a
+ * text line for the serial shell (see system/shell.c). Everything else is
+ * placed on the input buffer for stdin.
+ *
  * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
  * All rights reserved.
  *
@@ -19,11 +24,16 @@
 
 #include "kapi.h"
 #include "system/dev/banners.h"
+#include "system/dev/ser.h"
+#include "system/dev/wait.h"
 #include "system/hot.h"
 #include "system/optimizers.h"
+#include "system/shell.h"
 #include "v5_api.h"
 
 #define MAX_COMMAND_LENGTH 32
+#define SHELL_COMMAND '$'
+#define SHELL_LINE_TIMEOUT 500  // ms to wait for the end of a shell line
 
 __attribute__((weak)) char const* const _PROS_COMPILE_TIMESTAMP = "Unknown";
 __attribute__((weak)) char const* const _PROS_COMPILE_DIRECTORY = "Unknown";
@@ -67,7 +77,9 @@ static inline void inp_buffer_initialize() {
 // if you extern this function you can place characters on the rest of the
 // system's input buffer
 bool inp_buffer_post(uint8_t b) {
-	return stream_buf_send(inp_stream, &b, 1, TIMEOUT_MAX);
+	bool rtn = stream_buf_send(inp_stream, &b, 1, TIMEOUT_MAX);
+	io_wake(WAIT_SER_IN);
+	return rtn;
 }
 
 int32_t inp_buffer_read(uint32_t timeout) {
@@ -84,7 +96,7 @@ int32_t inp_buffer_read(uint32_t timeout) {
 }
 
 // returns the number of bytes currently in the stream
-int32_t inp_buffer_available() {
+int32_t inp_buffer_available(void) {
 	return stream_buf_get_used(inp_stream);
 }
 
@@ -105,6 +117,98 @@ static inline uint8_t vex_read_char() {
 	return (uint8_t)b;
 }
 
+// Like vex_read_char, but gives up and returns -1 once millis() reaches
+// deadline
+static int32_t vex_read_char_until(uint32_t deadline) {
+	int32_t b = vexSerialReadChar(1);
+	while (b == -1L) {
+		if ((int32_t)(deadline - millis()) <= 0) return -1;
+		task_delay(1);
+		b = vexSerialReadChar(1);
+	}
+	return b;
+}
+
+static void command_alive(uint8_t const* args) {
+	fprintf(stderr, "I'm alive!\n");
+}
+
+static void command_small_banner(uint8_t const* args) {
+	task_delay(20);
+	print_small_banner();
+}
+
+static void command_large_banner(uint8_t const* args) {
+	task_delay(20);
+	print_large_banner();
+}
+
+// the parameter expected to serctl is the stream id (a uint32_t), so we need to
+// read the 4 argument bytes as one and cast to a void* to make the compiler happy
+static void command_activate(uint8_t const* args) {
+	serctl(SERCTL_ACTIVATE, (void*)(*(uint32_t*)args));
+}
+
+static void command_deactivate(uint8_t const* args) {
+	serctl(SERCTL_DEACTIVATE, (void*)(*(uint32_t*)args));
+}
+
+static void command_enable_cobs(uint8_t const* args) {
+	serctl(SERCTL_ENABLE_COBS, NULL);
+}
+
+static void command_disable_cobs(uint8_t const* args) {
+	serctl(SERCTL_DISABLE_COBS, NULL);
+}
+
+typedef struct ser_command {
+	uint8_t code;     // character after "pR"
+	uint8_t arg_len;  // number of bytes after the code
+	void (*run)(uint8_t const* args);
+} ser_command_t;
+
+static const ser_command_t ser_commands[] = {{'a', 0, command_alive},        {'b', 0, command_small_banner},
+                                             {'B', 0, command_large_banner}, {'e', 4, command_activate},
+                                             {'d', 4, command_deactivate},   {'c', 0, command_enable_cobs},
+                                             {'r', 0, command_disable_cobs}};
+
+// reads a shell line up to a newline and queues it. Lines that are too long are
+// dropped whole. If the newline doesn't come within SHELL_LINE_TIMEOUT, the
+// bytes were probably program input that happened to start with the prefix, so
+// they are handed to stdin instead of holding it up
+static void read_shell_line(void) {
+	char line[SHELL_LINE_MAX];
+	size_t len = 0;
+	bool overflow = false;
+	uint32_t deadline = millis() + SHELL_LINE_TIMEOUT;
+	int32_t b;
+	while ((b = vex_read_char_until(deadline)) != '\n' && b != '\r') {
+		if (b == -1) {
+			if (overflow) break;
+			const char prefix[] = {'p', 'R', SHELL_COMMAND};
+			for (size_t i = 0; i < sizeof(prefix); i++) inp_buffer_post(prefix[i]);
+			for (size_t i = 0; i < len; i++) inp_buffer_post(line[i]);
+			return;
+		}
+		if (len < SHELL_LINE_MAX - 1) {
+			line[len++] = b;
+		} else {
+			overflow = true;
+		}
+	}
+	if (b == '\r') {
+		// a CRLF line ending would otherwise leave its '\n' on stdin
+		while ((b = vexSerialPeekChar(1)) == -1 && (int32_t)(deadline - millis()) > 0) task_delay(1);
+		if (b == '\n') vexSerialReadChar(1);
+	}
+	line[len] = '\0';
+	if (overflow) {
+		fprintf(stderr, "shell: line longer than %d bytes\n", SHELL_LINE_MAX - 1);
+	} else if (!shell_post_line(line)) {
+		fprintf(stderr, "shell: busy\n");
+	}
+}
+
 static void ser_daemon_task(void* ign) {
 	uint8_t command_stack[MAX_COMMAND_LENGTH];
 	size_t command_stack_idx = 0;
@@ -117,58 +221,22 @@ static void ser_daemon_task(void* ign) {
 			command_stack[command_stack_idx++] = b;
 			b = command_stack[command_stack_idx++] = vex_read_char();
 			if (b == 'R') {
-				b = command_stack[command_stack_idx++] = vex_read_char();
-				switch (b) {
-					case 'a':
-						fprintf(stderr, "I'm alive!\n");
-						command_stack_idx = 0;
-						break;
-					case 'b':
-						task_delay(20);
-						print_small_banner();
-						command_stack_idx = 0;
-						break;
-					case 'B':
-						task_delay(20);
-						print_large_banner();
-						command_stack_idx = 0;
-						break;
-					case 'e':
-						// read next 4 bytes
-						command_stack[command_stack_idx++] = vex_read_char();
-						command_stack[command_stack_idx++] = vex_read_char();
-						command_stack[command_stack_idx++] = vex_read_char();
-						command_stack[command_stack_idx++] = vex_read_char();
-						// the parameter expected to serctl is the stream id (a uint32_t), so
-						// we
-						// need to cast to a uint32_t pointer, dereference it, and cast to a
-						// void* to make the compiler happy
-						serctl(SERCTL_ACTIVATE, (void*)(*(uint32_t*)(command_stack + 3)));
-						// printf("enabled %s\n", command_stack + 3);
-						command_stack_idx = 0;
-						break;
-					case 'd':
-						// read next 4 bytes
-						command_stack[command_stack_idx++] = vex_read_char();
-						command_stack[command_stack_idx++] = vex_read_char();
-						command_stack[command_stack_idx++] = vex_read_char();
-						command_stack[command_stack_idx++] = vex_read_char();
-						serctl(SERCTL_DEACTIVATE, (void*)(*(uint32_t*)(command_stack + 3)));
-						// printf("disabled %s\n", command_stack+3);
-						command_stack_idx = 0;
-						break;
-					case 'c':
-						serctl(SERCTL_ENABLE_COBS, NULL);
-						command_stack_idx = 0;
-						break;
-					case 'r':
-						serctl(SERCTL_DISABLE_COBS, NULL);
-						command_stack_idx = 0;
-						break;
-					default:
-						command_stack_idx = 0;
-						break;
+				b = vex_read_char();
+				if (b == SHELL_COMMAND) {
+					read_shell_line();
+				} else {
+					for (size_t i = 0; i < sizeof(ser_commands) / sizeof(*ser_commands); i++) {
+						if (ser_commands[i].code == b) {
+							for (size_t j = 0; j < ser_commands[i].arg_len; j++) {
+								command_stack[j] = vex_read_char();
+							}
+							ser_commands[i].run(command_stack);
+							break;
+						}
+					}
 				}
+				// unknown commands are dropped
+				command_stack_idx = 0;
 			}
 
 			for (size_t i = 0; i < command_stack_idx; i++) {
@@ -188,6 +256,8 @@ void ser_initialize(void) {
 	extern void ser_driver_initialize(void);
 	ser_driver_initialize();
 
+	shell_initialize();
+
 	task_create_static(ser_daemon_task, NULL, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_MIN, "Serial Daemon (PROS)",
 	                   ser_daemon_stack, &ser_daemon_task_buffer);
 }
@@ -22,6 +22,7 @@
 #include "kapi.h"
 #include "system/dev/ser.h"
 #include "system/dev/vfs.h"
+#include "system/dev/wait.h"
 #include "system/optimizers.h"
 #include "v5_api.h"
 
@@ -87,9 +88,6 @@ static const uint32_t guaranteed_delivery_streams[] = {
 // global runtime config for the serial driver
 static enum { E_COBS_ENABLED = 1 } ser_driver_runtime_config;
 
-// comes from ser_daemon
-extern int32_t inp_buffer_read(uint32_t timeout);
-
 /******************************************************************************/
 /**                              Output queue                                **/
 /**                                                                          **/
@@ -242,6 +240,32 @@ int ser_ctl(void* const arg, const uint32_t cmd, void* const extra_arg) {
 	}
 }
 
+int ser_poll_r(struct _reent* r, void* const arg, int events, uint64_t* sources) {
+	const ser_file_s_t file = *(ser_file_s_t*)arg;
+	int revents = 0;
+	if (events & POLLIN) {
+		// every serial file reads from the same input buffer
+		if (inp_buffer_available() > 0) revents |= POLLIN;
+		*sources |= WAIT_SER_IN;
+	}
+	if (events & POLLOUT) {
+		// writes to a disabled stream are dropped, so they never block
+		if ((!list_contains(guaranteed_delivery_streams, guaranteed_delivery_streams_size, file.stream_id) &&
+		     !set_contains(&enabled_streams_set, file.stream_id)) ||
+		    stream_buf_get_unused(write_stream) > 0) {
+			revents |= POLLOUT;
+		}
+		*sources |= WAIT_SER_OUT;
+	}
+	return revents;
+}
+
+// Wakes tasks waiting for space in the output buffer. Called by the system
+// daemon after it flushes the buffer.
+void ser_output_wake(void) {
+	if ((io_wait_sources() & WAIT_SER_OUT) && stream_buf_get_unused(write_stream) > 0) io_wake(WAIT_SER_OUT);
+}
+
 /******************************************************************************/
 /**                           Driver description                             **/
 /******************************************************************************/
@@ -251,7 +275,8 @@ const struct fs_driver _ser_driver = {.close_r = ser_close_r,
                                       .lseek_r = ser_lseek_r,
                                       .read_r = ser_read_r,
                                       .write_r = ser_write_r,
-                                      .ctl = ser_ctl};
+                                      .ctl = ser_ctl,
+                                      .poll_r = ser_poll_r};
 
 const struct fs_driver* const ser_driver = &_ser_driver;
 
@@ -3,6 +3,13 @@
  *
  * Contains the driver for writing files to the microSD card.
  *
+ * Files opened for writing can be switched into a write-behind logging mode
+ * with fdctl. Writes to a log only copy into a RAM ring, and a low priority
+ * task moves the ring to the card in sector aligned chunks, so logging from a
+ * control loop never waits on FatFs. Since the logging task and user tasks can
+ * now use the card at the same time, every call into the VEXos file API is
+ * serialized by a single mutex.
+ *
  * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
  * All rights reserved.
  *
@@ -25,8 +32,38 @@
 #include "system/optimizers.h"
 #include "v5_api.h"
 
+#define USD_SECTOR_SIZE 512
+// VEXos allows at most 8 files open at once
+#define USD_LOG_MAX_FILES 8
+#define USD_LOG_DEFAULT_SIZE 16384
+// largest single write the logging task makes, so one busy log can not starve
+// the others
+#define USD_LOG_MAX_CHUNK 4096
+#define USD_LOG_PERIOD 10  // ms
+// buffered data older than this is written even if it does not fill a sector
+#define USD_LOG_MAX_AGE 1000  // ms
+
+typedef struct usd_log {
+	FIL* fptr;
+	uint8_t* ring;
+	uint32_t capacity;
+	// writers only move head and the logging task only moves tail
+	volatile uint32_t head;
+	volatile uint32_t tail;
+	// file offset the byte at tail will be written to
+	uint32_t file_offset;
+	uint32_t last_flush;
+	// serializes writers to the ring
+	mutex_t write_mutex;
+	// held while moving data from the ring to the card, or while the log is
+	// being started or stopped
+	mutex_t flush_mutex;
+	usd_log_stats_s_t stats;
+} usd_log_t;
+
 typedef struct usd_file_arg {
 	FIL* ifi_fptr;
+	usd_log_t* log;  // NULL unless write-behind logging is enabled
 } usd_file_arg_t;
 
 static const int FRESULTMAP[] = {0,       EIO,    EINVAL, EBUSY, ENOENT,  ENOENT, EINVAL, EACCES,  // FR_DENIED
@@ -40,32 +77,233 @@ enum fa_flags {
 	FA_CREATE_NEW = 1 << 4
 };
 
+static static_sem_s_t usd_mutex_buf;
+static mutex_t usd_mutex;
+
+// Log slots are never freed, so the logging task can walk them without holding
+// usd_mutex. A slot is in use while its ring is not NULL.
+static usd_log_t usd_logs[USD_LOG_MAX_FILES];
+static static_sem_s_t usd_log_mutex_bufs[USD_LOG_MAX_FILES][2];
+static task_stack_t usd_log_task_stack[TASK_STACK_DEPTH_DEFAULT];
+static static_task_s_t usd_log_task_buffer;
+static task_t usd_log_task = NULL;
+static volatile bool usd_log_flush_requested = false;
+
+void usd_initialize(void) {
+	usd_mutex = mutex_create_static(&usd_mutex_buf);
+	for (size_t i = 0; i < USD_LOG_MAX_FILES; i++) {
+		usd_logs[i].write_mutex = mutex_create_static(&usd_log_mutex_bufs[i][0]);
+		usd_logs[i].flush_mutex = mutex_create_static(&usd_log_mutex_bufs[i][1]);
+	}
+}
+
+/******************************************************************************/
+/**                          write-behind logging                            **/
+/******************************************************************************/
+
+static uint32_t usd_log_count(usd_log_t* log) {
+	return (log->head + log->capacity - log->tail) % log->capacity;
+}
+
+// Writes buffered data to the card. Unless all is set or the data has been
+// waiting too long, only whole sectors are written, ending on a sector boundary
+// of the file. Call with flush_mutex held.
+static void usd_log_flush(usd_log_t* log, bool all) {
+	uint32_t count = usd_log_count(log);
+	__sync_synchronize();  // read data only after seeing the new head
+	uint32_t amount = count;
+	if (!all && millis() - log->last_flush < USD_LOG_MAX_AGE) {
+		uint32_t partial = log->file_offset % USD_SECTOR_SIZE;
+		if (count + partial < USD_SECTOR_SIZE) return;
+		amount = (count + partial) / USD_SECTOR_SIZE * USD_SECTOR_SIZE;
+		if (amount > USD_LOG_MAX_CHUNK) amount = USD_LOG_MAX_CHUNK;
+		amount -= partial;
+	}
+	if (amount == 0 && !all) {
+		log->last_flush = millis();
+		return;
+	}
+
+	uint64_t start = micros();
+	uint32_t tail = log->tail;
+	uint32_t written = 0;
+	mutex_take(usd_mutex, TIMEOUT_MAX);
+	while (written < amount) {
+		// the ring wraps at most once
+		uint32_t span = log->capacity - tail;
+		if (span > amount - written) span = amount - written;
+		int32_t result = vexFileWrite((char*)&log->ring[tail], 1, span, log->fptr);
+		if (result <= 0) {
+			log->stats.write_errors++;
+			break;
+		}
+		tail = (tail + result) % log->capacity;
+		written += result;
+		log->stats.flushes++;
+	}
+	if (all) vexFileSync(log->fptr);
+	mutex_give(usd_mutex);
+
+	__sync_synchronize();  // finish reading before releasing the space
+	log->tail = tail;
+	log->file_offset += written;
+	log->stats.bytes_written += written;
+	log->last_flush = millis();
+	uint32_t duration = micros() - start;
+	if (duration > log->stats.max_flush_us) log->stats.max_flush_us = duration;
+}
+
+static void usd_log_task_fn(void* ign) {
+	while (true) {
+		task_notify_take(true, USD_LOG_PERIOD);
+		bool all = usd_log_flush_requested;
+		usd_log_flush_requested = false;
+		for (size_t i = 0; i < USD_LOG_MAX_FILES; i++) {
+			usd_log_t* log = &usd_logs[i];
+			if (log->ring == NULL) continue;
+			mutex_take(log->flush_mutex, TIMEOUT_MAX);
+			// the log may have been stopped while waiting for the mutex
+			if (log->ring != NULL) usd_log_flush(log, all);
+			mutex_give(log->flush_mutex);
+		}
+	}
+}
+
+// Called by the system daemon on competition state changes. Must not block.
+void usd_log_request_flush(void) {
+	usd_log_flush_requested = true;
+	if (usd_log_task != NULL) task_notify(usd_log_task);
+}
+
+static int usd_log_start(usd_file_arg_t* file_arg, uint32_t size) {
+	if (file_arg->log != NULL) {
+		errno = EEXIST;
+		return PROS_ERR;
+	}
+	if (size == 0) size = USD_LOG_DEFAULT_SIZE;
+	if (size < USD_SECTOR_SIZE) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	uint8_t* ring = kmalloc(size);
+	if (ring == NULL) {
+		errno = ENOMEM;
+		return PROS_ERR;
+	}
+
+	mutex_take(usd_mutex, TIMEOUT_MAX);
+	usd_log_t* log = NULL;
+	for (size_t i = 0; i < USD_LOG_MAX_FILES && log == NULL; i++) {
+		if (usd_logs[i].fptr == NULL) {
+			log = &usd_logs[i];
+			log->fptr = file_arg->ifi_fptr;
+		}
+	}
+	uint32_t offset = vexFileTell(file_arg->ifi_fptr);
+	if (usd_log_task == NULL && log != NULL) {
+		usd_log_task = task_create_static(usd_log_task_fn, NULL, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT,
+		                                  "PROS SD Logger", usd_log_task_stack, &usd_log_task_buffer);
+	}
+	mutex_give(usd_mutex);
+	if (log == NULL) {
+		kfree(ring);
+		errno = ENFILE;
+		return PROS_ERR;
+	}
+
+	mutex_take(log->flush_mutex, TIMEOUT_MAX);
+	memset(&log->stats, 0, sizeof(log->stats));
+	log->capacity = size;
+	log->head = 0;
+	log->tail = 0;
+	log->file_offset = offset;
+	log->last_flush = millis();
+	log->ring = ring;
+	mutex_give(log->flush_mutex);
+	file_arg->log = log;
+	return 0;
+}
+
+// Writes out everything buffered and gives up the log's slot
+static void usd_log_stop(usd_file_arg_t* file_arg) {
+	usd_log_t* log = file_arg->log;
+	mutex_take(log->flush_mutex, TIMEOUT_MAX);
+	usd_log_flush(log, true);
+	uint8_t* ring = log->ring;
+	log->ring = NULL;
+	mutex_give(log->flush_mutex);
+	mutex_take(usd_mutex, TIMEOUT_MAX);
+	log->fptr = NULL;
+	mutex_give(usd_mutex);
+	file_arg->log = NULL;
+	kfree(ring);
+}
+
+static int usd_log_write(usd_log_t* log, const uint8_t* buf, const size_t len) {
+	mutex_take(log->write_mutex, TIMEOUT_MAX);
+	uint32_t count = usd_log_count(log);
+	if (len > log->capacity - 1 - count) {
+		// drop the whole write rather than block or split a record
+		log->stats.writes_dropped++;
+		log->stats.bytes_dropped += len;
+		mutex_give(log->write_mutex);
+		return len;
+	}
+	uint32_t head = log->head;
+	uint32_t first = log->capacity - head;
+	if (first > len) first = len;
+	memcpy(&log->ring[head], buf, first);
+	memcpy(log->ring, buf + first, len - first);
+	__sync_synchronize();  // publish the data before the new head
+	log->head = (head + len) % log->capacity;
+	if (count + len > log->stats.high_water) log->stats.high_water = count + len;
+	mutex_give(log->write_mutex);
+	return len;
+}
+
 /******************************************************************************/
 /**                         newlib driver functions                          **/
 /******************************************************************************/
 int usd_read_r(struct _reent* r, void* const arg, uint8_t* buffer, const size_t len) {
 	usd_file_arg_t* file_arg = (usd_file_arg_t*)arg;
-	// TODO: mutex here. Global or file lock?
+	mutex_take(usd_mutex, TIMEOUT_MAX);
 	int32_t result = vexFileRead((char*)buffer, sizeof(*buffer), len, file_arg->ifi_fptr);
+	mutex_give(usd_mutex);
 	return result;
 }
 
 int usd_write_r(struct _reent* r, void* const arg, const uint8_t* buf, const size_t len) {
 	usd_file_arg_t* file_arg = (usd_file_arg_t*)arg;
-	// TODO: mutex here. Global or file lock?
+	if (file_arg->log != NULL) {
+		return usd_log_write(file_arg->log, buf, len);
+	}
+	mutex_take(usd_mutex, TIMEOUT_MAX);
 	int32_t result = vexFileWrite((char*)buf, sizeof(*buf), len, file_arg->ifi_fptr);
+	mutex_give(usd_mutex);
 	return result;
 }
 
 int usd_close_r(struct _reent* r, void* const arg) {
 	usd_file_arg_t* file_arg = (usd_file_arg_t*)arg;
+	if (file_arg->log != NULL) {
+		usd_log_stop(file_arg);
+	}
+	mutex_take(usd_mutex, TIMEOUT_MAX);
 	vexFileClose(file_arg->ifi_fptr);
+	mutex_give(usd_mutex);
+	kfree(file_arg);
 	return 0;
 }
 
 int usd_fstat_r(struct _reent* r, void* const arg, struct stat* st) {
 	usd_file_arg_t* file_arg = (usd_file_arg_t*)arg;
+	if (file_arg->log != NULL) {
+		st->st_size = file_arg->log->file_offset + usd_log_count(file_arg->log);
+		return 0;
+	}
+	mutex_take(usd_mutex, TIMEOUT_MAX);
 	st->st_size = vexFileSize(file_arg->ifi_fptr);
+	mutex_give(usd_mutex);
 	return 0;
 }
 
@@ -75,17 +313,59 @@ int usd_isatty_r(struct _reent* r, void* const arg) {
 
 off_t usd_lseek_r(struct _reent* r, void* const arg, off_t ptr, int dir) {
 	usd_file_arg_t* file_arg = (usd_file_arg_t*)arg;
-	// TODO: mutex here. Global or file lock?
+	usd_log_t* log = file_arg->log;
+	if (log != NULL) {
+		// newlib asks for the position before every write to a file opened for
+		// appending, so answer that without waiting for the ring to drain
+		if (ptr == 0 && (dir == SEEK_CUR || dir == SEEK_END)) {
+			return log->file_offset + usd_log_count(log);
+		}
+		mutex_take(log->flush_mutex, TIMEOUT_MAX);
+		usd_log_flush(log, true);
+	}
+	mutex_take(usd_mutex, TIMEOUT_MAX);
 	FRESULT result = vexFileSeek(file_arg->ifi_fptr, ptr, dir);
+	int32_t position = vexFileTell(file_arg->ifi_fptr);
+	mutex_give(usd_mutex);
+	if (log != NULL) {
+		log->file_offset = position;
+		mutex_give(log->flush_mutex);
+	}
 	if (result != FR_OK) {
 		r->_errno = FRESULTMAP[result];
 		return (off_t)-1;
 	}
-	return vexFileTell(file_arg->ifi_fptr);
+	return position;
 }
 
 int usd_ctl(void* const arg, const uint32_t cmd, void* const extra_arg) {
-	return 0;
+	usd_file_arg_t* file_arg = (usd_file_arg_t*)arg;
+	switch (cmd) {
+		case USDCTL_WRITE_BEHIND:
+			return usd_log_start(file_arg, (uint32_t)extra_arg);
+		case USDCTL_SYNC:
+			if (file_arg->log != NULL) {
+				mutex_take(file_arg->log->flush_mutex, TIMEOUT_MAX);
+				usd_log_flush(file_arg->log, true);
+				mutex_give(file_arg->log->flush_mutex);
+			} else {
+				mutex_take(usd_mutex, TIMEOUT_MAX);
+				vexFileSync(file_arg->ifi_fptr);
+				mutex_give(usd_mutex);
+			}
+			return 0;
+		case USDCTL_GET_LOG_STATS:
+			if (file_arg->log == NULL || extra_arg == NULL) {
+				errno = EINVAL;
+				return PROS_ERR;
+			}
+			*(usd_log_stats_s_t*)extra_arg = file_arg->log->stats;
+			((usd_log_stats_s_t*)extra_arg)->buffered = usd_log_count(file_arg->log);
+			return 0;
+		default:
+			errno = EINVAL;
+			return PROS_ERR;
+	}
 }
 
 /******************************************************************************/
@@ -102,14 +382,18 @@ const struct fs_driver _usd_driver = {.close_r = usd_close_r,
 const struct fs_driver* const usd_driver = &_usd_driver;
 
 int usd_open_r(struct _reent* r, const char* path, int flags, int mode) {
+	mutex_take(usd_mutex, TIMEOUT_MAX);
 	FRESULT result = vexFileMountSD();
+	mutex_give(usd_mutex);
 	if (result != F_OK) {
 		r->_errno = FRESULTMAP[result];
 		return -1;
 	}
 
 	usd_file_arg_t* file_arg = kmalloc(sizeof(*file_arg));
+	file_arg->log = NULL;
 
+	mutex_take(usd_mutex, TIMEOUT_MAX);
 	switch (flags & O_ACCMODE) {
 		case O_RDONLY:
 			file_arg->ifi_fptr = vexFileOpen(path, "");  // mode is ignored
@@ -122,11 +406,15 @@ int usd_open_r(struct _reent* r, const char* path, int flags, int mode) {
 			}
 			break;
 		default:
+			mutex_give(usd_mutex);
+			kfree(file_arg);
 			r->_errno = EINVAL;
 			return -1;
 	}
+	mutex_give(usd_mutex);
 
 	if (!file_arg->ifi_fptr) {
+		kfree(file_arg);
 		r->_errno = ENFILE;  // up to 8 files max as of vexOS 0.7.4b55
 		return -1;
 	}
@@ -4,9 +4,14 @@
  * Virtual File System
  *
  * VFS is responsible for maintaining the global file table and routing all
- * basic I/O to the appropriate driver. There are three drivers implemented,
- * ser, dev, and usd which correspond to the serial driver, generic smart port
- * communication, and microSD card, respectively.
+ * basic I/O to the appropriate driver. There are four drivers implemented,
+ * ser, dev, usd, and ram which correspond to the serial driver, generic smart
+ * port communication, microSD card, and files kept in RAM, respectively.
+ *
+ * Drivers are found through the mount table, a small hash table keyed by the
+ * first component of the path (e.g. "usd" for /usd/log.txt). Opening a file
+ * hashes that component once instead of comparing the path against every
+ * driver, and more drivers can be mounted with vfs_mount at any time.
  *
  * VFS implements all of the I/O newlib stubs like open/read/write and delegates
  * them to the file's driver. Drivers don't actually have any knowledge of the
@@ -28,14 +33,23 @@
 #include "common/gid.h"
 #include "common/string.h"
 #include "kapi.h"
+#include "system/dev/aio.h"
 #include "system/dev/dev.h"
+#include "system/dev/ram.h"
 #include "system/dev/ser.h"
 #include "system/dev/usd.h"
 #include "system/dev/vfs.h"
+#include "system/dev/wait.h"
 #include "v5_api.h"
 
 #define MAX_FILELEN 128
-#define MAX_FILES_OPEN 31
+// size of the file table, including the reserved file descriptors. May be
+// overridden when building the kernel
+#ifndef MAX_FILES_OPEN
+#define MAX_FILES_OPEN 64
+#endif
+
+#define MAX_MOUNTS 16  // must be a power of two
 
 #define RESERVED_FILENOS 4  // reserve stdin, stdout, stderr, kdbg
 
@@ -50,10 +64,29 @@ static struct gid_metadata file_table_gids = {.bitmap = file_table_bmp,
 // file table mapping a file descriptor number to a driver and driver argument
 static struct file_entry file_table[MAX_FILES_OPEN];
 
+// mount table, an open addressing hash table with linear probing. Buckets are
+// only changed with the scheduler suspended, so lookups don't need a lock
+static struct fs_mount const* mount_table[MAX_MOUNTS];
+// marks a bucket whose mount was removed, so probing continues past it
+static const struct fs_mount mount_removed;
+
+static const struct fs_mount ser_mount = {.name = "ser", .open_r = ser_open_r};
+static const struct fs_mount usd_mount = {.name = "usd", .open_r = usd_open_r};
+static const struct fs_mount dev_mount = {.name = "dev", .open_r = dev_open_r};
+static const struct fs_mount ram_mount = {.name = "ram", .open_r = ram_open_r, .unlink_r = ram_unlink_r};
+
 void vfs_initialize(void) {
 	gid_init(&file_table_gids);
 
 	ser_initialize();
+	usd_initialize();
+	ram_initialize();
+	aio_initialize();
+
+	vfs_mount(&ser_mount);
+	vfs_mount(&usd_mount);
+	vfs_mount(&dev_mount);
+	vfs_mount(&ram_mount);
 
 	// Force _GLOBAL_REENT initialization for C++ stdio to work. See D97
 	extern void __sinit(struct _reent * s);
@@ -89,6 +122,87 @@ int vfs_update_entry(int file, struct fs_driver const* const driver, void* arg)
 	return 0;
 }
 
+// FNV-1a hash of the first len characters of name
+static uint32_t mount_hash(const char* name, size_t len) {
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < len; i++) {
+		hash ^= (uint8_t)name[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+// finds the mount named by the first len characters of name, or NULL if there
+// isn't one. If bucket isn't NULL, it is set to the bucket holding the mount
+static struct fs_mount const* mount_find(const char* name, size_t len, uint32_t* bucket) {
+	uint32_t b = mount_hash(name, len) & (MAX_MOUNTS - 1);
+	for (size_t probes = 0; probes < MAX_MOUNTS; probes++, b = (b + 1) & (MAX_MOUNTS - 1)) {
+		struct fs_mount const* mount = __atomic_load_n(&mount_table[b], __ATOMIC_ACQUIRE);
+		if (mount == NULL) break;
+		if (mount != &mount_removed && strncmp(mount->name, name, len) == 0 && mount->name[len] == '\0') {
+			if (bucket != NULL) *bucket = b;
+			return mount;
+		}
+	}
+	return NULL;
+}
+
+// finds the mount for an absolute path and where the rest of the path starts
+static struct fs_mount const* mount_lookup(const char* path, const char** rest) {
+	if (*path != '/') return NULL;
+	path++;
+	size_t len = strcspn(path, "/");
+	*rest = path + len;
+	return mount_find(path, len, NULL);
+}
+
+int vfs_mount(struct fs_mount const* const mount) {
+	if (mount == NULL || mount->name == NULL || mount->open_r == NULL || *mount->name == '\0' ||
+	    strchr(mount->name, '/') != NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+	size_t len = strlen(mount->name);
+	int ret = 0;
+	rtos_suspend_all();
+	if (mount_find(mount->name, len, NULL) != NULL) {
+		errno = EEXIST;
+		ret = -1;
+	} else {
+		uint32_t bucket = mount_hash(mount->name, len) & (MAX_MOUNTS - 1);
+		size_t probes;
+		for (probes = 0; probes < MAX_MOUNTS; probes++, bucket = (bucket + 1) & (MAX_MOUNTS - 1)) {
+			if (mount_table[bucket] == NULL || mount_table[bucket] == &mount_removed) {
+				__atomic_store_n(&mount_table[bucket], mount, __ATOMIC_RELEASE);
+				break;
+			}
+		}
+		if (probes == MAX_MOUNTS) {
+			errno = ENOSPC;
+			ret = -1;
+		}
+	}
+	rtos_resume_all();
+	return ret;
+}
+
+int vfs_unmount(const char* name) {
+	if (name == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+	uint32_t bucket;
+	rtos_suspend_all();
+	struct fs_mount const* mount = mount_find(name, strlen(name), &bucket);
+	if (mount != NULL) __atomic_store_n(&mount_table[bucket], &mount_removed, __ATOMIC_RELEASE);
+	rtos_resume_all();
+	if (mount == NULL) {
+		errno = ENOENT;
+		return -1;
+	}
+	return 0;
+}
+
 int _open(const char* file, int flags, int mode) {
 	struct _reent* r = _REENT;
 	// Check if the filename is too long or not NULL terminated
@@ -102,17 +216,28 @@ int _open(const char* file, int flags, int mode) {
 		r->_errno = ENAMETOOLONG;
 		return -1;
 	}
-	if (strstr(file, "/ser") == file) {
-		// is a serial pseudofile
-		return ser_open_r(r, file + strlen("/ser"), flags, mode);
-	} else if (strstr(file, "/usd") == file) {
-		return usd_open_r(r, file + strlen("/usd"), flags, mode);
-	} else if (strstr(file, "/dev") == file) {
-		return dev_open_r(r, file + strlen("/dev"), flags, mode);
+	const char* rest;
+	struct fs_mount const* mount = mount_lookup(file, &rest);
+	if (mount == NULL) {
+		r->_errno = ENOENT;
+		return -1;
 	}
+	return mount->open_r(r, rest, flags, mode);
+}
 
-	r->_errno = ENOENT;
-	return -1;
+int _unlink(const char* name) {
+	struct _reent* r = _REENT;
+	const char* rest;
+	struct fs_mount const* mount = mount_lookup(name, &rest);
+	if (mount == NULL) {
+		r->_errno = ENOENT;
+		return -1;
+	}
+	if (mount->unlink_r == NULL) {
+		r->_errno = ENOSYS;
+		return -1;
+	}
+	return mount->unlink_r(r, rest);
 }
 
 ssize_t _write(int file, const void* buf, size_t len) {
@@ -192,3 +317,52 @@ int32_t fdctl(int file, const uint32_t action, void* const extra_arg) {
 	}
 	return file_table[file].driver->ctl(file_table[file].arg, action, extra_arg);
 }
+
+int vfs_poll_r(struct _reent* r, int file, int events, uint64_t* sources) {
+	if (file < 0 || !gid_check(&file_table_gids, file)) return POLLNVAL;
+	if (file_table[file].driver->poll_r == NULL) return events & (POLLIN | POLLOUT);
+	return file_table[file].driver->poll_r(r, file_table[file].arg, events, sources) & (events | POLLERR | POLLHUP);
+}
+
+typedef struct {
+	struct _reent* r;
+	struct pollfd* fds;
+	nfds_t nfds;
+} poll_arg_t;
+
+static int32_t poll_check(void* arg, uint64_t* sources) {
+	poll_arg_t* args = (poll_arg_t*)arg;
+	int32_t ready = 0;
+	for (nfds_t i = 0; i < args->nfds; i++) {
+		struct pollfd* fd = &args->fds[i];
+		fd->revents = fd->fd < 0 ? 0 : vfs_poll_r(args->r, fd->fd, fd->events, sources);
+		if (fd->revents) ready++;
+	}
+	return ready;
+}
+
+int poll(struct pollfd* fds, nfds_t nfds, int timeout) {
+	struct _reent* r = _REENT;
+	if (fds == NULL && nfds > 0) {
+		r->_errno = EINVAL;
+		return -1;
+	}
+	int saved_errno = r->_errno;
+	poll_arg_t arg = {.r = r, .fds = fds, .nfds = nfds};
+	int ready = io_wait_for(0, poll_check, &arg, timeout < 0 ? TIMEOUT_MAX : (uint32_t)timeout);
+	// drivers may set errno while checking, which isn't an error of poll
+	r->_errno = saved_errno;
+	return ready;
+}
+
+int fsync(int file) {
+	if (file < 0 || !gid_check(&file_table_gids, file)) {
+		errno = EBADF;
+		return -1;
+	}
+	if (file_table[file].driver != usd_driver) {
+		// other files have nothing buffered outside of newlib
+		return 0;
+	}
+	return file_table[file].driver->ctl(file_table[file].arg, USDCTL_SYNC, NULL);
+}
@@ -0,0 +1,114 @@
+/**
+ * \file system/dev/wait.c
+ *
+ * I/O wait queue
+ *
+ * Lets a task sleep until any of several byte streams becomes readable or
+ * writable, instead of polling each one. Every source of I/O readiness (bytes
+ * arriving on a generic serial port, space freeing in the serial output buffer,
+ * and so on) is a bit in a 64 bit mask. A waiting task claims one of a few
+ * waiter slots with the mask of sources it cares about and sleeps on the slot's
+ * semaphore. Whatever notices a source becoming ready calls io_wake(), which
+ * posts the semaphore of every waiter watching it.
+ *
+ * Readiness is level triggered: waiters always check the streams themselves
+ * after waking, and after claiming a slot, so a wakeup that races with a claim
+ * is never lost and a spurious one only costs a recheck. A semaphore is used
+ * rather than the task's notification value so waiting never consumes
+ * notifications the task's own code relies on.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+
+#include "kapi.h"
+#include "system/dev/wait.h"
+
+#define IO_MAX_WAITERS 9  // one of them is held by the I/O worker while it is idle
+
+struct io_waiter {
+	volatile uint32_t in_use;
+	volatile uint64_t sources;
+	sem_t sem;
+	static_sem_s_t sem_buf;
+};
+
+static io_waiter_t io_waiters[IO_MAX_WAITERS];
+static volatile uint32_t io_waiter_count = 0;
+
+io_waiter_t* io_waiter_claim(uint64_t sources) {
+	io_waiter_t* waiter = NULL;
+	for (size_t i = 0; i < IO_MAX_WAITERS && waiter == NULL; i++) {
+		if (__sync_bool_compare_and_swap(&io_waiters[i].in_use, 0, 1)) waiter = &io_waiters[i];
+	}
+	if (waiter == NULL) {
+		errno = EBUSY;
+		return NULL;
+	}
+	if (waiter->sem == NULL) waiter->sem = sem_create_static(1, 0, &waiter->sem_buf);
+	sem_wait(waiter->sem, 0);  // drop a post left over from the last user of the slot
+	waiter->sources = sources;
+	__sync_fetch_and_add(&io_waiter_count, 1);
+	// publish the sources before the caller checks them
+	__sync_synchronize();
+	return waiter;
+}
+
+void io_waiter_sleep(io_waiter_t* waiter, uint32_t timeout) {
+	sem_wait(waiter->sem, timeout);
+}
+
+void io_waiter_release(io_waiter_t* waiter) {
+	waiter->sources = 0;
+	__sync_fetch_and_sub(&io_waiter_count, 1);
+	__sync_synchronize();
+	waiter->in_use = 0;
+}
+
+uint64_t io_wait_sources(void) {
+	if (io_waiter_count == 0) return 0;
+	uint64_t sources = 0;
+	for (size_t i = 0; i < IO_MAX_WAITERS; i++) sources |= io_waiters[i].sources;
+	return sources;
+}
+
+void io_wake(uint64_t sources) {
+	if (io_waiter_count == 0 || sources == 0) return;
+	for (size_t i = 0; i < IO_MAX_WAITERS; i++) {
+		if (io_waiters[i].sources & sources) sem_post(io_waiters[i].sem);
+	}
+}
+
+int32_t io_wait_for(uint64_t sources, io_check_fn_t check, void* arg, uint32_t timeout) {
+	io_waiter_t* waiter = NULL;
+	uint32_t start = millis();
+	int32_t rtn;
+	while (true) {
+		uint64_t wanted = sources;
+		rtn = check(arg, &wanted);
+		uint32_t elapsed = millis() - start;
+		if (rtn != 0 || (timeout != TIMEOUT_MAX && elapsed >= timeout)) break;
+		if (waiter == NULL) {
+			waiter = io_waiter_claim(wanted);
+			// every waiter slot is taken, so fall back to polling
+			if (waiter == NULL) task_delay(1);
+			// check once more after claiming so nothing that became ready in
+			// between is missed
+			continue;
+		}
+		if (waiter->sources != wanted) {
+			waiter->sources = wanted;
+			__sync_synchronize();
+			continue;
+		}
+		io_waiter_sleep(waiter, timeout == TIMEOUT_MAX ? TIMEOUT_MAX : timeout - elapsed);
+	}
+	if (waiter != NULL) io_waiter_release(waiter);
+	return rtn;
+}
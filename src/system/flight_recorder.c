@@ -0,0 +1,185 @@
+/**
+ * \file system/flight_recorder.c
+ *
+ * Crash flight recorder
+ *
+ * A RAM ring of the most recent task switches, competition state changes, port
+ * errors, and user markers, so that a crash report shows what led up to the
+ * crash and not just where it happened. Recording an event claims a slot with
+ * one atomic increment and fills it in, without locks or critical sections, so
+ * it is cheap enough to run on every context switch. Tasks recording at the
+ * same time get different slots; the cost is that a slot being written when
+ * the ring is read may be torn, which is acceptable for a crash report.
+ *
+ * A task may be deleted, and its TCB freed, long before a crash, so task switch
+ * events keep the task's creation number and the dump never looks at the TCB.
+ * The name of each task is copied into a small table, keyed by that number,
+ * the first time it is switched in.
+ *
+ * The data abort and stack overflow handlers dump the ring once the system has
+ * stopped. By then the scheduler and interrupts are off, so the dump talks to
+ * the microSD card and serial port through the SDK directly instead of the VFS.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "pros/apix.h"
+#include "rtos/FreeRTOS.h"
+#include "rtos/tcb.h"
+#include "system/flight_recorder.h"
+#include "v5_api.h"
+
+_Static_assert((FLIGHT_RECORDER_EVENTS & (FLIGHT_RECORDER_EVENTS - 1)) == 0,
+               "FLIGHT_RECORDER_EVENTS must be a power of two");
+
+#define FLIGHT_TASK_NAMES 16  // recent task names kept for the dump
+#define FLIGHT_TASK_NAME_LEN 16
+
+static flight_event_s_t flight_ring[FLIGHT_RECORDER_EVENTS];
+static uint32_t flight_head = 0;  // number of events ever recorded
+static uint32_t flight_mask = ~0u;
+
+// indexed by creation number, which starts at 1, so 0 marks an empty slot
+static struct {
+	uint32_t number;
+	char name[FLIGHT_TASK_NAME_LEN];
+} flight_task_names[FLIGHT_TASK_NAMES];
+
+void flight_recorder_record(uint16_t type, uint16_t code, uint32_t value) {
+	if (!(flight_mask & (1u << type))) return;
+	uint32_t index = __atomic_fetch_add(&flight_head, 1, __ATOMIC_RELAXED) & (FLIGHT_RECORDER_EVENTS - 1);
+	flight_event_s_t* event = &flight_ring[index];
+	event->time = (uint32_t)vexSystemHighResTimeGet();
+	event->type = type;
+	event->code = code;
+	event->value = value;
+}
+
+// Called by the traceTASK_SWITCHED_IN hook in FreeRTOSConfig.h every time the
+// scheduler picks a task, which is usually the one that was already running
+void flight_recorder_task_switched(void) {
+	static TCB_t* last = NULL;
+	if (pxCurrentTCB == last) return;
+	last = pxCurrentTCB;
+	uint32_t number = last->uxTCBNumber;
+	uint32_t slot = number % FLIGHT_TASK_NAMES;
+	if (flight_task_names[slot].number != number) {
+		flight_task_names[slot].number = 0;
+		strncpy(flight_task_names[slot].name, last->pcTaskName, FLIGHT_TASK_NAME_LEN - 1);
+		flight_task_names[slot].number = number;
+	}
+	flight_recorder_record(E_FLIGHT_EVENT_TASK_SWITCH, (uint16_t)number, (uint32_t)last);
+}
+
+void flight_recorder_mark(uint16_t code, uint32_t value) {
+	flight_recorder_record(E_FLIGHT_EVENT_MARKER, code, value);
+}
+
+void flight_recorder_set_mask(uint32_t mask) {
+	flight_mask = mask;
+}
+
+uint32_t flight_recorder_get(flight_event_s_t* events, uint32_t count) {
+	uint32_t head = __atomic_load_n(&flight_head, __ATOMIC_ACQUIRE);
+	uint32_t available = head < FLIGHT_RECORDER_EVENTS ? head : FLIGHT_RECORDER_EVENTS;
+	if (count > available) count = available;
+	for (uint32_t i = 0; i < count; i++) {
+		events[i] = flight_ring[(head - count + i) & (FLIGHT_RECORDER_EVENTS - 1)];
+	}
+	return count;
+}
+
+/******************************************************************************/
+/**                                  Dumping                                 **/
+/******************************************************************************/
+
+static FIL* dump_file;
+
+static void dump_to_file(const char* line) {
+	vexFileWrite((char*)line, 1, strlen(line), dump_file);
+}
+
+static void dump_to_serial(const char* line) {
+	size_t len = strlen(line);
+	while (len > 0) {
+		// drain anything the kernel already queued for the serial port first, so
+		// the dump comes after the rest of the crash report
+		extern void ser_output_flush(void);
+		ser_output_flush();
+		vexBackgroundProcessing();
+		int32_t free = vexSerialWriteFree(1);
+		if (free <= 0) continue;
+		int32_t written = vexSerialWriteBuffer(1, (uint8_t*)line, (uint32_t)free < len ? (uint32_t)free : len);
+		if (written > 0) {
+			line += written;
+			len -= written;
+		}
+	}
+}
+
+static void dump_event(const flight_event_s_t* event, uint32_t now, void (*out)(const char*)) {
+	char line[80];
+	int32_t age = event->time - now;
+	switch (event->type) {
+		case E_FLIGHT_EVENT_TASK_SWITCH: {
+			// only the copied name is used, since the task may be gone by now
+			uint32_t slot = event->code % FLIGHT_TASK_NAMES;
+			bool named = flight_task_names[slot].number != 0 && (uint16_t)flight_task_names[slot].number == event->code;
+			snprintf(line, sizeof(line), "%11ld us  TASK    #%u %.*s\n", age, event->code, FLIGHT_TASK_NAME_LEN - 1,
+			         named ? flight_task_names[slot].name : "");
+			break;
+		}
+		case E_FLIGHT_EVENT_COMPETITION:
+			snprintf(line, sizeof(line), "%11ld us  COMP    %s%s%s\n", age,
+			         event->value & COMPETITION_DISABLED ? "disabled" : "enabled",
+			         event->value & COMPETITION_AUTONOMOUS ? " autonomous" : "",
+			         event->value & COMPETITION_CONNECTED ? " connected" : "");
+			break;
+		case E_FLIGHT_EVENT_PORT_ERROR:
+			snprintf(line, sizeof(line), "%11ld us  PORT    %u\n", age, event->code);
+			break;
+		case E_FLIGHT_EVENT_MARKER:
+			snprintf(line, sizeof(line), "%11ld us  MARK    %u %lu (0x%08lx)\n", age, event->code, event->value,
+			         event->value);
+			break;
+		default:
+			return;
+	}
+	out(line);
+}
+
+static void dump_events(uint32_t head, uint32_t now, void (*out)(const char*)) {
+	uint32_t count = head < FLIGHT_RECORDER_EVENTS ? head : FLIGHT_RECORDER_EVENTS;
+	char line[80];
+	snprintf(line, sizeof(line), "BEGIN FLIGHT RECORDER (%lu events, times relative to the crash)\n", count);
+	out(line);
+	for (uint32_t i = 0; i < count; i++) {
+		dump_event(&flight_ring[(head - count + i) & (FLIGHT_RECORDER_EVENTS - 1)], now, out);
+	}
+	out("END OF FLIGHT RECORDER\n");
+}
+
+void flight_recorder_dump(void) {
+	// stop recording so the ring holds still
+	flight_mask = 0;
+	uint32_t now = (uint32_t)vexSystemHighResTimeGet();
+	uint32_t head = flight_head;
+
+	// the card goes first, since the serial port can stall if nothing reads it
+	if (vexFileDriveStatus(0)) {
+		dump_file = vexFileOpenWrite("flight_recorder.txt");
+		if (dump_file != NULL) {
+			dump_events(head, now, dump_to_file);
+			vexFileClose(dump_file);
+		}
+	}
+	dump_events(head, now, dump_to_serial);
+}
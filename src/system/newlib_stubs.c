@@ -25,6 +25,7 @@
 
 #include "hot.h"
 #include "pros/misc.h"
+#include "system/dev/ram.h"
 
 #define SEC_TO_MSEC 1000
 #define SEC_TO_MICRO 1000000
@@ -32,6 +33,8 @@
 
 void _exit(int status) {
 	if(status != 0) dprintf(3, "Error %d\n", status); // kprintf
+	// save RAM files marked with RAMCTL_PERSIST before the program goes away
+	ram_save_persisted();
 	vexSystemExitRequest();
 }
 
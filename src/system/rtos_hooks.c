@@ -19,6 +19,7 @@
 #include "rtos/task.h"
 #include "rtos/tcb.h"
 
+#include "system/flight_recorder.h"
 #include "v5_api.h"
 #include "v5_color.h"
 
@@ -34,6 +35,7 @@ void DataAbortInterrupt() {
 	asm("add %0,sp,#8\n" : "=r"(sp));
 	extern void report_data_abort(uint32_t);
 	report_data_abort(sp);
+	flight_recorder_dump();
 	for (;;) {
 		vexBackgroundProcessing();
 		extern void ser_output_flush();
@@ -103,6 +105,7 @@ void vApplicationStackOverflowHook(task_t pxTask, char* pcTaskName) {
 	// configCHECK_FOR_STACK_OVERFLOW is defined to 1 or 2.  This hook function is
 	// called if a stack overflow is detected.
 	taskDISABLE_INTERRUPTS();
+	flight_recorder_dump();
 	for (;;) vexBackgroundProcessing();
 	;
 }
@@ -0,0 +1,298 @@
+/**
+ * \file system/shell.c
+ *
+ * Serial command shell
+ *
+ * The serial daemon collects lines sent as pR$<command> and queues them here.
+ * The shell task splits each line into arguments and runs the command with
+ * that name from the command table. Kernel subsystems and user code add
+ * commands with shell_register and expose variables to get and set with
+ * shell_tunable.
+ *
+ * The shell task runs at the same low priority as the serial daemon, so
+ * commands never delay user tasks. Only SHELL_QUEUE_LENGTH lines can be
+ * waiting at once. More lines are dropped rather than blocking the serial
+ * daemon, which would stop stdin from being read.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "kapi.h"
+#include "system/shell.h"
+
+#define SHELL_NAME_MAX 16
+#define SHELL_QUEUE_LENGTH 4
+
+typedef struct shell_command {
+	char name[SHELL_NAME_MAX];
+	const char* help;
+	shell_command_fn_t function;
+} shell_command_t;
+
+typedef struct shell_tunable {
+	char name[SHELL_NAME_MAX];
+	double* value;
+} shell_tunable_t;
+
+// entries are filled in before the count is raised, and never change after, so
+// the shell task reads the tables without a lock
+static shell_command_t shell_commands[SHELL_MAX_COMMANDS];
+static volatile uint32_t shell_command_count = 0;
+static shell_tunable_t shell_tunables[SHELL_MAX_COMMANDS];
+static volatile uint32_t shell_tunable_count = 0;
+
+static uint8_t shell_queue_storage[SHELL_QUEUE_LENGTH * SHELL_LINE_MAX];
+static static_queue_s_t shell_queue_buf;
+static queue_t shell_queue = NULL;
+
+static task_stack_t shell_task_stack[TASK_STACK_DEPTH_DEFAULT];
+static static_task_s_t shell_task_buffer;
+
+static bool shell_name_valid(const char* name) {
+	return name != NULL && *name != '\0' && strlen(name) < SHELL_NAME_MAX && strpbrk(name, " \t") == NULL;
+}
+
+int32_t shell_register(const char* name, const char* help, shell_command_fn_t function) {
+	if (!shell_name_valid(name) || function == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	int32_t ret = 1;
+	rtos_suspend_all();
+	uint32_t count = shell_command_count;
+	for (uint32_t i = 0; i < count; i++) {
+		if (strcmp(shell_commands[i].name, name) == 0) {
+			errno = EEXIST;
+			ret = PROS_ERR;
+		}
+	}
+	if (ret == 1 && count == SHELL_MAX_COMMANDS) {
+		errno = ENOSPC;
+		ret = PROS_ERR;
+	}
+	if (ret == 1) {
+		strcpy(shell_commands[count].name, name);
+		shell_commands[count].help = help;
+		shell_commands[count].function = function;
+		shell_command_count = count + 1;
+	}
+	rtos_resume_all();
+	return ret;
+}
+
+int32_t shell_tunable(const char* name, double* value) {
+	if (!shell_name_valid(name) || value == NULL) {
+		errno = EINVAL;
+		return PROS_ERR;
+	}
+	int32_t ret = 1;
+	rtos_suspend_all();
+	uint32_t count = shell_tunable_count;
+	for (uint32_t i = 0; i < count; i++) {
+		if (strcmp(shell_tunables[i].name, name) == 0) {
+			errno = EEXIST;
+			ret = PROS_ERR;
+		}
+	}
+	if (ret == 1 && count == SHELL_MAX_COMMANDS) {
+		errno = ENOSPC;
+		ret = PROS_ERR;
+	}
+	if (ret == 1) {
+		strcpy(shell_tunables[count].name, name);
+		shell_tunables[count].value = value;
+		shell_tunable_count = count + 1;
+	}
+	rtos_resume_all();
+	return ret;
+}
+
+bool shell_post_line(const char* line) {
+	char item[SHELL_LINE_MAX];
+	size_t len = strnlen(line, SHELL_LINE_MAX - 1);
+	memcpy(item, line, len);
+	item[len] = '\0';
+	return queue_append(shell_queue, item, 0);
+}
+
+// Splits line into arguments in place. Returns the number of arguments, or -1
+// if there are too many or a quote isn't closed
+static int shell_tokenize(char* line, char** argv) {
+	int argc = 0;
+	char* in = line;
+	while (true) {
+		while (*in == ' ' || *in == '\t') in++;
+		if (*in == '\0') return argc;
+		if (argc == SHELL_MAX_ARGS) return -1;
+		// arguments only get shorter when quotes and escapes are removed, so they
+		// are rewritten over the line itself
+		char* out = in;
+		argv[argc++] = out;
+		bool quoted = false;
+		while (*in != '\0' && (quoted || (*in != ' ' && *in != '\t'))) {
+			if (*in == '"') {
+				quoted = !quoted;
+				in++;
+			} else if (*in == '\\' && in[1] != '\0') {
+				*out++ = in[1];
+				in += 2;
+			} else {
+				*out++ = *in++;
+			}
+		}
+		if (quoted) return -1;
+		if (*in != '\0') in++;
+		*out = '\0';
+	}
+}
+
+static shell_tunable_t* shell_find_tunable(const char* name) {
+	uint32_t count = shell_tunable_count;
+	for (uint32_t i = 0; i < count; i++) {
+		if (strcmp(shell_tunables[i].name, name) == 0) return &shell_tunables[i];
+	}
+	return NULL;
+}
+
+static int shell_help_command(int argc, char** argv) {
+	uint32_t count = shell_command_count;
+	for (uint32_t i = 0; i < count; i++) {
+		printf("%-15s %s\n", shell_commands[i].name, shell_commands[i].help ? shell_commands[i].help : "");
+	}
+	return 0;
+}
+
+static int shell_get_command(int argc, char** argv) {
+	if (argc > 1) {
+		shell_tunable_t* tunable = shell_find_tunable(argv[1]);
+		if (tunable == NULL) {
+			printf("no tunable named %s\n", argv[1]);
+			return 1;
+		}
+		printf("%s = %g\n", tunable->name, *tunable->value);
+		return 0;
+	}
+	uint32_t count = shell_tunable_count;
+	for (uint32_t i = 0; i < count; i++) {
+		printf("%s = %g\n", shell_tunables[i].name, *shell_tunables[i].value);
+	}
+	return 0;
+}
+
+static int shell_set_command(int argc, char** argv) {
+	if (argc != 3) {
+		printf("usage: set <name> <value>\n");
+		return 1;
+	}
+	shell_tunable_t* tunable = shell_find_tunable(argv[1]);
+	if (tunable == NULL) {
+		printf("no tunable named %s\n", argv[1]);
+		return 1;
+	}
+	char* end;
+	double value = strtod(argv[2], &end);
+	if (end == argv[2] || *end != '\0') {
+		printf("%s is not a number\n", argv[2]);
+		return 1;
+	}
+	// a double takes two stores, so don't let a task see only one of them
+	rtos_suspend_all();
+	*tunable->value = value;
+	rtos_resume_all();
+	printf("%s = %g\n", tunable->name, value);
+	return 0;
+}
+
+static const char* shell_device_name(v5_device_e_t type) {
+	switch (type) {
+		case E_DEVICE_NONE:
+			return "-";
+		case E_DEVICE_MOTOR:
+			return "motor";
+		case E_DEVICE_ROTATION:
+			return "rotation";
+		case E_DEVICE_IMU:
+			return "imu";
+		case E_DEVICE_DISTANCE:
+			return "distance";
+		case E_DEVICE_RADIO:
+			return "radio";
+		case E_DEVICE_VISION:
+			return "vision";
+		case E_DEVICE_ADI:
+			return "adi";
+		case E_DEVICE_OPTICAL:
+			return "optical";
+		case E_DEVICE_GPS:
+			return "gps";
+		case E_DEVICE_SERIAL:
+			return "serial";
+		default:
+			return "unknown";
+	}
+}
+
+static int shell_ports_command(int argc, char** argv) {
+	printf("port  plugged   registered\n");
+	for (uint8_t port = 1; port <= NUM_V5_PORTS - 1; port++) {
+		v5_device_e_t plugged = registry_get_plugged_type(port - 1);
+		v5_device_e_t bound = registry_get_bound_type(port - 1);
+		printf("%4u  %-9s %s\n", port, shell_device_name(plugged), shell_device_name(bound));
+	}
+	return 0;
+}
+
+static void shell_run(char* line) {
+	char* argv[SHELL_MAX_ARGS + 1];
+	int argc = shell_tokenize(line, argv);
+	if (argc < 0) {
+		printf("shell: too many arguments or unclosed quote\n");
+		return;
+	}
+	if (argc == 0) return;
+	argv[argc] = NULL;
+	uint32_t count = shell_command_count;
+	for (uint32_t i = 0; i < count; i++) {
+		if (strcmp(shell_commands[i].name, argv[0]) == 0) {
+			int ret = shell_commands[i].function(argc, argv);
+			if (ret != 0) printf("%s: failed (%d)\n", argv[0], ret);
+			return;
+		}
+	}
+	printf("shell: no command named %s, try help\n", argv[0]);
+}
+
+static void shell_task(void* ign) {
+	char line[SHELL_LINE_MAX];
+	while (true) {
+		if (queue_recv(shell_queue, line, TIMEOUT_MAX)) {
+			shell_run(line);
+			fflush(stdout);
+		}
+	}
+}
+
+void shell_initialize(void) {
+	shell_queue = queue_create_static(SHELL_QUEUE_LENGTH, SHELL_LINE_MAX, shell_queue_storage, &shell_queue_buf);
+
+	shell_register("help", "lists the commands", shell_help_command);
+	shell_register("tasks", "lists the tasks with their state, priority, free stack words, and CPU use",
+	               shell_tasks_command);
+	shell_register("heap", "shows free kernel heap and newlib heap use", shell_heap_command);
+	shell_register("ports", "lists the device plugged into and registered on each port", shell_ports_command);
+	shell_register("get", "get [name] shows one or every tunable", shell_get_command);
+	shell_register("set", "set <name> <value> changes a tunable", shell_set_command);
+
+	task_create_static(shell_task, NULL, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "Serial Shell (PROS)",
+	                   shell_task_stack, &shell_task_buffer);
+}
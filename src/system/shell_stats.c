@@ -0,0 +1,62 @@
+/**
+ * \file system/shell_stats.c
+ *
+ * Serial shell commands that report RTOS statistics
+ *
+ * These are kept apart from system/shell.c because they need the FreeRTOS
+ * task internals, which can't be included alongside the PROS API headers.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <malloc.h>
+#include <stdio.h>
+
+#include "rtos/FreeRTOS.h"
+#include "rtos/task.h"
+#include "system/shell.h"
+
+extern size_t xPortGetFreeHeapSize(void);
+extern size_t xPortGetMinimumEverFreeHeapSize(void);
+
+// the stats are snapshotted into a fixed array so printing doesn't allocate
+#define SHELL_MAX_TASKS 48
+
+static const char* const task_state_names[] = {"run", "ready", "block", "susp", "del", "inv"};
+
+int shell_tasks_command(int argc, char** argv) {
+	static TaskStatus_t tasks[SHELL_MAX_TASKS];
+	uint32_t total_time;
+	uint32_t count = uxTaskGetSystemState(tasks, SHELL_MAX_TASKS, &total_time);
+	if (count == 0) {
+		printf("more than %d tasks\n", SHELL_MAX_TASKS);
+		return 1;
+	}
+	// run time counters are in watchdog ticks, so report per mille of the total
+	total_time /= 1000;
+	printf("%-32s %-5s prio  stack  cpu%%\n", "name");
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t state = tasks[i].eCurrentState;
+		uint32_t cpu = total_time ? tasks[i].ulRunTimeCounter / total_time : 0;
+		printf("%-32s %-5s %4lu %6u %3lu.%lu\n", tasks[i].pcTaskName,
+		       state < sizeof(task_state_names) / sizeof(*task_state_names) ? task_state_names[state] : "?",
+		       tasks[i].uxCurrentPriority, tasks[i].usStackHighWaterMark, cpu / 10, cpu % 10);
+	}
+	return 0;
+}
+
+int shell_heap_command(int argc, char** argv) {
+	// kernel objects like tasks and queues come from the FreeRTOS heap, while
+	// malloc and new come from the newlib heap, which grows as it is used
+	printf("kernel heap: free %u bytes, least free %u bytes\n", xPortGetFreeHeapSize(),
+	       xPortGetMinimumEverFreeHeapSize());
+	struct mallinfo info = mallinfo();
+	printf("newlib heap: %u bytes in use, %u bytes free of %u bytes claimed\n", info.uordblks, info.fordblks,
+	       info.arena);
+	return 0;
+}
@@ -12,6 +12,7 @@
  */
 
 #include "kapi.h"
+#include "system/flight_recorder.h"
 #include "system/optimizers.h"
 #include "system/user_functions.h"
 #include "v5_api.h"
@@ -44,6 +45,8 @@ char task_names[4][32] = {"User Operator Control (PROS)", "User Autonomous (PROS
 task_fn_t task_fns[4] = {_opcontrol_task, _autonomous_task, _disabled_task, _competition_initialize_task};
 
 extern void ser_output_flush(void);
+extern void ser_output_wake(void);
+extern void usd_log_request_flush(void);
 
 // does the basic background operations that need to occur every 2ms
 static inline void do_background_operations() {
@@ -54,6 +57,7 @@ static inline void do_background_operations() {
 	rtos_resume_all();
 	vdml_background_processing();
 	port_mutex_give_all();
+	ser_output_wake();
 }
 
 static void _system_daemon_task(void* ign) {
@@ -88,6 +92,9 @@ static void _system_daemon_task(void* ign) {
 			// Have a new competition status, need to clean up whatever's running
 			uint32_t old_status = status;
 			status = competition_get_status();
+			// get write-behind logs onto the card before the robot changes modes
+			usd_log_request_flush();
+			flight_recorder_record(E_FLIGHT_EVENT_COMPETITION, 0, status);
 			enum state_task state = E_OPCONTROL_TASK;
 			if ((status & COMPETITION_DISABLED) && (old_status & COMPETITION_DISABLED)) {
 				// Don't restart the disabled task even if other bits have changed (e.g. auton bit)
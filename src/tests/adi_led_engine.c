@@ -0,0 +1,73 @@
+/**
+ * \file tests/adi_led_engine.c
+ *
+ * Frame time benchmark for the addressable LED engine
+ *
+ * Runs each built-in effect on a strip for a few seconds, then a program that
+ * changes a single pixel per frame, and reports the engine's frame times and
+ * how many LED colors it sent. Changing one pixel should send far fewer LEDs
+ * per frame than the effects that redraw the whole strip.
+ *
+ * Adjust the port and strip length below to match the robot.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "main.h"
+
+#define LED_PORT 'A'
+#define LED_LENGTH 64
+#define RUN_TIME 3000  // ms
+
+static void report(const char* name, ext_adi_led_engine_stats_s_t* before) {
+	ext_adi_led_engine_stats_s_t after;
+	ext_adi_led_engine_get_stats(&after);
+	uint32_t frames = after.frames - before->frames;
+	printf("%-12s %4lu frames, last %4lu us, max %4lu us, %5.1f LEDs/frame\n", name, frames, after.last_frame_us,
+	       after.max_frame_us, frames ? (double)(after.leds_sent - before->leds_sent) / frames : 0.0);
+	*before = after;
+}
+
+void opcontrol() {
+	ext_adi_led_t led = ext_adi_led_init(INTERNAL_ADI_PORT, LED_PORT);
+	if (ext_adi_led_engine_start(led, LED_LENGTH) != PROS_SUCCESS) {
+		printf("failed to start engine: %d\n", errno);
+		return;
+	}
+	ext_adi_led_engine_set_frame_period(10);
+	ext_adi_led_engine_stats_s_t stats;
+	ext_adi_led_engine_get_stats(&stats);
+
+	ext_adi_led_effect_s_t effects[] = {
+	    {.type = E_ADI_LED_EFFECT_FILL, .color = 0x200000},
+	    {.type = E_ADI_LED_EFFECT_GRADIENT, .color = 0x200000, .color2 = 0x000020, .period = 20},
+	    {.type = E_ADI_LED_EFFECT_CHASE, .color = 0x002000, .color2 = 0x000000, .period = 30, .width = 4},
+	};
+	const char* names[] = {"fill", "gradient", "chase"};
+	for (int i = 0; i < 3; i++) {
+		ext_adi_led_engine_set_effect(led, &effects[i]);
+		delay(RUN_TIME);
+		report(names[i], &stats);
+	}
+
+	uint32_t off = 0, on = 0x202020;
+	for (uint32_t i = 0; i < LED_LENGTH; i++) {
+		ext_adi_led_engine_write(led, &off, i, 1);
+	}
+	ext_adi_led_engine_commit(led);
+	delay(20);
+	report("clear", &stats);
+	uint32_t start = millis();
+	for (uint32_t i = 0; millis() - start < RUN_TIME; i++) {
+		ext_adi_led_engine_write(led, &off, (i + LED_LENGTH - 1) % LED_LENGTH, 1);
+		ext_adi_led_engine_write(led, &on, i % LED_LENGTH, 1);
+		ext_adi_led_engine_commit(led);
+		delay(10);
+	}
+	report("one pixel", &stats);
+	ext_adi_led_engine_stop(led);
+}
@@ -0,0 +1,97 @@
+/**
+ * \file tests/aio.c
+ *
+ * Test for asynchronous file I/O
+ *
+ * Writes a 200 KB file to the microSD card, then reads it back both
+ * synchronously and with the I/O worker while a 10 ms control loop runs, and
+ * reports the longest loop period for each. The asynchronous read should leave
+ * the loop period untouched. Then checks that a read from stdin with nothing
+ * typed does not hold up a request on another file, and can be canceled.
+ *
+ * Requires a microSD card.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "main.h"
+#include "pros/apix.h"
+
+#define FILE_SIZE (200 * 1024)
+
+static uint8_t data[FILE_SIZE];
+
+static bool check(void) {
+	for (uint32_t i = 0; i < FILE_SIZE; i++) {
+		if (data[i] != (uint8_t)(i * 13)) return false;
+	}
+	return true;
+}
+
+void opcontrol() {
+	for (uint32_t i = 0; i < FILE_SIZE; i++) data[i] = i * 13;
+	int file = open("/usd/aio_test.bin", O_WRONLY);
+	write(file, data, FILE_SIZE);
+	close(file);
+
+	// synchronous read, timed as one long loop iteration
+	memset(data, 0, FILE_SIZE);
+	uint32_t start = millis();
+	file = open("/usd/aio_test.bin", O_RDONLY);
+	read(file, data, FILE_SIZE);
+	close(file);
+	printf("sync:  loop blocked for %lu ms, data %s\n", millis() - start, check() ? "OK" : "BAD");
+
+	// asynchronous read, notifying this task when done
+	memset(data, 0, FILE_SIZE);
+	aio_request_s_t open_request = {.task = task_get_current(), .notify_bits = 1};
+	aio_request_s_t read_request = {.task = task_get_current(), .notify_bits = 2};
+	aio_request_s_t close_request = {0};
+	aio_submit_open(&open_request, "/usd/aio_test.bin", O_RDONLY);
+	uint32_t worst = 0;
+	uint32_t time = millis();
+	uint32_t last = time;
+	start = time;
+	while (!aio_done(&read_request)) {
+		// stand-in for control work
+		uint32_t now = millis();
+		if (now - last > worst) worst = now - last;
+		last = now;
+		if (task_notify_take(true, 0) & 1) {
+			int32_t fd = aio_wait(&open_request, 0);
+			if (fd == PROS_ERR) {
+				printf("open failed: %d\n", errno);
+				return;
+			}
+			aio_submit_read(&read_request, fd, data, FILE_SIZE, 0);
+		}
+		task_delay_until(&time, 10);
+	}
+	int32_t count = aio_wait(&read_request, 0);
+	aio_submit_close(&close_request, open_request.result);
+	printf("async: read %ld bytes in %lu ms, longest loop period %lu ms, data %s\n", count, millis() - start, worst,
+	       check() ? "OK" : "BAD");
+	aio_wait(&close_request, TIMEOUT_MAX);
+
+	// a read from stdin waits in the queue for input without blocking the worker
+	static uint8_t line[16];
+	aio_request_s_t stdin_request = {0};
+	aio_submit_read(&stdin_request, STDIN_FILENO, line, sizeof(line), -1);
+	aio_submit_open(&open_request, "/usd/aio_test.bin", O_RDONLY);
+	int32_t fd = aio_wait(&open_request, 1000);
+	printf("open behind a stdin read: %s\n", fd != PROS_ERR ? "OK" : "BLOCKED");
+	bool canceled = aio_cancel(&stdin_request) == 1 && aio_wait(&stdin_request, 0) == PROS_ERR && errno == ECANCELED;
+	printf("cancel stdin read: %s\n", canceled ? "OK" : "FAILED");
+	if (fd != PROS_ERR) {
+		aio_submit_close(&close_request, fd);
+		aio_wait(&close_request, TIMEOUT_MAX);
+	}
+}
@@ -0,0 +1,68 @@
+/**
+ * \file tests/assets.c
+ *
+ * Load time test for asset packs
+ *
+ * Times loading a 2000 point path from a CSV file with fscanf and from an asset
+ * pack, and checks that both give the same points.
+ *
+ * Requires a microSD card with path.csv, holding rows of x,y,heading, and
+ * assets.pak, made from it with:
+ *   python3 tools/pack_assets.py -o assets.pak --csv f64 path.csv
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "main.h"
+
+#define MAX_POINTS 2000
+
+static double parsed[MAX_POINTS][3];
+static uint64_t arena[8 * 1024];
+
+void opcontrol() {
+	uint64_t start = micros();
+	FILE* csv = fopen("/usd/path.csv", "r");
+	if (csv == NULL) {
+		printf("could not open path.csv: %d\n", errno);
+		return;
+	}
+	fscanf(csv, "%*[^\n]\n");  // header
+	uint32_t points = 0;
+	while (points < MAX_POINTS &&
+	       fscanf(csv, "%lf,%lf,%lf\n", &parsed[points][0], &parsed[points][1], &parsed[points][2]) == 3) {
+		points++;
+	}
+	fclose(csv);
+	printf("csv:  %lu points in %lu us\n", points, (uint32_t)(micros() - start));
+
+	start = micros();
+	asset_pack_s_t pack;
+	if (asset_pack_open(&pack, "/usd/assets.pak", arena, sizeof(arena)) != 1) {
+		printf("could not open assets.pak: %d\n", errno);
+		return;
+	}
+	size_t size;
+	const double(*path)[3] = asset_get(&pack, "path.csv", &size);
+	uint32_t loaded = micros() - start;
+	if (path == NULL) {
+		printf("could not load path.csv: %d\n", errno);
+		return;
+	}
+	printf("pack: %u points in %lu us\n", size / sizeof(*path), loaded);
+
+	start = micros();
+	for (int i = 0; i < 1000; i++) asset_get(&pack, "path.csv", NULL);
+	printf("lookup of a loaded asset: %lu ns\n", (uint32_t)(micros() - start));
+	asset_pack_close(&pack);
+
+	bool ok = size / sizeof(*path) == points;
+	for (uint32_t i = 0; ok && i < points; i++) {
+		ok = path[i][0] == parsed[i][0] && path[i][1] == parsed[i][1] && path[i][2] == parsed[i][2];
+	}
+	printf("points %s\n", ok ? "match" : "DIFFER");
+}
@@ -0,0 +1,68 @@
+/**
+ * \file tests/dev_select.c
+ *
+ * Latency test for blocking Generic Serial Device reads
+ *
+ * A task sends a timestamp over ports 1 and 3 in turn every 37 ms. The main task
+ * waits on both receiving ports with DEVCTL_SELECT, reads whichever is ready
+ * with a blocking read, and reports the worst and average time from sending a
+ * message to receiving it.
+ *
+ * NOTE: There should be a cable plugged into ports 1 and 2, and another into
+ * ports 3 and 4, connecting them together
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include <fcntl.h>
+
+#include "main.h"
+#include "pros/apix.h"
+
+#define MESSAGES 200
+
+static void sender(void* ign) {
+	int ports[2] = {open("/dev/1", O_WRONLY), open("/dev/3", O_WRONLY)};
+	uint32_t time = millis();
+	for (int i = 0; i < MESSAGES; i++) {
+		uint64_t now = micros();
+		write(ports[i % 2], &now, sizeof(now));
+		task_delay_until(&time, 37);
+	}
+}
+
+void opcontrol() {
+	int ports[2] = {open("/dev/2", O_RDONLY), open("/dev/4", O_RDONLY)};
+	serial_set_baudrate(1, 921600);
+	serial_set_baudrate(2, 921600);
+	serial_set_baudrate(3, 921600);
+	serial_set_baudrate(4, 921600);
+	task_create(sender, NULL, TASK_PRIORITY_DEFAULT + 1, TASK_STACK_DEPTH_DEFAULT, "Sender");
+
+	uint32_t worst = 0;
+	uint64_t total = 0;
+	int received = 0;
+	while (received < MESSAGES) {
+		dev_select_s_t select = {.read_ports = (1 << 1) | (1 << 3), .write_ports = 0, .timeout = 1000};
+		if (fdctl(ports[0], DEVCTL_SELECT, &select) <= 0) {
+			printf("select timed out after %d messages\n", received);
+			return;
+		}
+		for (int i = 0; i < 2; i++) {
+			if (!(select.read_ports & (1 << (2 * i + 1)))) continue;
+			// blocks until the whole timestamp has arrived
+			uint64_t sent;
+			uint32_t got = 0;
+			while (got < sizeof(sent)) got += read(ports[i], (uint8_t*)&sent + got, sizeof(sent) - got);
+			uint32_t latency = micros() - sent;
+			if (latency > worst) worst = latency;
+			total += latency;
+			received++;
+		}
+	}
+	printf("%d messages, worst latency %lu us, average %lu us\n", received, worst, (uint32_t)(total / received));
+}
@@ -0,0 +1,45 @@
+/**
+ * \file tests/flight_recorder.c
+ *
+ * Test for the crash flight recorder
+ *
+ * Times flight_recorder_mark(), prints the most recent events, and then has a
+ * task cause a data abort so the dump to flight_recorder.txt and the serial
+ * port can be checked. The markers from the crashing task and the switch to it
+ * should be the last events in the dump.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "main.h"
+#include "pros/apix.h"
+
+#define MARKS 10000
+
+static void crash(void* ign) {
+	for (uint32_t i = 0; i < 3; i++) {
+		flight_recorder_mark(2, i);
+		task_delay(10);
+	}
+	printf("%d\n", *(volatile int*)0x4);
+}
+
+void opcontrol() {
+	uint64_t start = micros();
+	for (uint32_t i = 0; i < MARKS; i++) flight_recorder_mark(1, i);
+	printf("flight_recorder_mark: %lu ns per event\n", (uint32_t)((micros() - start) * 1000 / MARKS));
+
+	task_delay(100);
+	flight_event_s_t events[20];
+	uint32_t count = flight_recorder_get(events, 20);
+	for (uint32_t i = 0; i < count; i++) {
+		printf("%10lu type %u code %u value 0x%08lx\n", events[i].time, events[i].type, events[i].code, events[i].value);
+	}
+
+	task_delay(1000);
+	task_create(crash, NULL, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Crash");
+}
@@ -0,0 +1,163 @@
+/**
+ * \file tests/link_transport.c
+ *
+ * Stress test for the reliable link transport over a lossy radio stand-in
+ *
+ * Connects two link transports through an in-memory radio that drops, corrupts
+ * and injects bytes, then sends messages of every size in both directions and
+ * checks that each one arrives intact and in order. Then one end is set up
+ * again, as if its program restarted, and both directions must carry another
+ * round of messages. No radio is needed.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include <stdlib.h>
+#include "main.h"
+
+#define MESSAGES 200
+#define PIPE_SIZE LINK_BUFFER_SIZE
+// out of 1000 transmit calls
+#define DROP_RATE 20
+#define CORRUPT_RATE 20
+#define GARBAGE_RATE 10
+
+// One direction of the radio stand-in
+typedef struct {
+	uint8_t data[PIPE_SIZE];
+	uint32_t head, tail, used;
+} pipe_t;
+
+typedef struct {
+	pipe_t* out;
+	pipe_t* in;
+} lossy_radio_t;
+
+static void pipe_put(pipe_t* pipe, uint8_t byte) {
+	if (pipe->used == PIPE_SIZE) return;
+	pipe->data[pipe->head] = byte;
+	pipe->head = (pipe->head + 1) % PIPE_SIZE;
+	pipe->used++;
+}
+
+static uint32_t lossy_transmit(void* context, const uint8_t* data, uint32_t size) {
+	lossy_radio_t* radio = context;
+	int roll = rand() % 1000;
+	if (roll < DROP_RATE) return size;
+	if (roll < DROP_RATE + GARBAGE_RATE) {
+		for (int i = rand() % 8; i >= 0; i--) pipe_put(radio->out, rand());
+	}
+	uint32_t corrupt = roll >= 1000 - CORRUPT_RATE ? rand() % size : size;
+	for (uint32_t i = 0; i < size; i++) {
+		pipe_put(radio->out, i == corrupt ? data[i] ^ (1 << (rand() % 8)) : data[i]);
+	}
+	return size;
+}
+
+static uint32_t lossy_receive(void* context, uint8_t* data, uint32_t size) {
+	pipe_t* pipe = ((lossy_radio_t*)context)->in;
+	uint32_t count = 0;
+	while (count < size && pipe->used > 0) {
+		data[count++] = pipe->data[pipe->tail];
+		pipe->tail = (pipe->tail + 1) % PIPE_SIZE;
+		pipe->used--;
+	}
+	return count;
+}
+
+static uint32_t lossy_transmittable(void* context) {
+	return PIPE_SIZE - ((lossy_radio_t*)context)->out->used;
+}
+
+static pipe_t a_to_b, b_to_a;
+static lossy_radio_t radio_a = {&a_to_b, &b_to_a};
+static lossy_radio_t radio_b = {&b_to_a, &a_to_b};
+static link_transport_s_t transport_a, transport_b;
+
+// Message n is n % LINK_TRANSPORT_MAX_MESSAGE + 1 bytes of a pattern seeded by n
+static uint32_t make_message(uint32_t n, uint8_t* buf) {
+	uint32_t length = (n * 37) % LINK_TRANSPORT_MAX_MESSAGE + 1;
+	for (uint32_t i = 0; i < length; i++) buf[i] = (uint8_t)(n * 31 + i * 7);
+	return length;
+}
+
+// sent and received are the numbers of the next message to send and to expect
+typedef struct {
+	link_transport_s_t* transport;
+	uint32_t sent, received, errors;
+	uint32_t send_until, receive_until;
+} endpoint_t;
+
+static void step(endpoint_t* self) {
+	static uint8_t buf[LINK_TRANSPORT_MAX_MESSAGE], expected[LINK_TRANSPORT_MAX_MESSAGE];
+	if (self->sent < self->send_until) {
+		uint32_t length = make_message(self->sent, buf);
+		if (link_transport_send(self->transport, buf, length) == 1) self->sent++;
+	}
+	int32_t length;
+	while ((length = link_transport_receive(self->transport, buf, sizeof(buf))) > 0) {
+		uint32_t expected_length = make_message(self->received, expected);
+		if ((uint32_t)length != expected_length || memcmp(buf, expected, length)) {
+			printf("message %lu is wrong\n", self->received);
+			self->errors++;
+		}
+		self->received++;
+	}
+}
+
+static void report(const char* name, link_transport_s_t* transport) {
+	link_transport_stats_s_t stats;
+	link_transport_get_stats(transport, &stats);
+	printf("%s: sent %lu frames (%lu retransmitted), received %lu, %lu CRC errors, %lu bytes skipped, %lu restarts\n",
+	       name, stats.frames_sent, stats.retransmissions, stats.frames_received, stats.crc_errors, stats.resyncs,
+	       stats.peer_restarts);
+}
+
+static void exchange(const char* name, endpoint_t* end_a, endpoint_t* end_b) {
+	uint32_t start = millis();
+	while ((end_a->received < end_a->receive_until || end_b->received < end_b->receive_until) &&
+	       millis() - start < 60000) {
+		step(end_a);
+		step(end_b);
+		delay(1);
+	}
+	printf("%s: a received %lu/%lu messages, b received %lu/%lu, %lu errors, %lu ms\n", name, end_a->received,
+	       end_a->receive_until, end_b->received, end_b->receive_until, end_a->errors + end_b->errors,
+	       millis() - start);
+}
+
+void opcontrol() {
+	link_radio_s_t a = {lossy_transmit, lossy_receive, lossy_transmittable, &radio_a};
+	link_radio_s_t b = {lossy_transmit, lossy_receive, lossy_transmittable, &radio_b};
+	link_transport_init_radio(&transport_a, &a);
+	link_transport_init_radio(&transport_b, &b);
+	link_transport_set_timeout(&transport_a, 20);
+	link_transport_set_timeout(&transport_b, 20);
+
+	endpoint_t end_a = {&transport_a, .send_until = MESSAGES, .receive_until = MESSAGES};
+	endpoint_t end_b = {&transport_b, .send_until = MESSAGES, .receive_until = MESSAGES};
+	exchange("first session", &end_a, &end_b);
+
+	// let the last acknowledgements through so nothing is left to send again
+	uint32_t start = millis();
+	while ((link_transport_poll(&transport_a) > 0 || link_transport_poll(&transport_b) > 0) &&
+	       millis() - start < 5000) {
+		delay(1);
+	}
+
+	// a restarts: its messages are numbered from zero again while b carries on
+	// from where it was, which used to leave b ignoring every frame from a
+	link_transport_init_radio(&transport_a, &a);
+	link_transport_set_timeout(&transport_a, 20);
+	end_a = (endpoint_t){&transport_a, .sent = 0, .received = MESSAGES, .send_until = MESSAGES,
+	                     .receive_until = 2 * MESSAGES};
+	end_b.received = 0;
+	end_b.send_until = 2 * MESSAGES;
+	exchange("after a restarted", &end_a, &end_b);
+	report("a", &transport_a);
+	report("b", &transport_b);
+}
@@ -0,0 +1,145 @@
+/**
+ * \file tests/lvgl_render.c
+ *
+ * Render benchmark and golden image check for LVGL screens
+ *
+ * Renders a few widget scenes into memory with display_capture_set(), timing
+ * full-screen redraws under different themes. Each scene is compared against
+ * a golden image on the microSD card. If no golden image exists yet, the
+ * current render is saved as the golden image.
+ *
+ * tools/display_host builds this test for the host, with its golden images
+ * kept in the repository.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include <inttypes.h>
+
+#include "main.h"
+#include "pros/apix.h"
+
+#ifndef GOLDEN_DIR
+#define GOLDEN_DIR "/usd"
+#endif
+
+#define WIDTH 480
+#define HEIGHT 240
+#define RENDERS 20
+
+static uint32_t framebuffer[WIDTH * HEIGHT];
+static lv_obj_t* scene = NULL;
+
+// Replaces the current scene. The display daemon runs LVGL, so it is locked out
+// while the objects change.
+static void build_scene(lv_theme_t* theme) {
+	display_lock();
+	lv_theme_set_current(theme);
+	lv_obj_t* scr = lv_obj_create(NULL, NULL);
+	lv_scr_load(scr);
+	if (scene != NULL) lv_obj_del(scene);
+	scene = scr;
+
+	lv_obj_t* btn = lv_btn_create(scr, NULL);
+	lv_obj_set_pos(btn, 20, 20);
+	lv_obj_set_size(btn, 140, 60);
+	lv_obj_t* label = lv_label_create(btn, NULL);
+	lv_label_set_text(label, "Button");
+
+	lv_obj_t* bar = lv_bar_create(scr, NULL);
+	lv_obj_set_pos(bar, 20, 100);
+	lv_obj_set_size(bar, 200, 20);
+	lv_bar_set_value(bar, 60);
+
+	lv_obj_t* list = lv_list_create(scr, NULL);
+	lv_obj_set_pos(list, 240, 20);
+	lv_obj_set_size(list, 220, 200);
+	lv_list_add(list, NULL, "First", NULL);
+	lv_list_add(list, NULL, "Second", NULL);
+	lv_list_add(list, NULL, "Third", NULL);
+	display_unlock();
+}
+
+// Compares the framebuffer against the golden image, creating it if missing
+static void check_golden(const char* name) {
+	char path[64];
+	snprintf(path, sizeof(path), GOLDEN_DIR "/golden_%s.bin", name);
+	FILE* golden = fopen(path, "rb");
+	if (!golden) {
+		golden = fopen(path, "wb");
+		if (!golden) {
+			printf("%s: no microSD card, skipping golden image\n", name);
+			return;
+		}
+		fwrite(framebuffer, sizeof(uint32_t), WIDTH * HEIGHT, golden);
+		fclose(golden);
+		printf("%s: saved new golden image\n", name);
+		return;
+	}
+	uint32_t row[WIDTH];
+	uint32_t diff = 0;
+	int16_t x0 = WIDTH, y0 = HEIGHT, x1 = -1, y1 = -1;
+	for (int16_t y = 0; y < HEIGHT; y++) {
+		if (fread(row, sizeof(uint32_t), WIDTH, golden) != WIDTH) {
+			printf("%s: golden image is truncated\n", name);
+			break;
+		}
+		for (int16_t x = 0; x < WIDTH; x++) {
+			if (row[x] != framebuffer[y * WIDTH + x]) {
+				diff++;
+				if (x < x0) x0 = x;
+				if (x > x1) x1 = x;
+				if (y < y0) y0 = y;
+				if (y > y1) y1 = y;
+			}
+		}
+	}
+	fclose(golden);
+	if (diff) {
+		printf("%s: FAIL, %" PRIu32 " pixels differ in (%d,%d)-(%d,%d)\n", name, diff, x0, y0, x1, y1);
+	} else {
+		printf("%s: matches golden image\n", name);
+	}
+}
+
+static void run_scene(const char* name, lv_theme_t* theme) {
+	build_scene(theme);
+	uint32_t total = 0, worst = 0;
+	for (int i = 0; i < RENDERS; i++) {
+		uint32_t elapsed = display_render_now();
+		total += elapsed;
+		if (elapsed > worst) worst = elapsed;
+	}
+	printf("%s: full redraw avg %" PRIu32 " us, worst %" PRIu32 " us\n", name, total / RENDERS, worst);
+	check_golden(name);
+}
+
+void opcontrol() {
+	display_lock();
+	lv_obj_t* original = lv_scr_act();
+	display_unlock();
+	display_capture_set(framebuffer);
+
+	run_scene("night", lv_theme_night_init(0, NULL));
+	run_scene("alien", lv_theme_alien_init(40, NULL));
+	run_scene("material", lv_theme_material_init(0, NULL));
+
+	// pressing the button should change how it is drawn
+	build_scene(lv_theme_alien_init(40, NULL));
+	display_touch_inject(90, 50, true);
+	delay(100);
+	display_render_now();
+	check_golden("alien_pressed");
+	display_touch_inject_stop();
+
+	display_capture_set(NULL);
+	display_lock();
+	lv_scr_load(original);
+	lv_obj_del(scene);
+	scene = NULL;
+	display_unlock();
+}
@@ -0,0 +1,136 @@
+/**
+ * \file tests/optical_classifier.c
+ *
+ * Latency test for the optical classifier
+ *
+ * First runs synthetic sensor traces of rings passing the sensor through
+ * optical_classify(), sampling them the way the system daemon would, and
+ * reports the worst delay between a ring arriving and it being classified.
+ * Then starts the classifier on a real sensor and prints each event, checking
+ * that events arrive in order and that each one continues from the band the
+ * last one ended in. Pass red and blue objects in front of the sensor during
+ * the second part.
+ *
+ * Adjust the port below to match the robot.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "main.h"
+
+#define OPTICAL_PORT 1
+#define INTEGRATION_TIME 5  // ms
+#define DAEMON_PERIOD 2     // ms
+
+static const optical_band_s_t bands[] = {
+    // red, wrapping through 0
+    {.hue_min = 340, .hue_max = 20, .saturation_min = 0.4, .proximity_min = 100, .proximity_max = 255},
+    // blue
+    {.hue_min = 200, .hue_max = 240, .saturation_min = 0.4, .proximity_min = 100, .proximity_max = 255},
+};
+
+// A synthetic ring passing the sensor: present from arrival for duration ms
+typedef struct {
+	uint32_t arrival;
+	uint32_t duration;
+	double hue;
+	uint8_t band;
+} trace_ring_t;
+
+static const trace_ring_t trace[] = {
+    {.arrival = 13, .duration = 40, .hue = 5, .band = 0},
+    {.arrival = 101, .duration = 25, .hue = 220, .band = 1},
+    {.arrival = 160, .duration = 30, .hue = 350, .band = 0},
+    {.arrival = 237, .duration = 12, .hue = 210, .band = 1},
+};
+
+#define TRACE_LENGTH (sizeof(trace) / sizeof(trace[0]))
+
+static void run_trace(uint32_t phase) {
+	uint32_t worst = 0;
+	uint32_t found = 0;
+	uint8_t current = OPTICAL_BAND_NONE;
+	uint32_t reading_time = 0;
+	double hue = 90, saturation = 0.1;
+	int32_t proximity = 20;
+	for (uint32_t now = 0; now < 300; now++) {
+		// the sensor finishes an integration period every INTEGRATION_TIME ms and
+		// reports what it saw at the start of the period
+		if ((now + phase) % INTEGRATION_TIME == 0) {
+			reading_time = now;
+			hue = 90;
+			saturation = 0.1;
+			proximity = 20;
+			for (uint32_t i = 0; i < TRACE_LENGTH; i++) {
+				if (now >= trace[i].arrival + INTEGRATION_TIME &&
+				    now < trace[i].arrival + trace[i].duration + INTEGRATION_TIME) {
+					hue = trace[i].hue;
+					saturation = 0.8;
+					proximity = 200;
+				}
+			}
+		}
+		// the system daemon classifies the latest reading every DAEMON_PERIOD ms
+		if (now % DAEMON_PERIOD != 0) continue;
+		uint8_t band = optical_classify(bands, 2, hue, saturation, proximity);
+		if (band == current) continue;
+		current = band;
+		if (band == OPTICAL_BAND_NONE) continue;
+		for (uint32_t i = 0; i < TRACE_LENGTH; i++) {
+			if (reading_time >= trace[i].arrival && reading_time <= trace[i].arrival + trace[i].duration + INTEGRATION_TIME) {
+				if (band != trace[i].band) {
+					printf("phase %lu: ring %lu misclassified as %u\n", phase, i, band);
+				}
+				uint32_t latency = now - trace[i].arrival;
+				if (latency > worst) worst = latency;
+				found++;
+				break;
+			}
+		}
+	}
+	printf("phase %lu: %lu/%lu rings, worst latency %lu ms\n", phase, found, (uint32_t)TRACE_LENGTH, worst);
+}
+
+void opcontrol() {
+	for (uint32_t phase = 0; phase < INTEGRATION_TIME; phase++) {
+		run_trace(phase);
+	}
+	printf("expected worst latency: %d ms\n", 2 * INTEGRATION_TIME + DAEMON_PERIOD - 2);
+
+	static optical_event_s_t queue[32];
+	optical_event_s_t events[8];
+	optical_set_integration_time(OPTICAL_PORT, INTEGRATION_TIME);
+	optical_set_led_pwm(OPTICAL_PORT, 100);
+	if (optical_classifier_start(OPTICAL_PORT, bands, 2, queue, 32) != 1) {
+		printf("failed to start classifier: %d\n", errno);
+		return;
+	}
+	uint32_t last_timestamp = 0;
+	uint8_t last_band = OPTICAL_BAND_NONE;
+	while (true) {
+		int32_t count = optical_classifier_read(OPTICAL_PORT, events, 8);
+		// a dropped event breaks the chain of bands
+		bool chained = optical_classifier_get_dropped(OPTICAL_PORT) == 0;
+		for (int32_t i = 0; i < count; i++) {
+			printf("%6lu ms: band %3u -> %3u  hue %5.1f prox %3ld\n", events[i].timestamp, events[i].previous,
+			       events[i].band, events[i].hue, events[i].proximity);
+			// timestamps all come from the sensor, so they can be compared with each other
+			if (events[i].timestamp < last_timestamp) {
+				printf("FAIL: event went back in time from %lu ms\n", last_timestamp);
+			}
+			if ((chained && events[i].previous != last_band) || events[i].band == events[i].previous) {
+				printf("FAIL: event does not follow band %u\n", last_band);
+			}
+			last_timestamp = events[i].timestamp;
+			last_band = events[i].band;
+		}
+		if (optical_classifier_get_dropped(OPTICAL_PORT) > 0) {
+			printf("dropped %ld events\n", optical_classifier_get_dropped(OPTICAL_PORT));
+		}
+		delay(1);
+	}
+}
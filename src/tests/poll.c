@@ -0,0 +1,59 @@
+/**
+ * \file tests/poll.c
+ *
+ * Test for poll() across serial input and Generic Serial Device files
+ *
+ * One task services both the terminal and a generic serial loopback with
+ * poll(). Lines typed into the terminal are sent out of port 1, and whatever
+ * arrives on port 2 is printed along with how long it took to arrive.
+ *
+ * NOTE: There should be a cable plugged into ports 1 and 2, connecting
+ * them together
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include <fcntl.h>
+
+#include "main.h"
+#include "pros/apix.h"
+
+void opcontrol() {
+	int out = open("/dev/1", O_WRONLY);
+	int in = open("/dev/2", O_RDONLY | O_NONBLOCK);
+	struct pollfd fds[2] = {{.fd = STDIN_FILENO, .events = POLLIN}, {.fd = in, .events = POLLIN}};
+	uint64_t sent = 0;
+	char line[64];
+	printf("type a line to send it around the loopback\n");
+	while (true) {
+		int ready = poll(fds, 2, 5000);
+		if (ready < 0) {
+			printf("poll failed: %d\n", errno);
+			return;
+		}
+		if (ready == 0) {
+			printf("nothing for 5 seconds\n");
+			continue;
+		}
+		if (fds[0].revents & POLLIN) {
+			int count = read(STDIN_FILENO, line, sizeof(line) - 1);
+			sent = micros();
+			write(out, line, count);
+		}
+		if (fds[1].revents & POLLIN) {
+			int count = read(in, line, sizeof(line) - 1);
+			if (count > 0) {
+				line[count] = '\0';
+				printf("received %d bytes %lu us after sending: %s", count, (uint32_t)(micros() - sent), line);
+			}
+		}
+		if (fds[1].revents & POLLERR) {
+			printf("port 2 is not a generic serial port\n");
+			return;
+		}
+	}
+}
@@ -0,0 +1,75 @@
+/**
+ * \file tests/pose_replay.c
+ *
+ * Record and replay test for the kernel pose estimator
+ *
+ * Runs the pose estimator on live sensors for a few seconds while recording
+ * its inputs, then replays the recording twice and checks that both replays
+ * end at exactly the pose the live run produced. Push the robot around during
+ * the recording to exercise the filter. The recording is also saved to the
+ * microSD card so it can be replayed later.
+ *
+ * Adjust the ports and wheel geometry below to match the robot.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "main.h"
+
+#define MAX_INPUTS 2048
+
+static pose_input_s_t inputs[MAX_INPUTS];
+
+static pose_s_t replay(pose_config_s_t config, uint32_t count) {
+	// without sensor ports the estimator only runs on fed inputs
+	config.imu_port = config.gps_port = config.forward_port = config.lateral_port = 0;
+	pose_estimator_start(&config, 0, 0, 0);
+	for (uint32_t i = 0; i < count; i++) {
+		pose_estimator_feed(&inputs[i]);
+	}
+	return pose_get();
+}
+
+void opcontrol() {
+	pose_config_s_t config = {.imu_port = 1,
+	                          .gps_port = 2,
+	                          .forward_port = 3,
+	                          .lateral_port = 4,
+	                          .wheel_diameter = 0.0699,
+	                          .forward_offset = 0.0,
+	                          .lateral_offset = -0.1,
+	                          .odom_noise = 0.01,
+	                          .heading_noise = 0.01,
+	                          .gps_heading_noise = 2.0,
+	                          .gps_max_error = 0.1};
+	pose_estimator_record(inputs, MAX_INPUTS);
+	pose_estimator_start(&config, 0, 0, 0);
+	for (int i = 0; i < 100; i++) {
+		pose_s_t pose = pose_get();
+		printf("live: %7.3f %7.3f %6.1f  var %.5f %.5f %.3f\n", pose.x, pose.y, pose.heading, pose.covariance[0][0],
+		       pose.covariance[1][1], pose.covariance[2][2]);
+		delay(50);
+	}
+	pose_estimator_stop();
+	pose_s_t live = pose_get();
+	uint32_t count = pose_estimator_record_count();
+	pose_estimator_record(NULL, 0);
+	printf("recorded %lu inputs\n", count);
+
+	FILE* log = fopen("/usd/pose_log.bin", "wb");
+	if (log) {
+		fwrite(inputs, sizeof(pose_input_s_t), count, log);
+		fclose(log);
+	}
+
+	pose_s_t a = replay(config, count);
+	pose_s_t b = replay(config, count);
+	bool same = a.x == b.x && a.y == b.y && a.heading == b.heading;
+	bool matches_live = a.x == live.x && a.y == live.y && a.heading == live.heading;
+	printf("replays %s, %s the live run\n", same ? "match" : "DIFFER", matches_live ? "match" : "DIFFER FROM");
+	printf("live   %f %f %f\nreplay %f %f %f\n", live.x, live.y, live.heading, a.x, a.y, a.heading);
+}
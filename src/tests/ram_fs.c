@@ -0,0 +1,85 @@
+/**
+ * \file tests/ram_fs.c
+ *
+ * Throughput test for RAM files
+ *
+ * Writes and reads back a 256 KB file in 512 byte chunks, once under /ram and
+ * once under /usd, and reports the throughput of each. Then marks the RAM file
+ * to be saved, saves it to the microSD card, and checks the saved copy.
+ *
+ * Requires a microSD card.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include <fcntl.h>
+
+#include "main.h"
+#include "pros/apix.h"
+
+#define FILE_SIZE (256 * 1024)
+#define CHUNK 512
+
+static uint8_t chunk[CHUNK];
+
+static bool check(const uint8_t* buf, uint32_t offset) {
+	for (uint32_t i = 0; i < CHUNK; i++) {
+		if (buf[i] != (uint8_t)((offset + i) * 13)) return false;
+	}
+	return true;
+}
+
+static bool benchmark(const char* path) {
+	uint64_t start = micros();
+	int file = open(path, O_WRONLY | O_CREAT | O_TRUNC);
+	for (uint32_t offset = 0; offset < FILE_SIZE; offset += CHUNK) {
+		for (uint32_t i = 0; i < CHUNK; i++) chunk[i] = (offset + i) * 13;
+		if (write(file, chunk, CHUNK) != CHUNK) {
+			printf("%s: write failed: %d\n", path, errno);
+			return false;
+		}
+	}
+	close(file);
+	uint32_t write_us = micros() - start;
+
+	bool ok = true;
+	start = micros();
+	file = open(path, O_RDONLY);
+	for (uint32_t offset = 0; offset < FILE_SIZE; offset += CHUNK) {
+		if (read(file, chunk, CHUNK) != CHUNK || !check(chunk, offset)) ok = false;
+	}
+	close(file);
+	uint32_t read_us = micros() - start;
+
+	// bytes per millisecond is KB/s
+	printf("%s: write %lu KB/s, read %lu KB/s, data %s\n", path, FILE_SIZE * 1000ul / write_us,
+	       FILE_SIZE * 1000ul / read_us, ok ? "OK" : "BAD");
+	return ok;
+}
+
+void opcontrol() {
+	benchmark("/ram/bench.bin");
+	benchmark("/usd/bench.bin");
+	printf("RAM files use %ld bytes\n", ramctl(RAMCTL_GET_USAGE, NULL));
+
+	int file = open("/ram/bench.bin", O_RDONLY);
+	fdctl(file, RAMCTL_PERSIST, (void*)1);
+	close(file);
+	if (ramctl(RAMCTL_SAVE, NULL) != 0) {
+		printf("save failed: %d\n", errno);
+		return;
+	}
+	bool ok = true;
+	file = open("/usd/bench.bin", O_RDONLY);
+	for (uint32_t offset = 0; offset < FILE_SIZE; offset += CHUNK) {
+		if (read(file, chunk, CHUNK) != CHUNK || !check(chunk, offset)) ok = false;
+	}
+	close(file);
+	printf("saved copy %s\n", ok ? "OK" : "BAD");
+	unlink("/ram/bench.bin");
+	printf("RAM files use %ld bytes after unlink\n", ramctl(RAMCTL_GET_USAGE, NULL));
+}
@@ -0,0 +1,65 @@
+/**
+ * \file tests/rotation_estimator.c
+ *
+ * Benchmark and demo for the rotation velocity estimators
+ *
+ * Times rotation_estimator_step() for each estimator on a synthetic
+ * accelerating trace, which is the work the system daemon does for each new
+ * sample on each port, and reports the error against the true velocity. Then
+ * runs the Savitzky-Golay estimator on a real sensor and prints it next to the
+ * sensor's own velocity. Spin the sensor during the second part.
+ *
+ * Adjust the port below to match the robot.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include <math.h>
+#include "main.h"
+
+#define ROTATION_PORT 1
+#define SAMPLES 10000
+#define SAMPLE_PERIOD 5  // ms
+
+static void bench(const char* name, const rotation_estimator_config_s_t* config) {
+	static rotation_estimator_s_t estimator;
+	rotation_estimator_init(&estimator, config);
+	double worst_error = 0;
+	uint64_t start = micros();
+	for (uint32_t i = 0; i < SAMPLES; i++) {
+		// accelerate at 90 deg/s^2 from 360 deg/s, in centidegrees
+		double t = i * SAMPLE_PERIOD / 1000.0;
+		double velocity = rotation_estimator_step(&estimator, i * SAMPLE_PERIOD, 36000 * t + 4500 * t * t);
+		// ignore the first second while the estimators settle
+		if (t > 1 && fabs(velocity - (36000 + 9000 * t)) > worst_error) {
+			worst_error = fabs(velocity - (36000 + 9000 * t));
+		}
+	}
+	uint64_t elapsed = micros() - start;
+	printf("%-16s %6.2f us/step, worst error %7.1f cdeg/s\n", name, (double)elapsed / SAMPLES, worst_error);
+}
+
+void opcontrol() {
+	rotation_estimator_config_s_t window = {.type = E_ROTATION_ESTIMATOR_WINDOW, .window = 8};
+	rotation_estimator_config_s_t alpha_beta = {.type = E_ROTATION_ESTIMATOR_ALPHA_BETA, .alpha = 0.5, .beta = 0.1};
+	rotation_estimator_config_s_t savitzky_golay = {.type = E_ROTATION_ESTIMATOR_SAVITZKY_GOLAY, .window = 8};
+	bench("window", &window);
+	bench("alpha-beta", &alpha_beta);
+	bench("savitzky-golay", &savitzky_golay);
+
+	rotation_set_data_rate(ROTATION_PORT, SAMPLE_PERIOD);
+	if (rotation_estimator_start(ROTATION_PORT, &savitzky_golay) != 1) {
+		printf("failed to start estimator: %d\n", errno);
+		return;
+	}
+	while (true) {
+		rotation_estimate_s_t estimate = rotation_get_estimate(ROTATION_PORT);
+		printf("%6lu ms: position %8ld  estimate %9.1f  sensor %6ld cdeg/s\n", estimate.timestamp, estimate.position,
+		       estimate.velocity, rotation_get_velocity(ROTATION_PORT));
+		delay(50);
+	}
+}
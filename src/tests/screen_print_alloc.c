@@ -0,0 +1,61 @@
+/**
+ * \file tests/screen_print_alloc.c
+ *
+ * Benchmark for heap usage and time of formatted screen and LLEMU printing
+ *
+ * Prints changing and unchanging text many times and reports how much the heap
+ * grew and how long each print took. Printing should not grow the heap, and
+ * unchanging text should be much cheaper than changing text since it is not
+ * redrawn.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include <malloc.h>
+#include "main.h"
+
+#define ITERATIONS 1000
+
+static void report(const char* name, int heap_before, uint64_t start) {
+	uint64_t elapsed = micros() - start;
+	int heap_delta = mallinfo().uordblks - heap_before;
+	printf("%-24s heap delta: %6d bytes, %5lu us/print\n", name, heap_delta, (uint32_t)(elapsed / ITERATIONS));
+}
+
+void opcontrol() {
+	int heap;
+	uint64_t start;
+
+	heap = mallinfo().uordblks;
+	start = micros();
+	for (int i = 0; i < ITERATIONS; i++) {
+		screen_print(E_TEXT_MEDIUM, 1, "changing %d", i);
+	}
+	report("screen_print changing", heap, start);
+
+	heap = mallinfo().uordblks;
+	start = micros();
+	for (int i = 0; i < ITERATIONS; i++) {
+		screen_print_at(E_TEXT_SMALL, 10, 100, "unchanging %d", 42);
+	}
+	report("screen_print_at same", heap, start);
+
+	lcd_initialize();
+	heap = mallinfo().uordblks;
+	start = micros();
+	for (int i = 0; i < ITERATIONS; i++) {
+		lcd_print(2, "changing %d", i);
+	}
+	report("lcd_print changing", heap, start);
+
+	heap = mallinfo().uordblks;
+	start = micros();
+	for (int i = 0; i < ITERATIONS; i++) {
+		lcd_print(3, "unchanging %d", 42);
+	}
+	report("lcd_print same", heap, start);
+}
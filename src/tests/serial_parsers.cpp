@@ -0,0 +1,162 @@
+/**
+ * \file tests/serial_parsers.cpp
+ *
+ * Throughput benchmark for the serial frame parsers
+ *
+ * Feeds each parser from a loopback stand-in for a generic serial port: a ring
+ * that receives bytes at the rate a 921600 baud link would deliver them to the
+ * system daemon, 184 bytes every 2 ms tick. Every frame is checked against what
+ * was sent, and the time spent inside the parser is reported along with how
+ * many times faster than the link it can run. The last case checks that a line
+ * too long for the ring is skipped rather than stalling the parser.
+ *
+ * No devices are needed.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include <cstring>
+
+#include "common/cobs.h"
+#include "main.h"
+
+#define BAUDRATE 921600
+#define BYTES_PER_TICK (BAUDRATE / 10 / 500)  // 10 bits per byte, 2 ms ticks
+#define RING_SIZE 4096
+#define STREAM_SIZE 65536
+#define PAYLOAD_SIZE 64
+#define COBS_ENCODED_MAX(len) ((len) + ((len) + 253) / 254)
+
+// A receive ring filled from a pregenerated stream instead of a port
+class LoopbackSource : public pros::SerialSource {
+	public:
+	void reset(const std::uint8_t* stream, std::size_t length) {
+		_stream = stream;
+		_length = length;
+		_sent = _head = _tail = 0;
+	}
+
+	// Moves one daemon tick worth of bytes onto the ring
+	bool tick() {
+		std::size_t count = BYTES_PER_TICK;
+		while (count-- > 0 && _sent < _length && (_head + 1) % RING_SIZE != _tail) {
+			_ring[_head] = _stream[_sent++];
+			_head = (_head + 1) % RING_SIZE;
+		}
+		return _sent < _length || _head != _tail;
+	}
+
+	std::int32_t peek(std::size_t offset, std::uint8_t** data) override {
+		std::size_t count = (_head + RING_SIZE - _tail) % RING_SIZE;
+		if (offset >= count) return 0;
+		std::size_t index = (_tail + offset) % RING_SIZE;
+		std::size_t contiguous = count - offset;
+		if (contiguous > RING_SIZE - index) contiguous = RING_SIZE - index;
+		*data = &_ring[index];
+		return contiguous;
+	}
+
+	std::int32_t consume(std::size_t count) override {
+		_tail = (_tail + count) % RING_SIZE;
+		return 1;
+	}
+
+	std::size_t capacity() override {
+		return RING_SIZE - 1;
+	}
+
+	private:
+	std::uint8_t _ring[RING_SIZE];
+	const std::uint8_t* _stream;
+	std::size_t _length, _sent, _head, _tail;
+};
+
+static LoopbackSource source;
+static std::uint8_t stream[STREAM_SIZE];
+static std::uint8_t payload[PAYLOAD_SIZE];
+
+// Fills the payload for frame i, including zeros and delimiter-free text
+static void make_payload(std::uint32_t i, bool text) {
+	for (std::size_t j = 0; j < PAYLOAD_SIZE; j++) {
+		payload[j] = text ? 'a' + (i + j) % 26 : (i * 31 + j * 7) % 256;
+	}
+}
+
+static void run(const char* name, pros::SerialParser& parser, std::size_t length, std::uint32_t frames, bool text,
+                std::size_t offset) {
+	source.reset(stream, length);
+	pros::SerialFrame frame;
+	std::uint32_t received = 0, bad = 0, ticks = 0;
+	std::uint64_t parse_time = 0;
+	while (source.tick()) {
+		ticks++;
+		std::uint64_t start = pros::micros();
+		while (parser.next(frame) == 1) {
+			make_payload(received, text);
+			if (frame.size != PAYLOAD_SIZE + offset || std::memcmp(frame.data + offset, payload, PAYLOAD_SIZE)) bad++;
+			received++;
+		}
+		parse_time += pros::micros() - start;
+	}
+	double seconds = parse_time / 1e6;
+	double rate = length / (seconds > 0 ? seconds : 1e-6);
+	printf("%-15s %5lu/%5lu frames, %lu bad, %lu errors, link time %5lu ms, parse time %6lu us, %8.0f B/s (%.0fx "
+	       "link)\n",
+	       name, received, frames, bad, parser.get_errors(), ticks * 2, (std::uint32_t)parse_time, rate,
+	       rate / (BAUDRATE / 10));
+}
+
+void opcontrol() {
+	// newline delimited text
+	std::size_t length = 0;
+	std::uint32_t frames = 0;
+	while (length + PAYLOAD_SIZE + 1 <= STREAM_SIZE) {
+		make_payload(frames++, true);
+		std::memcpy(&stream[length], payload, PAYLOAD_SIZE);
+		length += PAYLOAD_SIZE;
+		stream[length++] = '\n';
+	}
+	pros::SerialDelimitedParser lines(source, 128);
+	run("delimited", lines, length, frames, true, 0);
+
+	// COBS, decoded by the parser. cobs_encode() adds a 4 byte stream prefix.
+	length = frames = 0;
+	while (length + COBS_ENCODED_MAX(PAYLOAD_SIZE + 4) + 1 <= STREAM_SIZE) {
+		make_payload(frames++, false);
+		length += cobs_encode(&stream[length], payload, PAYLOAD_SIZE, 0x53524550);
+		stream[length++] = 0;
+	}
+	pros::SerialCobsParser cobs(source, 128);
+	run("cobs", cobs, length, frames, false, 4);
+
+	// 2 byte length prefix
+	length = frames = 0;
+	while (length + PAYLOAD_SIZE + 2 <= STREAM_SIZE) {
+		make_payload(frames++, false);
+		stream[length++] = PAYLOAD_SIZE & 0xff;
+		stream[length++] = PAYLOAD_SIZE >> 8;
+		std::memcpy(&stream[length], payload, PAYLOAD_SIZE);
+		length += PAYLOAD_SIZE;
+	}
+	pros::SerialLengthPrefixedParser prefixed(source, 128);
+	run("length prefixed", prefixed, length, frames, false, 0);
+
+	// a line longer than the ring with a max_frame that would allow it, which
+	// should be skipped as 1 error instead of stalling the parser
+	frames = 0;
+	length = RING_SIZE + 100;
+	std::memset(stream, 'x', length);
+	stream[length++] = '\n';
+	while (length + PAYLOAD_SIZE + 1 <= STREAM_SIZE) {
+		make_payload(frames++, true);
+		std::memcpy(&stream[length], payload, PAYLOAD_SIZE);
+		length += PAYLOAD_SIZE;
+		stream[length++] = '\n';
+	}
+	pros::SerialDelimitedParser oversized(source, 2 * RING_SIZE);
+	run("oversized", oversized, length, frames, true, 0);
+}
@@ -0,0 +1,54 @@
+/**
+ * \file tests/shell.c
+ *
+ * Test for the serial command shell
+ *
+ * Exposes PID gains as tunables and adds an echo command. From the terminal,
+ * try:
+ *   pR$help
+ *   pR$set kp 0.42
+ *   pR$echo "two words" three
+ *   pR$tasks
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "main.h"
+#include "pros/apix.h"
+
+static double kp = 1.0;
+static double ki = 0.0;
+static double kd = 0.1;
+
+static int echo(int argc, char** argv) {
+	for (int i = 1; i < argc; i++) {
+		printf("[%s]", argv[i]);
+	}
+	printf("\n");
+	return 0;
+}
+
+void initialize() {
+	shell_tunable("kp", &kp);
+	shell_tunable("ki", &ki);
+	shell_tunable("kd", &kd);
+	shell_register("echo", "prints each argument in brackets", echo);
+	if (shell_register("echo", NULL, echo) == PROS_ERR && errno == EEXIST) {
+		printf("duplicate command rejected\n");
+	}
+}
+
+void opcontrol() {
+	double last = kp + ki + kd;
+	while (true) {
+		if (kp + ki + kd != last) {
+			last = kp + ki + kd;
+			printf("gains are now %g %g %g\n", kp, ki, kd);
+		}
+		delay(100);
+	}
+}
@@ -0,0 +1,43 @@
+/**
+ * \file tests/usd_bench.c
+ *
+ * Test for the microSD card benchmark
+ *
+ * Runs the benchmark on /ram first as a baseline for the file system alone,
+ * then on the card with the block sizes the loggers use.
+ *
+ * NOTE: There should be a microSD card inserted
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "main.h"
+#include "pros/apix.h"
+
+void opcontrol() {
+	if (usd_benchmark("/ram", 256 * 1024, NULL, 0) != 1) {
+		printf("/ram benchmark failed: %d\n", errno);
+	}
+
+	usd_bench_result_s_t results[] = {{.block_size = 64}, {.block_size = 512}, {.block_size = 4096}};
+	if (usd_benchmark("/usd", 1024 * 1024, results, 3) != 1) {
+		printf("/usd benchmark failed: %d\n", errno);
+		return;
+	}
+	// pick the smallest block size that gets within 10% of the best throughput
+	uint32_t best = 0;
+	for (int i = 0; i < 3; i++) {
+		if (results[i].write.bytes_per_sec > best) best = results[i].write.bytes_per_sec;
+	}
+	for (int i = 0; i < 3; i++) {
+		if (results[i].write.bytes_per_sec >= best / 10 * 9) {
+			printf("suggested log buffer: %lu bytes (worst write %lu us)\n", results[i].block_size,
+			       results[i].write.max_us);
+			break;
+		}
+	}
+}
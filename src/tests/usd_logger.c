@@ -0,0 +1,71 @@
+/**
+ * \file tests/usd_logger.c
+ *
+ * Stall test for write-behind microSD logging
+ *
+ * Logs the same lines at 100 Hz to two files, one written directly and one in
+ * write-behind logging mode, and reports the worst time fprintf and fflush
+ * blocked the logging task for each. Then reads the logged file back and checks
+ * that every line arrived in order.
+ *
+ * Requires a microSD card.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "main.h"
+#include "pros/apix.h"
+
+#define LINES 1000
+
+static uint32_t log_lines(FILE* file) {
+	uint32_t worst = 0;
+	uint32_t time = millis();
+	for (int i = 0; i < LINES; i++) {
+		uint64_t start = micros();
+		fprintf(file, "%d,%lu,%d\n", i, millis(), i * 7);
+		fflush(file);
+		uint32_t duration = micros() - start;
+		if (duration > worst) worst = duration;
+		task_delay_until(&time, 10);
+	}
+	return worst;
+}
+
+void opcontrol() {
+	FILE* direct = fopen("/usd/direct.csv", "w");
+	FILE* logged = fopen("/usd/logged.csv", "w");
+	if (direct == NULL || logged == NULL) {
+		printf("could not open files: %d\n", errno);
+		return;
+	}
+	if (fdctl(fileno(logged), USDCTL_WRITE_BEHIND, (void*)32768) != 0) {
+		printf("could not start logging: %d\n", errno);
+		return;
+	}
+
+	printf("direct:       worst %lu us\n", log_lines(direct));
+	printf("write-behind: worst %lu us\n", log_lines(logged));
+
+	fsync(fileno(logged));
+	usd_log_stats_s_t stats;
+	fdctl(fileno(logged), USDCTL_GET_LOG_STATS, &stats);
+	printf("written %lu, dropped %lu, high water %lu, %lu flushes, longest flush %lu us\n", stats.bytes_written,
+	       stats.bytes_dropped, stats.high_water, stats.flushes, stats.max_flush_us);
+	fclose(direct);
+	fclose(logged);
+
+	logged = fopen("/usd/logged.csv", "r");
+	int line, value, expected = 0;
+	unsigned long time;
+	while (fscanf(logged, "%d,%lu,%d\n", &line, &time, &value) == 3) {
+		if (line != expected || value != line * 7) break;
+		expected++;
+	}
+	fclose(logged);
+	printf("read back %d/%d lines %s\n", expected, LINES, expected == LINES ? "OK" : "FAILED");
+}
@@ -0,0 +1,94 @@
+/**
+ * \file tests/vfs_mount.c
+ *
+ * Test for runtime VFS mounts and the file descriptor table
+ *
+ * Mounts a /zero driver that reads as zeros, then times opening and closing
+ * RAM files and checks how many files can be open at once.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include <fcntl.h>
+#include <string.h>
+
+#include "main.h"
+#include "system/dev/vfs.h"
+
+static ssize_t zero_read_r(struct _reent* r, void* const arg, uint8_t* buffer, const size_t len) {
+	memset(buffer, 0, len);
+	return len;
+}
+
+static int zero_write_r(struct _reent* r, void* const arg, const uint8_t* buf, const size_t len) {
+	return len;
+}
+
+static int zero_close_r(struct _reent* r, void* const arg) {
+	return 0;
+}
+
+static int zero_fstat_r(struct _reent* r, void* const arg, struct stat* st) {
+	st->st_mode = S_IFCHR;
+	return 0;
+}
+
+static int zero_isatty_r(struct _reent* r, void* const arg) {
+	return 0;
+}
+
+static off_t zero_lseek_r(struct _reent* r, void* const arg, off_t ptr, int dir) {
+	return 0;
+}
+
+static int zero_ctl(void* const arg, const uint32_t cmd, void* const extra_arg) {
+	return 0;
+}
+
+static const struct fs_driver zero_driver = {.read_r = zero_read_r,
+                                             .write_r = zero_write_r,
+                                             .close_r = zero_close_r,
+                                             .fstat_r = zero_fstat_r,
+                                             .isatty_r = zero_isatty_r,
+                                             .lseek_r = zero_lseek_r,
+                                             .ctl = zero_ctl};
+
+static int zero_open_r(struct _reent* r, const char* path, int flags, int mode) {
+	return vfs_add_entry_r(r, &zero_driver, NULL);
+}
+
+static const struct fs_mount zero_mount = {.name = "zero", .open_r = zero_open_r};
+
+void opcontrol() {
+	if (vfs_mount(&zero_mount) != 0) printf("mount failed: %d\n", errno);
+	if (vfs_mount(&zero_mount) == 0 || errno != EEXIST) printf("mounted twice\n");
+
+	uint8_t buf[16] = {1};
+	int fd = open("/zero", O_RDONLY);
+	if (fd < 0 || read(fd, buf, sizeof(buf)) != sizeof(buf) || buf[0] != 0) printf("/zero read failed\n");
+	close(fd);
+
+	// short-lived files, like a log being rotated
+	uint64_t start = micros();
+	for (int i = 0; i < 1000; i++) {
+		fd = open("/ram/tmp", O_WRONLY);
+		write(fd, "x", 1);
+		close(fd);
+	}
+	printf("1000 open/write/close: %llu us\n", micros() - start);
+	unlink("/ram/tmp");
+
+	int fds[128];
+	int count = 0;
+	while (count < 128 && (fds[count] = open("/zero", O_RDONLY)) >= 0) count++;
+	printf("%d files open at once (errno %d)\n", count, errno);
+	while (count > 0) close(fds[--count]);
+
+	vfs_unmount("zero");
+	if (open("/zero", O_RDONLY) >= 0 || errno != ENOENT) printf("/zero still mounted\n");
+	printf("done\n");
+}
@@ -0,0 +1,102 @@
+/**
+ * \file host.c
+ *
+ * Host stand-ins for the kernel and VEX SDK functions used by src/display
+ *
+ * The display daemon runs in its own thread just as it runs in its own task on
+ * the brain, so display.c and the LVGL test built against this behave as they
+ * do on the robot, minus the screen. Nothing is ever drawn with
+ * vexDisplayCopyRect(); tests capture LVGL's output with display_capture_set().
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <string.h>
+#include <time.h>
+
+#include "kapi.h"
+#include "main.h"
+#include "system/screen.h"
+
+static uint64_t host_start_us;
+
+static uint64_t host_now_us(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+uint32_t millis(void) {
+	return (host_now_us() - host_start_us) / 1000;
+}
+
+uint64_t micros(void) {
+	return host_now_us() - host_start_us;
+}
+
+void task_delay(const uint32_t milliseconds) {
+	struct timespec ts = {.tv_sec = milliseconds / 1000, .tv_nsec = (milliseconds % 1000) * 1000000L};
+	nanosleep(&ts, NULL);
+}
+
+void delay(const uint32_t milliseconds) {
+	task_delay(milliseconds);
+}
+
+void task_delay_until(uint32_t* const prev_time, const uint32_t delta) {
+	*prev_time += delta;
+	int32_t remaining = *prev_time - millis();
+	if (remaining > 0) task_delay(remaining);
+}
+
+static void* host_task_entry(void* arg) {
+	static_task_s_t* task = arg;
+	task->fn(task->param);
+	return NULL;
+}
+
+task_t task_create_static(task_fn_t task_code, void* const param, uint32_t priority, const size_t stack_size,
+                          const char* const name, task_stack_t* const stack_buffer,
+                          static_task_s_t* const task_buffer) {
+	task_buffer->fn = task_code;
+	task_buffer->param = param;
+	if (pthread_create(&task_buffer->thread, NULL, host_task_entry, task_buffer) != 0) return NULL;
+	pthread_detach(task_buffer->thread);
+	return task_buffer;
+}
+
+mutex_t mutex_create_static(static_sem_s_t* mutex_buffer) {
+	pthread_mutex_init(&mutex_buffer->mutex, NULL);
+	return &mutex_buffer->mutex;
+}
+
+// only ever called with TIMEOUT_MAX by src/display
+bool mutex_take(mutex_t mutex, uint32_t timeout) {
+	return pthread_mutex_lock(mutex) == 0;
+}
+
+bool mutex_give(mutex_t mutex) {
+	return pthread_mutex_unlock(mutex) == 0;
+}
+
+void screen_text_cache_invalidate(void) {}
+
+// the real screen is never touched
+void screen_touch_sample_get(V5_TouchStatus* status) {
+	memset(status, 0, sizeof(*status));
+	status->lastEvent = kTouchEventRelease;
+}
+
+void vexDisplayCopyRect(int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t* pSrc, int32_t srcStride) {}
+
+int main(void) {
+	host_start_us = host_now_us();
+	display_initialize();
+	opcontrol();
+	return 0;
+}
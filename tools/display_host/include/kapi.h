@@ -0,0 +1,45 @@
+/**
+ * \file kapi.h
+ *
+ * Host stand-in for the kernel API
+ *
+ * Only declares what src/display needs to build on a desktop. Tasks are
+ * threads and mutexes are pthread mutexes, implemented in host.c.
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "api.h"
+#include "pros/apix.h"
+
+#define kmalloc malloc
+#define kfree free
+
+typedef uint32_t task_stack_t;
+
+typedef struct {
+	pthread_t thread;
+	task_fn_t fn;
+	void* param;
+} static_task_s_t;
+
+typedef struct {
+	pthread_mutex_t mutex;
+} static_sem_s_t;
+
+task_t task_create_static(task_fn_t task_code, void* const param, uint32_t priority, const size_t stack_size,
+                          const char* const name, task_stack_t* const stack_buffer, static_task_s_t* const task_buffer);
+
+mutex_t mutex_create_static(static_sem_s_t* mutex_buffer);
+
+void display_initialize(void);
@@ -0,0 +1,28 @@
+/**
+ * \file v5_api.h
+ *
+ * Host stand-in for the parts of the VEX SDK used by src/display
+ *
+ * \copyright Copyright (c) 2017-2023, Purdue University ACM SIGBots.
+ * All rights reserved.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+typedef enum _touchEvent { kTouchEventRelease, kTouchEventPress, kTouchEventPressAuto } V5_TouchEvent;
+
+typedef struct _V5_TouchStatus {
+	V5_TouchEvent lastEvent;
+	int16_t lastXpos;
+	int16_t lastYpos;
+	int32_t pressCount;
+	int32_t releaseCount;
+} V5_TouchStatus;
+
+void vexDisplayCopyRect(int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t* pSrc, int32_t srcStride);
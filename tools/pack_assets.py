@@ -0,0 +1,144 @@
+#!/usr/bin/env python3
+"""Packs files into an asset pack for pros/assets.h.
+
+Each input is FILE, NAME=FILE, or a directory, whose files are added with
+their paths relative to it as names. By default files are stored as they are.
+With --csv f32 or --csv f64, numeric .csv files are converted to a row-major
+array of little endian floats or doubles, so a path or lookup table can be used
+on the robot without parsing it. A first row that is not numeric is treated as
+a header and skipped.
+
+Example:
+    python3 tools/pack_assets.py -o assets.pak --csv f64 paths/ lut=tables/shooter.csv
+
+See src/system/assets.c for the layout of the pack.
+"""
+from __future__ import print_function
+import argparse
+import csv
+import io
+import os
+import struct
+import sys
+
+MAGIC = 0x4b415041  # "APAK"
+VERSION = 1
+ALIGN = 8
+HEADER = struct.Struct('<IHHIIIIII')
+ENTRY = struct.Struct('<IIII')
+
+
+def fnv1a(name):
+    h = 2166136261
+    for b in bytearray(name):
+        h = ((h ^ b) * 16777619) & 0xffffffff
+    return h
+
+
+def align(n):
+    return (n + ALIGN - 1) & ~(ALIGN - 1)
+
+
+def convert_csv(path, fmt):
+    values = []
+    with io.open(path, newline='') as f:
+        for i, row in enumerate(csv.reader(f)):
+            row = [cell.strip() for cell in row if cell.strip()]
+            if not row:
+                continue
+            try:
+                values.extend(float(cell) for cell in row)
+            except ValueError:
+                if i == 0:
+                    continue  # header
+                raise ValueError('{}: row {} is not numeric'.format(path, i + 1))
+    return struct.pack('<{}{}'.format(len(values), 'f' if fmt == 'f32' else 'd'), *values)
+
+
+def collect(inputs):
+    assets = {}
+    for arg in inputs:
+        if '=' in arg:
+            name, path = arg.split('=', 1)
+            sources = [(name, path)]
+        elif os.path.isdir(arg):
+            sources = []
+            for root, _, files in os.walk(arg):
+                for file in files:
+                    path = os.path.join(root, file)
+                    sources.append((os.path.relpath(path, arg).replace(os.sep, '/'), path))
+        else:
+            sources = [(os.path.basename(arg), arg)]
+        for name, path in sources:
+            if name in assets:
+                raise ValueError('duplicate asset name ' + name)
+            assets[name] = path
+    return assets
+
+
+def pack(assets, fmt):
+    names = sorted(assets)
+    encoded = [name.encode('utf-8') for name in names]
+    buckets = 1
+    while buckets < 2 * len(names):
+        buckets *= 2
+
+    # names region, with at least one byte so it is never empty
+    name_offsets = []
+    name_blob = bytearray()
+    for name in encoded:
+        name_offsets.append(len(name_blob))
+        name_blob += name + b'\0'
+    names_offset = HEADER.size + ENTRY.size * len(names) + 4 * buckets
+    data_offset = align(names_offset + len(name_blob) + 1)
+    name_blob += b'\0' * (data_offset - names_offset - len(name_blob))
+
+    data = bytearray()
+    entries = []
+    for i, name in enumerate(names):
+        path = assets[name]
+        if fmt != 'raw' and path.lower().endswith('.csv'):
+            blob = convert_csv(path, fmt)
+        else:
+            with open(path, 'rb') as f:
+                blob = f.read()
+        entries.append((fnv1a(encoded[i]), name_offsets[i], data_offset + len(data), len(blob)))
+        data += blob + b'\0' * (align(len(blob)) - len(blob))
+
+    table = [0] * buckets
+    for i, entry in enumerate(entries):
+        bucket = entry[0] & (buckets - 1)
+        while table[bucket]:
+            bucket = (bucket + 1) & (buckets - 1)
+        table[bucket] = i + 1
+
+    file_size = data_offset + len(data)
+    out = bytearray(HEADER.pack(MAGIC, VERSION, 0, len(names), buckets, names_offset, data_offset, file_size, 0))
+    for entry in entries:
+        out += ENTRY.pack(*entry)
+    out += struct.pack('<{}I'.format(buckets), *table)
+    out += name_blob
+    out += data
+    return bytes(out), len(entries), data_offset
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('-o', '--output', required=True, help='pack file to write')
+    parser.add_argument('--csv', choices=['raw', 'f32', 'f64'], default='raw',
+                        help='how to store .csv files (default: raw)')
+    parser.add_argument('inputs', nargs='+', help='FILE, NAME=FILE, or a directory')
+    args = parser.parse_args()
+    try:
+        out, count, index_size = pack(collect(args.inputs), args.csv)
+    except (IOError, OSError, ValueError) as e:
+        print('error: {}'.format(e), file=sys.stderr)
+        return 1
+    with open(args.output, 'wb') as f:
+        f.write(out)
+    print('Packed {} assets into {} ({} bytes, index {} bytes)'.format(count, args.output, len(out), index_size))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())